@@ -0,0 +1,503 @@
+//===- llvm/Analysis/DataflowFramework.h - Dataflow solvers -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines worklist solvers for dataflow problems over the IR of a
+// function. A client supplies the lattice, the meet and the transfer
+// functions; the solver walks the CFG and iterates to the fixed point.
+//
+//   * BlockGraph numbers the blocks of a function in reverse post-order and
+//     lists the distinct predecessors and successors of each.
+//   * BlockSolver is the classic dense solver: one state per block boundary,
+//     forward or backward. The state is any copyable type with operator==,
+//     usually a BitVector or a MapState.
+//   * GenKillSolver specializes it for bit-vector gen/kill problems.
+//   * SSASolver is the sparse solver for SSA values: one lattice cell per
+//     value in a MapState, revisited along def-use chains, and CFG edges
+//     that only become feasible as cells drop (Wegman and Zadeck).
+//
+// The solvers use the curiously recurring template pattern, like
+// InstVisitor: the client derives from a solver and provides the functions
+// documented on each one. Nothing is static, so any number of solvers can
+// run at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_DATAFLOWFRAMEWORK_H
+#define LLVM_ANALYSIS_DATAFLOWFRAMEWORK_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/CFG.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace llvm {
+namespace dataflow {
+
+enum Direction { Forward, Backward };
+
+/// BlockGraph - The blocks of a function numbered densely in reverse
+/// post-order, blocks unreachable from the entry last, with their distinct
+/// predecessors and successors by number.
+class BlockGraph {
+  std::vector<const BasicBlock*> Blocks;
+  DenseMap<const BasicBlock*, unsigned> IDs;
+  std::vector<SmallVector<unsigned, 2> > Preds, Succs;
+
+public:
+  void build(const Function &F) {
+    clear();
+    ReversePostOrderTraversal<const Function*> RPOT(&F);
+    for (ReversePostOrderTraversal<const Function*>::rpo_iterator
+         I = RPOT.begin(), E = RPOT.end(); I != E; ++I) {
+      IDs[*I] = Blocks.size();
+      Blocks.push_back(*I);
+    }
+    for (Function::const_iterator I = F.begin(), E = F.end(); I != E; ++I)
+      if (!IDs.count(I)) {
+        IDs[I] = Blocks.size();
+        Blocks.push_back(I);
+      }
+
+    Preds.resize(Blocks.size());
+    Succs.resize(Blocks.size());
+    for (unsigned ID = 0, e = Blocks.size(); ID != e; ++ID)
+      for (succ_const_iterator SI = succ_begin(Blocks[ID]),
+           SE = succ_end(Blocks[ID]); SI != SE; ++SI) {
+        unsigned Succ = IDs[*SI];
+        // A switch may list the same successor several times.
+        if (std::find(Succs[ID].begin(), Succs[ID].end(), Succ) !=
+            Succs[ID].end())
+          continue;
+        Succs[ID].push_back(Succ);
+        Preds[Succ].push_back(ID);
+      }
+  }
+
+  void clear() {
+    Blocks.clear();
+    IDs.clear();
+    Preds.clear();
+    Succs.clear();
+  }
+
+  unsigned size() const { return Blocks.size(); }
+
+  const BasicBlock *getBlock(unsigned ID) const { return Blocks[ID]; }
+  unsigned getID(const BasicBlock *BB) const {
+    DenseMap<const BasicBlock*, unsigned>::const_iterator I = IDs.find(BB);
+    assert(I != IDs.end() && "Block not in the function!");
+    return I->second;
+  }
+
+  ArrayRef<unsigned> preds(unsigned ID) const { return Preds[ID]; }
+  ArrayRef<unsigned> succs(unsigned ID) const { return Succs[ID]; }
+};
+
+/// MapState - A map-based state: a lattice cell per key, keys never looked
+/// up are at the top. CellT is default constructed to the top and provides
+///
+///   bool mergeIn(const CellT &Other);   // Meet, true if the cell changed.
+///   bool operator==(const CellT &Other) const;
+template <typename KeyT, typename CellT>
+class MapState {
+  DenseMap<KeyT, CellT> Cells;
+
+public:
+  /// lookup - The cell of K, or null if it is still at the top.
+  CellT *lookup(const KeyT &K) {
+    typename DenseMap<KeyT, CellT>::iterator I = Cells.find(K);
+    return I == Cells.end() ? 0 : &I->second;
+  }
+  const CellT *lookup(const KeyT &K) const {
+    typename DenseMap<KeyT, CellT>::const_iterator I = Cells.find(K);
+    return I == Cells.end() ? 0 : &I->second;
+  }
+
+  CellT &operator[](const KeyT &K) { return Cells[K]; }
+
+  /// meet - Meet every cell with the one of Other. Returns true if a cell
+  /// changed.
+  bool meet(const MapState &Other) {
+    bool Changed = false;
+    for (typename DenseMap<KeyT, CellT>::const_iterator
+         I = Other.Cells.begin(), E = Other.Cells.end(); I != E; ++I)
+      Changed |= Cells[I->first].mergeIn(I->second);
+    return Changed;
+  }
+
+  bool operator==(const MapState &Other) const {
+    if (Cells.size() != Other.Cells.size())
+      return false;
+    for (typename DenseMap<KeyT, CellT>::const_iterator
+         I = Cells.begin(), E = Cells.end(); I != E; ++I) {
+      const CellT *C = Other.lookup(I->first);
+      if (!C || !(*C == I->second))
+        return false;
+    }
+    return true;
+  }
+  bool operator!=(const MapState &Other) const { return !(*this == Other); }
+
+  void clear() { Cells.clear(); }
+};
+
+/// BlockSolver - Iterates a dense problem to the fixed point. Every block
+/// has a state at its entry and exit; In and Out are in CFG terms whatever
+/// the direction, a backward problem computes In from Out. DerivedT
+/// provides
+///
+///   void initState(StateT &S);          // The top of the lattice.
+///   void initBoundary(StateT &S);       // Entering a forward problem at the
+///                                       // entry, a backward one at an exit.
+///   void meet(StateT &Into, const StateT &Val);
+///   void transfer(unsigned ID, const StateT &Entry, StateT &Exit);
+///
+/// and may override transferEdge. A block is revisited only when the state
+/// flowing into it changed.
+template <typename DerivedT, typename StateT, Direction Dir>
+class BlockSolver {
+  BlockGraph Graph;
+  std::vector<StateT> In, Out;
+  unsigned NumIterations;
+
+  DerivedT &derived() { return *static_cast<DerivedT*>(this); }
+
+public:
+  BlockSolver() : NumIterations(0) {}
+
+  const BlockGraph &getGraph() const { return Graph; }
+  unsigned getNumBlocks() const { return Graph.size(); }
+  unsigned getBlockID(const BasicBlock *BB) const { return Graph.getID(BB); }
+  const BasicBlock *getBlock(unsigned ID) const { return Graph.getBlock(ID); }
+
+  const StateT &getIn(unsigned ID) const { return In[ID]; }
+  const StateT &getOut(unsigned ID) const { return Out[ID]; }
+  const StateT &getIn(const BasicBlock *BB) const {
+    return In[Graph.getID(BB)];
+  }
+  const StateT &getOut(const BasicBlock *BB) const {
+    return Out[Graph.getID(BB)];
+  }
+
+  /// getNumIterations - Blocks evaluated by the last solve().
+  unsigned getNumIterations() const { return NumIterations; }
+
+protected:
+  /// initialize - Number the blocks of F and put every state at the top.
+  void initialize(const Function &F) {
+    releaseState();
+    Graph.build(F);
+    In.resize(Graph.size());
+    Out.resize(Graph.size());
+    for (unsigned ID = 0, e = Graph.size(); ID != e; ++ID) {
+      derived().initState(In[ID]);
+      derived().initState(Out[ID]);
+    }
+  }
+
+  /// releaseState - Free all states, the solver can be initialized again.
+  void releaseState() {
+    Graph.clear();
+    In.clear();
+    Out.clear();
+    NumIterations = 0;
+  }
+
+  /// transferEdge - Val flows along the CFG edge From -> To: it is Out of
+  /// From for a forward problem and In of To for a backward one. Clients
+  /// with edge specific facts, such as PHI operands, adjust it here, and
+  /// return false for an edge that is not feasible.
+  bool transferEdge(const BasicBlock *From, const BasicBlock *To,
+                    StateT &Val) {
+    return true;
+  }
+
+  void solve() {
+    unsigned NumBlocks = Graph.size();
+    NumIterations = 0;
+
+    // Seed the worklist so that a forward problem sees its blocks in
+    // reverse post-order and a backward one in post-order, which settles
+    // acyclic regions in a single visit.
+    std::deque<unsigned> Worklist;
+    BitVector OnWorklist(NumBlocks, true);
+    for (unsigned i = 0; i != NumBlocks; ++i)
+      Worklist.push_back(Dir == Forward ? i : NumBlocks - 1 - i);
+
+    StateT Val;
+    while (!Worklist.empty()) {
+      unsigned ID = Worklist.front();
+      Worklist.pop_front();
+      OnWorklist.reset(ID);
+      ++NumIterations;
+
+      StateT &Entry = Dir == Forward ? In[ID] : Out[ID];
+      StateT &Exit = Dir == Forward ? Out[ID] : In[ID];
+      meetInto(ID, Entry);
+      derived().transfer(ID, Entry, Val);
+      if (Val == Exit)
+        continue;
+      Exit = Val;
+
+      ArrayRef<unsigned> Next = Dir == Forward ? Graph.succs(ID)
+                                               : Graph.preds(ID);
+      for (unsigned i = 0, e = Next.size(); i != e; ++i)
+        if (!OnWorklist.test(Next[i])) {
+          OnWorklist.set(Next[i]);
+          Worklist.push_back(Next[i]);
+        }
+    }
+  }
+
+private:
+  /// meetInto - The state flowing into block ID from its neighbours.
+  void meetInto(unsigned ID, StateT &Val) {
+    ArrayRef<unsigned> Prev = Dir == Forward ? Graph.preds(ID)
+                                             : Graph.succs(ID);
+    if (Prev.empty())
+      return derived().initBoundary(Val);
+
+    StateT Tmp;
+    bool First = true;
+    for (unsigned i = 0, e = Prev.size(); i != e; ++i) {
+      Tmp = Dir == Forward ? Out[Prev[i]] : In[Prev[i]];
+      const BasicBlock *From = Graph.getBlock(Dir == Forward ? Prev[i] : ID);
+      const BasicBlock *To = Graph.getBlock(Dir == Forward ? ID : Prev[i]);
+      if (!derived().transferEdge(From, To, Tmp))
+        continue;
+      if (First)
+        Val = Tmp;
+      else
+        derived().meet(Val, Tmp);
+      First = false;
+    }
+    // Not reachable yet.
+    if (First)
+      derived().initState(Val);
+  }
+};
+
+enum MeetOp { Union, Intersection };
+
+/// GenKillSolver - A BlockSolver for bit-vector problems whose transfer
+/// function is Exit = Gen | (Entry & ~Kill). The client numbers its facts
+/// (variables, expressions, definitions...), calls initialize(), fills in
+/// Gen and Kill, then solve().
+template <typename DerivedT, Direction Dir, MeetOp Meet>
+class GenKillSolver : public BlockSolver<DerivedT, BitVector, Dir> {
+  typedef BlockSolver<DerivedT, BitVector, Dir> SolverT;
+  friend class BlockSolver<DerivedT, BitVector, Dir>;
+
+  unsigned NumBits;
+  std::vector<BitVector> Gen, Kill;
+
+public:
+  GenKillSolver() : NumBits(0) {}
+
+  unsigned getNumBits() const { return NumBits; }
+
+  BitVector &getGen(unsigned ID) { return Gen[ID]; }
+  BitVector &getKill(unsigned ID) { return Kill[ID]; }
+  const BitVector &getGen(unsigned ID) const { return Gen[ID]; }
+  const BitVector &getKill(unsigned ID) const { return Kill[ID]; }
+
+protected:
+  /// initialize - Number the blocks of F and give every block empty Gen
+  /// and Kill sets of Bits bits.
+  void initialize(const Function &F, unsigned Bits) {
+    NumBits = Bits;
+    SolverT::initialize(F);
+    Gen.assign(this->getNumBlocks(), BitVector(NumBits));
+    Kill.assign(this->getNumBlocks(), BitVector(NumBits));
+  }
+
+  void releaseState() {
+    SolverT::releaseState();
+    Gen.clear();
+    Kill.clear();
+  }
+
+  /// Everything starts empty for a union, full for an intersection. The
+  /// boundary only ever sees the empty set.
+  void initState(BitVector &S) {
+    S.clear();
+    S.resize(NumBits, Meet == Intersection);
+  }
+  void initBoundary(BitVector &S) {
+    S.clear();
+    S.resize(NumBits);
+  }
+
+  void meet(BitVector &Into, const BitVector &Val) {
+    if (Meet == Union)
+      Into |= Val;
+    else
+      Into &= Val;
+  }
+
+  void transfer(unsigned ID, const BitVector &Entry, BitVector &Exit) {
+    Exit = Entry;
+    Exit.reset(Kill[ID]);
+    Exit |= Gen[ID];
+  }
+};
+
+/// SSASolver - Sparse propagation over SSA values. Every value has a
+/// lattice cell; blocks become executable with their first feasible
+/// incoming edge, and only the users of a value whose cell changed are
+/// revisited. CellT is default constructed to the top and provides
+///
+///   bool mergeIn(const CellT &Other);   // Meet, true if the cell changed.
+///   bool isOverdefined() const;         // At the bottom.
+///
+/// PHIs are the meet of their incoming values on feasible edges. For every
+/// other instruction of an executable block DerivedT provides
+///
+///   CellT getInitialCell(Value *V);     // Constants, arguments, globals...
+///   void transfer(Instruction &I);      // Calls mergeInValue() for I, or
+///                                       // for whatever else I affects.
+///   void getFeasibleSuccessors(TerminatorInst &TI,
+///                              SmallVectorImpl<bool> &Succs);
+template <typename DerivedT, typename CellT>
+class SSASolver {
+  typedef std::pair<BasicBlock*, BasicBlock*> Edge;
+
+  MapState<Value*, CellT> Cells;
+  SmallPtrSet<BasicBlock*, 16> BBExecutable;
+  DenseSet<Edge> KnownFeasibleEdges;
+
+  // Values whose cell changed. Overdefined ones are propagated first, they
+  // settle their users quickest.
+  SmallVector<Value*, 64> OverdefinedWorkList;
+  SmallVector<Value*, 64> ValueWorkList;
+  SmallVector<BasicBlock*, 64> BBWorkList;
+
+  DerivedT &derived() { return *static_cast<DerivedT*>(this); }
+
+public:
+  /// markBlockExecutable - Returns true if BB was not executable yet.
+  bool markBlockExecutable(BasicBlock *BB) {
+    if (!BBExecutable.insert(BB))
+      return false;
+    BBWorkList.push_back(BB);
+    return true;
+  }
+
+  bool isBlockExecutable(BasicBlock *BB) const {
+    return BBExecutable.count(BB);
+  }
+
+  bool isEdgeFeasible(BasicBlock *From, BasicBlock *To) const {
+    return KnownFeasibleEdges.count(Edge(From, To));
+  }
+
+  /// markEdgeFeasible - The edge From -> To is feasible. To is visited in
+  /// full if it just became executable, otherwise only its PHIs have
+  /// something new to merge.
+  void markEdgeFeasible(BasicBlock *From, BasicBlock *To) {
+    if (!KnownFeasibleEdges.insert(Edge(From, To)).second)
+      return;
+    if (markBlockExecutable(To))
+      return;
+    for (BasicBlock::iterator I = To->begin(); isa<PHINode>(I); ++I)
+      mergePHI(*cast<PHINode>(I));
+  }
+
+  /// getCell - The cell of V, from getInitialCell the first time.
+  CellT &getCell(Value *V) {
+    if (CellT *C = Cells.lookup(V))
+      return *C;
+    CellT Init = derived().getInitialCell(V);
+    return Cells[V] = Init;
+  }
+
+  /// setCell - Force the cell of V before solving, e.g. to track an
+  /// argument whose call sites are all known.
+  void setCell(Value *V, const CellT &C) { Cells[V] = C; }
+
+  /// mergeInValue - Meet the cell of V with C, and revisit the users of V
+  /// if it changed. C is a copy, getCell may move the other cells.
+  void mergeInValue(Value *V, CellT C) {
+    CellT &Cell = getCell(V);
+    if (!Cell.mergeIn(C))
+      return;
+    if (Cell.isOverdefined())
+      OverdefinedWorkList.push_back(V);
+    else
+      ValueWorkList.push_back(V);
+  }
+
+  /// markUsersOf - Revisit the users of V that are in executable blocks.
+  void markUsersOf(Value *V) {
+    for (Value::use_iterator UI = V->use_begin(), UE = V->use_end();
+         UI != UE; ++UI)
+      if (Instruction *I = dyn_cast<Instruction>(*UI))
+        if (BBExecutable.count(I->getParent()))
+          evaluate(*I);
+  }
+
+  void solve() {
+    while (!BBWorkList.empty() || !ValueWorkList.empty() ||
+           !OverdefinedWorkList.empty()) {
+      while (!OverdefinedWorkList.empty())
+        markUsersOf(OverdefinedWorkList.pop_back_val());
+
+      while (!ValueWorkList.empty()) {
+        Value *V = ValueWorkList.pop_back_val();
+        // Already propagated from the overdefined list.
+        if (!getCell(V).isOverdefined())
+          markUsersOf(V);
+      }
+
+      while (!BBWorkList.empty()) {
+        BasicBlock *BB = BBWorkList.pop_back_val();
+        for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I)
+          evaluate(*I);
+      }
+    }
+  }
+
+private:
+  void mergePHI(PHINode &PN) {
+    if (getCell(&PN).isOverdefined())
+      return;
+    for (unsigned i = 0, e = PN.getNumIncomingValues(); i != e; ++i)
+      if (isEdgeFeasible(PN.getIncomingBlock(i), PN.getParent()))
+        mergeInValue(&PN, getCell(PN.getIncomingValue(i)));
+  }
+
+  void evaluate(Instruction &I) {
+    if (PHINode *PN = dyn_cast<PHINode>(&I))
+      return mergePHI(*PN);
+    derived().transfer(I);
+
+    TerminatorInst *TI = dyn_cast<TerminatorInst>(&I);
+    if (!TI)
+      return;
+    SmallVector<bool, 16> Succs;
+    derived().getFeasibleSuccessors(*TI, Succs);
+    for (unsigned i = 0, e = Succs.size(); i != e; ++i)
+      if (Succs[i])
+        markEdgeFeasible(TI->getParent(), TI->getSuccessor(i));
+  }
+};
+
+} // end namespace dataflow
+} // end namespace llvm
+
+#endif
@@ -218,6 +218,8 @@ public:
     VK_Mips_CALL_HI16,
     VK_Mips_CALL_LO16,
 
+    VK_LC3b_SDAREL,      // symbol@sdarel, offset from _SDA_BASE_
+
     VK_COFF_IMGREL32 // symbol@imgrel (image-relative)
   };
 
@@ -2043,6 +2043,20 @@ StringRef ELFObjectFile<ELFT>::getRelocationTypeName(uint32_t Type) const {
     default: break;
     }
     break;
+  case ELF::EM_LC3B:
+    switch (Type) {
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_NONE);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_16);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_PC9);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_PC11);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_8);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_SDA6);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_SDA6W);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_32);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_LC3B_PC32);
+    default: break;
+    }
+    break;
   case ELF::EM_PPC:
     switch (Type) {
       LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_PPC_NONE);
@@ -2296,6 +2310,7 @@ error_code ELFObjectFile<ELFT>::getRelocationValueString(
   case ELF::EM_AARCH64:
   case ELF::EM_ARM:
   case ELF::EM_HEXAGON:
+  case ELF::EM_LC3B:
     res = symname;
     break;
   default:
@@ -2683,6 +2698,8 @@ StringRef ELFObjectFile<ELFT>::getFileFormatName() const {
       return "ELF32-hexagon";
     case ELF::EM_MIPS:
       return "ELF32-mips";
+    case ELF::EM_LC3B:
+      return "ELF32-lc3b";
     default:
       return "ELF32-unknown";
     }
@@ -2727,6 +2744,9 @@ unsigned ELFObjectFile<ELFT>::getArch() const {
     return Triple::ppc64;
   case ELF::EM_S390:
     return Triple::systemz;
+  case ELF::EM_LC3B:
+    return (ELFT::TargetEndianness == support::little) ?
+           Triple::lc3bel : Triple::lc3b;
   default:
     return Triple::UnknownArch;
   }
@@ -288,6 +288,7 @@ enum {
   EM_VIDEOCORE5    = 198, // Broadcom VideoCore V processor
   EM_78KOR         = 199, // Renesas 78KOR family
   EM_56800EX       = 200, // Freescale 56800EX Digital Signal Controller (DSC)
+  EM_LC3B          = 19507, // LC-3b, not assigned by the ELF ABI ('L3')
   EM_MBLAZE        = 47787 // Xilinx MicroBlaze
 };
 
@@ -1012,6 +1013,19 @@ enum {
   R_390_IRELATIVE   = 61
 };
 
+// ELF Relocation types for LC3b
+enum {
+  R_LC3B_NONE       = 0,
+  R_LC3B_16         = 1, // S + A, a 16-bit word
+  R_LC3B_PC9        = 2, // (S + A - P - 2) >> 1 in bits 8-0
+  R_LC3B_PC11       = 3, // (S + A - P - 2) >> 1 in bits 10-0
+  R_LC3B_8          = 4, // S + A, a byte
+  R_LC3B_SDA6       = 5, // S + A - _SDA_BASE_ in bits 5-0
+  R_LC3B_SDA6W      = 6, // (S + A - _SDA_BASE_) >> 1 in bits 5-0
+  R_LC3B_32         = 7, // S + A, a 32-bit word of DWARF data
+  R_LC3B_PC32       = 8  // S + A - P, a 32-bit word of DWARF data
+};
+
 // Section header.
 struct Elf32_Shdr {
   Elf32_Word sh_name;      // Section name (index into string table)
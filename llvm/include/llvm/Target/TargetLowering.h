@@ -753,6 +753,12 @@ public:
     return MinimumJumpTableEntries;
   }
 
+  /// getMinimumJumpTableDensity - return the percentage of the values in a
+  /// case range that must have a case of their own to use a jump table.
+  unsigned getMinimumJumpTableDensity() const {
+    return MinimumJumpTableDensity;
+  }
+
   /// getStackPointerRegisterToSaveRestore - If a physical register, this
   /// specifies the register that llvm.savestack/llvm.restorestack should save
   /// and restore.
@@ -894,6 +900,12 @@ protected:
     MinimumJumpTableEntries = Val;
   }
 
+  /// setMinimumJumpTableDensity - Indicate the percentage of the values in a
+  /// case range that must have a case of their own to use a jump table.
+  void setMinimumJumpTableDensity(unsigned Val) {
+    MinimumJumpTableDensity = Val;
+  }
+
   /// setStackPointerRegisterToSaveRestore - If set to a physical register, this
   /// specifies the register that llvm.savestack/llvm.restorestack should save
   /// and restore.
@@ -1312,6 +1324,10 @@ private:
   /// MinimumJumpTableEntries - Number of blocks threshold to use jump tables.
   int MinimumJumpTableEntries;
 
+  /// MinimumJumpTableDensity - Percentage of the values in a case range that
+  /// must have cases to use a jump table.
+  unsigned MinimumJumpTableDensity;
+
   /// BooleanContents - Information about the contents of the high-bits in
   /// boolean values held in a type wider than i1.  See getBooleanContents.
   BooleanContent BooleanContents;
@@ -2128,12 +2128,13 @@ bool SelectionDAGBuilder::handleJTSwitchCase(CaseRec &CR,
     return false;
 
   APInt Range = ComputeRange(First, Last);
-  // The density is TSize / Range. Require at least 40%.
+  // The density is TSize / Range. Require at least
+  // getMinimumJumpTableDensity() percent, 40% by default.
   // It should not be possible for IntTSize to saturate for sane code, but make
   // sure we handle Range saturation correctly.
-  uint64_t IntRange = Range.getLimitedValue(UINT64_MAX/10);
-  uint64_t IntTSize = TSize.getLimitedValue(UINT64_MAX/10);
-  if (IntTSize * 10 < IntRange * 4)
+  uint64_t IntRange = Range.getLimitedValue(UINT64_MAX/100);
+  uint64_t IntTSize = TSize.getLimitedValue(UINT64_MAX/100);
+  if (IntTSize * 100 < IntRange * TLI.getMinimumJumpTableDensity())
     return false;
 
   DEBUG(dbgs() << "Lowering jump table\n"
@@ -2596,7 +2597,8 @@ void SelectionDAGBuilder::visitSwitch(const SwitchInst &SI) {
     if (handleSmallSwitchRange(CR, WorkList, SV, Default, SwitchMBB))
       continue;
 
-    // If the switch has more than N blocks, and is at least 40% dense, and the
+    // If the switch has more than N blocks, is dense enough (40% by default,
+    // see TLI.getMinimumJumpTableDensity()), and the
     // target supports indirect branches, then emit a jump table rather than
     // lowering the switch to a binary tree of conditional branches.
     // N defaults to 4 and is controlled via TLS.getMinimumJumpTableEntries().
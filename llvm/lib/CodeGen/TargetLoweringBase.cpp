@@ -650,6 +650,7 @@ TargetLoweringBase::TargetLoweringBase(const TargetMachine &tm,
   InsertFencesForAtomic = false;
   SupportJumpTables = true;
   MinimumJumpTableEntries = 4;
+  MinimumJumpTableDensity = 40;
 
   InitLibcallNames(LibcallRoutineNames, TM);
   InitCmpLibcallCCs(CmpLibcallCCs);
@@ -45,6 +45,8 @@ const char *Triple::getArchTypeName(ArchType Kind) {
   case amdil:   return "amdil";
   case spir:    return "spir";
   case spir64:  return "spir64";
+  case lc3b:    return "lc3b";
+  case lc3bel:  return "lc3bel";
   }
 
   llvm_unreachable("Invalid ArchType!");
@@ -90,6 +92,9 @@ const char *Triple::getArchTypePrefix(ArchType Kind) {
   case amdil:   return "amdil";
   case spir:    return "spir";
   case spir64:  return "spir";
+
+  case lc3b:
+  case lc3bel:  return "lc3b";
   }
 }
 
@@ -185,6 +190,8 @@ Triple::ArchType Triple::getArchTypeForLLVMName(StringRef Name) {
     .Case("amdil", amdil)
     .Case("spir", spir)
     .Case("spir64", spir64)
+    .Case("lc3b", lc3b)
+    .Case("lc3bel", lc3bel)
     .Default(UnknownArch);
 }
 
@@ -248,6 +255,8 @@ static Triple::ArchType parseArch(StringRef ArchName) {
     .Case("amdil", Triple::amdil)
     .Case("spir", Triple::spir)
     .Case("spir64", Triple::spir64)
+    .Case("lc3b", Triple::lc3b)
+    .Case("lc3bel", Triple::lc3bel)
     .Default(Triple::UnknownArch);
 }
 
@@ -666,6 +675,8 @@ static unsigned getArchPointerBitWidth(llvm::Triple::ArchType Arch) {
     return 0;
 
   case llvm::Triple::msp430:
+  case llvm::Triple::lc3b:
+  case llvm::Triple::lc3bel:
     return 16;
 
   case llvm::Triple::amdil:
@@ -718,6 +729,8 @@ Triple Triple::get32BitArchVariant() const {
   case Triple::UnknownArch:
   case Triple::aarch64:
   case Triple::msp430:
+  case Triple::lc3b:
+  case Triple::lc3bel:
   case Triple::systemz:
     T.setArch(UnknownArch);
     break;
@@ -762,6 +775,8 @@ Triple Triple::get64BitArchVariant() const {
   case Triple::le32:
   case Triple::mblaze:
   case Triple::msp430:
+  case Triple::lc3b:
+  case Triple::lc3bel:
   case Triple::r600:
   case Triple::tce:
   case Triple::thumb:
@@ -0,0 +1,667 @@
+//===-- LC3bAsmParser.cpp - Parse LC3b assembly to MCInst instructions ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file accepts the syntax LC3bInstPrinter writes as well as the usual
+// LC-3b assembler syntax: case insensitive mnemonics and registers, '#'
+// decimal and 'x' hexadecimal immediates, ';' comments, labels without a
+// colon, NOT, and the .ORIG, .FILL, .BLKW, .STRINGZ and .END directives.
+//
+// As in the printed form, the offset of LDW and STW counts words. The mem
+// operand holds it in bytes, so it is scaled after matching.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MCTargetDesc/LC3bMCTargetDesc.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCParser/MCAsmLexer.h"
+#include "llvm/MC/MCParser/MCParsedAsmOperand.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCSymbol.h"
+#include "llvm/MC/MCTargetAsmParser.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TargetRegistry.h"
+
+using namespace llvm;
+
+namespace {
+class LC3bAsmParser : public MCTargetAsmParser {
+	MCSubtargetInfo &STI;
+	MCAsmParser &Parser;
+
+#define GET_ASSEMBLER_HEADER
+#include "LC3bGenAsmMatcher.inc"
+
+	bool MatchAndEmitInstruction(SMLoc IDLoc, unsigned &Opcode,
+	                             SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+	                             MCStreamer &Out, unsigned &ErrorInfo,
+	                             bool MatchingInlineAsm);
+
+	bool ParseRegister(unsigned &RegNo, SMLoc &StartLoc, SMLoc &EndLoc);
+
+	bool ParseInstruction(ParseInstructionInfo &Info, StringRef Name,
+	                      SMLoc NameLoc,
+	                      SmallVectorImpl<MCParsedAsmOperand*> &Operands);
+
+	bool ParseDirective(AsmToken DirectiveID);
+
+	bool isMnemonic(StringRef Name) {
+		return Name == "not" || mnemonicIsValid(Name);
+	}
+
+	bool parseLabelStatement(ParseInstructionInfo &Info, StringRef Label,
+	                         SMLoc LabelLoc,
+	                         SmallVectorImpl<MCParsedAsmOperand*> &Operands);
+
+	LC3bAsmParser::OperandMatchResultTy
+	parseMemOperand(SmallVectorImpl<MCParsedAsmOperand*> &Operands);
+
+	bool ParseOperand(SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+	                  StringRef Mnemonic);
+
+	int tryParseRegister();
+
+	bool parseImmediate(const MCExpr *&Res);
+
+	bool parseDirectiveOrig();
+	bool parseDirectiveFill();
+	bool parseDirectiveBlkw();
+	bool parseDirectiveStringz();
+
+	bool reportParseError(StringRef ErrorMsg);
+
+public:
+	LC3bAsmParser(MCSubtargetInfo &sti, MCAsmParser &parser)
+		: MCTargetAsmParser(), STI(sti), Parser(parser) {
+		// Initialize the set of available features.
+		setAvailableFeatures(ComputeAvailableFeatures(STI.getFeatureBits()));
+	}
+
+	MCAsmParser &getParser() const { return Parser; }
+	MCAsmLexer &getLexer() const { return Parser.getLexer(); }
+};
+}
+
+namespace {
+
+/// LC3bOperand - Instances of this class represent a parsed LC3b machine
+/// instruction.
+class LC3bOperand : public MCParsedAsmOperand {
+	enum KindTy {
+		k_Immediate,
+		k_Memory,
+		k_Register,
+		k_Token
+	} Kind;
+
+	LC3bOperand(KindTy K) : MCParsedAsmOperand(), Kind(K) {}
+
+	struct Token {
+		const char *Data;
+		unsigned Length;
+	};
+
+	struct RegOp {
+		unsigned RegNum;
+	};
+
+	struct ImmOp {
+		const MCExpr *Val;
+	};
+
+	struct MemOp {
+		unsigned Base;
+		const MCExpr *Off;
+	};
+
+	union {
+		struct Token Tok;
+		struct RegOp Reg;
+		struct ImmOp Imm;
+		struct MemOp Mem;
+	};
+
+	SMLoc StartLoc, EndLoc;
+
+	bool isConstantImm(int64_t &Value) const {
+		if (Kind != k_Immediate)
+			return false;
+		const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Imm.Val);
+		if (!CE)
+			return false;
+		Value = CE->getValue();
+		return true;
+	}
+
+public:
+	void addExpr(MCInst &Inst, const MCExpr *Expr) const {
+		// Add as immediate when possible.
+		if (const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Expr))
+			Inst.addOperand(MCOperand::CreateImm(CE->getValue()));
+		else
+			Inst.addOperand(MCOperand::CreateExpr(Expr));
+	}
+
+	void addRegOperands(MCInst &Inst, unsigned N) const {
+		assert(N == 1 && "Invalid number of operands!");
+		Inst.addOperand(MCOperand::CreateReg(getReg()));
+	}
+
+	void addImmOperands(MCInst &Inst, unsigned N) const {
+		assert(N == 1 && "Invalid number of operands!");
+		addExpr(Inst, getImm());
+	}
+
+	void addUImm4Operands(MCInst &Inst, unsigned N) const {
+		addImmOperands(Inst, N);
+	}
+
+	void addSImm5Operands(MCInst &Inst, unsigned N) const {
+		addImmOperands(Inst, N);
+	}
+
+	void addUImm8Operands(MCInst &Inst, unsigned N) const {
+		addImmOperands(Inst, N);
+	}
+
+	void addMemOperands(MCInst &Inst, unsigned N) const {
+		assert(N == 2 && "Invalid number of operands!");
+		Inst.addOperand(MCOperand::CreateReg(getMemBase()));
+		addExpr(Inst, getMemOff());
+	}
+
+	bool isReg() const { return Kind == k_Register; }
+	bool isImm() const { return Kind == k_Immediate; }
+	bool isToken() const { return Kind == k_Token; }
+	bool isMem() const { return Kind == k_Memory; }
+
+	// Shift amounts, ALU immediates and trap vectors must be constants.
+	bool isUImm4() const {
+		int64_t Value;
+		return isConstantImm(Value) && isUInt<4>(Value);
+	}
+	bool isSImm5() const {
+		int64_t Value;
+		return isConstantImm(Value) && isInt<5>(Value);
+	}
+	bool isUImm8() const {
+		int64_t Value;
+		return isConstantImm(Value) && isUInt<8>(Value);
+	}
+
+	StringRef getToken() const {
+		assert(Kind == k_Token && "Invalid access!");
+		return StringRef(Tok.Data, Tok.Length);
+	}
+
+	unsigned getReg() const {
+		assert((Kind == k_Register) && "Invalid access!");
+		return Reg.RegNum;
+	}
+
+	const MCExpr *getImm() const {
+		assert((Kind == k_Immediate) && "Invalid access!");
+		return Imm.Val;
+	}
+
+	unsigned getMemBase() const {
+		assert((Kind == k_Memory) && "Invalid access!");
+		return Mem.Base;
+	}
+
+	const MCExpr *getMemOff() const {
+		assert((Kind == k_Memory) && "Invalid access!");
+		return Mem.Off;
+	}
+
+	static LC3bOperand *CreateToken(StringRef Str, SMLoc S) {
+		LC3bOperand *Op = new LC3bOperand(k_Token);
+		Op->Tok.Data = Str.data();
+		Op->Tok.Length = Str.size();
+		Op->StartLoc = S;
+		Op->EndLoc = S;
+		return Op;
+	}
+
+	static LC3bOperand *CreateReg(unsigned RegNum, SMLoc S, SMLoc E) {
+		LC3bOperand *Op = new LC3bOperand(k_Register);
+		Op->Reg.RegNum = RegNum;
+		Op->StartLoc = S;
+		Op->EndLoc = E;
+		return Op;
+	}
+
+	static LC3bOperand *CreateImm(const MCExpr *Val, SMLoc S, SMLoc E) {
+		LC3bOperand *Op = new LC3bOperand(k_Immediate);
+		Op->Imm.Val = Val;
+		Op->StartLoc = S;
+		Op->EndLoc = E;
+		return Op;
+	}
+
+	static LC3bOperand *CreateMem(unsigned Base, const MCExpr *Off,
+	                              SMLoc S, SMLoc E) {
+		LC3bOperand *Op = new LC3bOperand(k_Memory);
+		Op->Mem.Base = Base;
+		Op->Mem.Off = Off;
+		Op->StartLoc = S;
+		Op->EndLoc = E;
+		return Op;
+	}
+
+	/// getStartLoc - Get the location of the first token of this operand.
+	SMLoc getStartLoc() const { return StartLoc; }
+	/// getEndLoc - Get the location of the last token of this operand.
+	SMLoc getEndLoc() const { return EndLoc; }
+
+	virtual void print(raw_ostream &OS) const {
+		switch (Kind) {
+		case k_Immediate:
+			OS << "Imm<" << *Imm.Val << ">";
+			break;
+		case k_Memory:
+			OS << "Mem<" << Mem.Base << ", " << *Mem.Off << ">";
+			break;
+		case k_Register:
+			OS << "Reg<" << Reg.RegNum << ">";
+			break;
+		case k_Token:
+			OS << "'" << getToken() << "'";
+			break;
+		}
+	}
+}; // class LC3bOperand
+}  // namespace
+
+bool LC3bAsmParser::
+MatchAndEmitInstruction(SMLoc IDLoc, unsigned &Opcode,
+                        SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+                        MCStreamer &Out, unsigned &ErrorInfo,
+                        bool MatchingInlineAsm) {
+	// A label alone on its line, see parseLabelStatement.
+	if (Operands.empty())
+		return false;
+
+	MCInst Inst;
+	unsigned MatchResult = MatchInstructionImpl(Operands, Inst, ErrorInfo,
+	                                            MatchingInlineAsm);
+
+	switch (MatchResult) {
+	default:
+		break;
+	case Match_Success: {
+		// The mem operand holds a byte offset, LDW/STW count words.
+		// sym@SDAREL is an address and needs no scaling.
+		if (Inst.getOpcode() == LC3b::LDW || Inst.getOpcode() == LC3b::STW) {
+			MCOperand &Off = Inst.getOperand(2);
+			if (Off.isImm())
+				Off.setImm(Off.getImm() * 2);
+		}
+		Inst.setLoc(IDLoc);
+		Out.EmitInstruction(Inst);
+		return false;
+	}
+	case Match_MissingFeature:
+		Error(IDLoc, "instruction requires a CPU feature not currently enabled");
+		return true;
+	case Match_InvalidOperand: {
+		SMLoc ErrorLoc = IDLoc;
+		if (ErrorInfo != ~0U) {
+			if (ErrorInfo >= Operands.size())
+				return Error(IDLoc, "too few operands for instruction");
+
+			ErrorLoc = ((LC3bOperand*) Operands[ErrorInfo])->getStartLoc();
+			if (ErrorLoc == SMLoc())
+				ErrorLoc = IDLoc;
+		}
+
+		return Error(ErrorLoc, "invalid operand for instruction");
+	}
+	case Match_MnemonicFail:
+		return Error(IDLoc, "invalid instruction");
+	}
+	return true;
+}
+
+/// tryParseRegister - Return the LC3b register of the identifier at the
+/// lexer, R0 to R7 in either case, or -1 without consuming anything.
+int LC3bAsmParser::tryParseRegister() {
+	const AsmToken &Tok = Parser.getTok();
+	if (Tok.isNot(AsmToken::Identifier))
+		return -1;
+
+	int RegNum = StringSwitch<int>(Tok.getString().lower())
+		.Case("r0", LC3b::R0)
+		.Case("r1", LC3b::R1)
+		.Case("r2", LC3b::R2)
+		.Case("r3", LC3b::R3)
+		.Case("r4", LC3b::R4)
+		.Case("r5", LC3b::R5)
+		.Case("r6", LC3b::R6)
+		.Case("r7", LC3b::R7)
+		.Default(-1);
+	if (RegNum != -1)
+		Parser.Lex(); // Eat the register.
+	return RegNum;
+}
+
+bool LC3bAsmParser::ParseRegister(unsigned &RegNo, SMLoc &StartLoc,
+                                  SMLoc &EndLoc) {
+	StartLoc = Parser.getTok().getLoc();
+	EndLoc = Parser.getTok().getEndLoc();
+	int Reg = tryParseRegister();
+	if (Reg == -1)
+		return true;
+	RegNo = Reg;
+	return false;
+}
+
+/// parseImmediate - Parse "#<dec>", "x<hex>" or any expression, such as a
+/// label.
+bool LC3bAsmParser::parseImmediate(const MCExpr *&Res) {
+	if (Parser.getTok().is(AsmToken::Hash)) {
+		Parser.Lex(); // Eat '#'.
+		return Parser.parseExpression(Res);
+	}
+
+	// x1F is the LC-3b spelling of 0x1F. A label can not look like that.
+	if (Parser.getTok().is(AsmToken::Identifier)) {
+		StringRef Id = Parser.getTok().getString();
+		uint64_t Value;
+		if (Id.size() > 1 && (Id[0] == 'x' || Id[0] == 'X') &&
+		    !Id.substr(1).getAsInteger(16, Value)) {
+			Parser.Lex(); // Eat the literal.
+			Res = MCConstantExpr::Create(static_cast<int16_t>(Value),
+			                             getContext());
+			return false;
+		}
+	}
+
+	return Parser.parseExpression(Res);
+}
+
+/// isSDARel - Whether Expr is sym@SDAREL, possibly plus or minus a constant.
+static bool isSDARel(const MCExpr *Expr) {
+	if (const MCBinaryExpr *BE = dyn_cast<MCBinaryExpr>(Expr)) {
+		if ((BE->getOpcode() != MCBinaryExpr::Add &&
+		     BE->getOpcode() != MCBinaryExpr::Sub) ||
+		    !isa<MCConstantExpr>(BE->getRHS()))
+			return false;
+		Expr = BE->getLHS();
+	}
+	const MCSymbolRefExpr *SRE = dyn_cast<MCSymbolRefExpr>(Expr);
+	return SRE && SRE->getKind() == MCSymbolRefExpr::VK_LC3b_SDAREL;
+}
+
+/// parseMemOperand - Parse the "Rb, offset" pair of LDB/LDW/STB/STW.
+LC3bAsmParser::OperandMatchResultTy LC3bAsmParser::parseMemOperand(
+	SmallVectorImpl<MCParsedAsmOperand*> &Operands) {
+	SMLoc S = Parser.getTok().getLoc();
+	int Base = tryParseRegister();
+	if (Base == -1)
+		return MatchOperand_NoMatch;
+
+	if (getLexer().isNot(AsmToken::Comma)) {
+		Error(Parser.getTok().getLoc(), "expected ',' after base register");
+		return MatchOperand_ParseFail;
+	}
+	Parser.Lex(); // Eat the comma.
+
+	const MCExpr *Off;
+	SMLoc OffLoc = Parser.getTok().getLoc();
+	if (parseImmediate(Off))
+		return MatchOperand_ParseFail;
+
+	SMLoc E = SMLoc::getFromPointer(Parser.getTok().getLoc().getPointer() - 1);
+
+	// The only offset6 fixup is that of a small data object, sym@SDAREL.
+	if (isSDARel(Off)) {
+		Operands.push_back(LC3bOperand::CreateMem(Base, Off, S, E));
+		return MatchOperand_Success;
+	}
+
+	// Anything else must be known here.
+	int64_t Value;
+	if (!Off->EvaluateAsAbsolute(Value) || !isInt<6>(Value)) {
+		Error(OffLoc, "offset must be a constant in [-32, 31] or sym@SDAREL");
+		return MatchOperand_ParseFail;
+	}
+
+	Operands.push_back(LC3bOperand::CreateMem(
+		Base, MCConstantExpr::Create(Value, getContext()), S, E));
+	return MatchOperand_Success;
+}
+
+bool LC3bAsmParser::ParseOperand(SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+                                 StringRef Mnemonic) {
+	// Check if the current operand has a custom associated parser, if so, try
+	// to custom parse the operand, or fallback to the general approach.
+	OperandMatchResultTy ResTy = MatchOperandParserImpl(Operands, Mnemonic);
+	if (ResTy == MatchOperand_Success)
+		return false;
+	if (ResTy == MatchOperand_ParseFail)
+		return true;
+
+	SMLoc S = Parser.getTok().getLoc();
+	int Reg = tryParseRegister();
+	if (Reg != -1) {
+		SMLoc E = SMLoc::getFromPointer(Parser.getTok().getLoc().getPointer() - 1);
+		Operands.push_back(LC3bOperand::CreateReg(Reg, S, E));
+		return false;
+	}
+
+	const MCExpr *Val;
+	if (parseImmediate(Val))
+		return true;
+
+	SMLoc E = SMLoc::getFromPointer(Parser.getTok().getLoc().getPointer() - 1);
+	Operands.push_back(LC3bOperand::CreateImm(Val, S, E));
+	return false;
+}
+
+/// parseLabelStatement - A statement starting with an identifier that is not
+/// a mnemonic: the LC-3b label without a colon. An instruction, .FILL, .BLKW
+/// or .STRINGZ may follow on the same line.
+bool LC3bAsmParser::
+parseLabelStatement(ParseInstructionInfo &Info, StringRef Label, SMLoc LabelLoc,
+                    SmallVectorImpl<MCParsedAsmOperand*> &Operands) {
+	AsmToken Tok = Parser.getTok();
+	std::string Next = Tok.getString().lower();
+	bool IsDirective = Tok.is(AsmToken::Identifier) &&
+		(Next == ".fill" || Next == ".blkw" || Next == ".stringz");
+	bool IsInstruction = Tok.is(AsmToken::Identifier) && isMnemonic(Next);
+	bool IsEnd = Tok.is(AsmToken::EndOfStatement) || Tok.is(AsmToken::Eof);
+	if (!IsEnd && !IsDirective && !IsInstruction) {
+		Parser.eatToEndOfStatement();
+		return Error(LabelLoc, "invalid instruction");
+	}
+
+	MCSymbol *Sym = getContext().GetOrCreateSymbol(Label);
+	if (!Sym->isUndefined() || Sym->isVariable()) {
+		Parser.eatToEndOfStatement();
+		return Error(LabelLoc, "invalid symbol redefinition");
+	}
+	getParser().getStreamer().EmitLabel(Sym);
+
+	if (IsInstruction) {
+		Parser.Lex(); // Eat the mnemonic.
+		return ParseInstruction(Info, Tok.getString(), Tok.getLoc(), Operands);
+	}
+
+	if (Tok.is(AsmToken::Eof))
+		return false;
+	Parser.Lex(); // Eat the directive or the EndOfStatement.
+	if (IsDirective)
+		return ParseDirective(Tok);
+	return false;
+}
+
+bool LC3bAsmParser::
+ParseInstruction(ParseInstructionInfo &Info, StringRef Name, SMLoc NameLoc,
+                 SmallVectorImpl<MCParsedAsmOperand*> &Operands) {
+	// Name comes lowered, labels are case sensitive: take the spelling from
+	// the source.
+	if (!isMnemonic(Name.lower()))
+		return parseLabelStatement(Info,
+		                           StringRef(NameLoc.getPointer(), Name.size()),
+		                           NameLoc, Operands);
+
+	// Mnemonics are case insensitive, the match table is lower case. The
+	// token must outlive this call, so keep the lowered copy in the context.
+	// NOT Ra, Rb is XOR Ra, Rb, #-1.
+	StringRef Mnemonic = Name;
+	bool IsNot = Name.lower() == "not";
+	if (IsNot) {
+		Mnemonic = "xor";
+	} else if (Name.lower() != Name) {
+		std::string Lower = Name.lower();
+		char *Buf = static_cast<char*>(getContext().Allocate(Lower.size()));
+		memcpy(Buf, Lower.data(), Lower.size());
+		Mnemonic = StringRef(Buf, Lower.size());
+	}
+	Operands.push_back(LC3bOperand::CreateToken(Mnemonic, NameLoc));
+
+	// Read the remaining operands.
+	if (getLexer().isNot(AsmToken::EndOfStatement)) {
+		// Read the first operand.
+		if (ParseOperand(Operands, Mnemonic)) {
+			SMLoc Loc = getLexer().getLoc();
+			Parser.eatToEndOfStatement();
+			return Error(Loc, "unexpected token in argument list");
+		}
+
+		while (getLexer().is(AsmToken::Comma)) {
+			Parser.Lex(); // Eat the comma.
+
+			// Parse and remember the operand.
+			if (ParseOperand(Operands, Mnemonic)) {
+				SMLoc Loc = getLexer().getLoc();
+				Parser.eatToEndOfStatement();
+				return Error(Loc, "unexpected token in argument list");
+			}
+		}
+	}
+
+	if (getLexer().isNot(AsmToken::EndOfStatement)) {
+		SMLoc Loc = getLexer().getLoc();
+		Parser.eatToEndOfStatement();
+		return Error(Loc, "unexpected token in argument list");
+	}
+
+	if (IsNot) {
+		SMLoc Loc = getLexer().getLoc();
+		Operands.push_back(LC3bOperand::CreateImm(
+			MCConstantExpr::Create(-1, getContext()), Loc, Loc));
+	}
+
+	Parser.Lex(); // Consume the EndOfStatement.
+	return false;
+}
+
+bool LC3bAsmParser::reportParseError(StringRef ErrorMsg) {
+	SMLoc Loc = getLexer().getLoc();
+	Parser.eatToEndOfStatement();
+	return Error(Loc, ErrorMsg);
+}
+
+/// parseDirectiveOrig - .ORIG <address>. The address is checked but not
+/// used: code is placed by the linker, as for llc output.
+bool LC3bAsmParser::parseDirectiveOrig() {
+	const MCExpr *Addr;
+	if (parseImmediate(Addr))
+		return true;
+	int64_t Value;
+	if (!Addr->EvaluateAsAbsolute(Value) || (Value & 1))
+		return reportParseError("expected an even constant address");
+	if (getLexer().isNot(AsmToken::EndOfStatement))
+		return reportParseError("unexpected token in directive");
+	Parser.Lex();
+	return false;
+}
+
+/// parseDirectiveFill - .FILL <value>, one word. The value may be a label.
+bool LC3bAsmParser::parseDirectiveFill() {
+	const MCExpr *Value;
+	if (parseImmediate(Value))
+		return true;
+	if (getLexer().isNot(AsmToken::EndOfStatement))
+		return reportParseError("unexpected token in directive");
+	Parser.Lex();
+	getParser().getStreamer().EmitValue(Value, 2);
+	return false;
+}
+
+/// parseDirectiveBlkw - .BLKW <n>, n zero words.
+bool LC3bAsmParser::parseDirectiveBlkw() {
+	const MCExpr *Count;
+	if (parseImmediate(Count))
+		return true;
+	int64_t Value;
+	if (!Count->EvaluateAsAbsolute(Value) || Value < 0)
+		return reportParseError("expected a non-negative constant count");
+	if (getLexer().isNot(AsmToken::EndOfStatement))
+		return reportParseError("unexpected token in directive");
+	Parser.Lex();
+	getParser().getStreamer().EmitFill(2 * Value, 0);
+	return false;
+}
+
+/// parseDirectiveStringz - .STRINGZ "<text>". One byte per character and a
+/// NUL, the layout of a C string, which is what LDB walks.
+bool LC3bAsmParser::parseDirectiveStringz() {
+	if (getLexer().isNot(AsmToken::String))
+		return reportParseError("expected string in directive");
+	std::string Data;
+	if (getParser().parseEscapedString(Data))
+		return true;
+	Parser.Lex();
+	if (getLexer().isNot(AsmToken::EndOfStatement))
+		return reportParseError("unexpected token in directive");
+	Parser.Lex();
+	getParser().getStreamer().EmitBytes(Data);
+	getParser().getStreamer().EmitIntValue(0, 1);
+	return false;
+}
+
+bool LC3bAsmParser::ParseDirective(AsmToken DirectiveID) {
+	// LC-3b directives are case insensitive. They are seen before the generic
+	// ones, so .fill is the one word LC-3b form, not the GNU one.
+	std::string IDVal = DirectiveID.getString().lower();
+	if (IDVal == ".orig")
+		return parseDirectiveOrig();
+
+	if (IDVal == ".fill")
+		return parseDirectiveFill();
+
+	if (IDVal == ".blkw")
+		return parseDirectiveBlkw();
+
+	if (IDVal == ".stringz")
+		return parseDirectiveStringz();
+
+	// .END ends the program, nothing after it is assembled.
+	if (IDVal == ".end") {
+		while (getLexer().isNot(AsmToken::Eof))
+			Parser.Lex();
+		return false;
+	}
+
+	return true;
+}
+
+extern "C" void LLVMInitializeLC3bAsmParser() {
+	RegisterMCAsmParser<LC3bAsmParser> X(TheLC3bTarget);
+	RegisterMCAsmParser<LC3bAsmParser> Y(TheLC3belTarget);
+}
+
+#define GET_MATCHER_IMPLEMENTATION
+#include "LC3bGenAsmMatcher.inc"
@@ -0,0 +1,229 @@
+//===- LC3bDisassembler.cpp - Disassembler for LC3b -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is part of the LC3b Disassembler. The decoder tables are
+// generated from LC3bInstrInfo.td by FixedLenDecoderEmitter; every
+// instruction is one 16-bit word.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LC3b.h"
+#include "llvm/MC/MCDisassembler.h"
+#include "llvm/MC/MCFixedLenDisassembler.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryObject.h"
+#include "llvm/Support/TargetRegistry.h"
+
+using namespace llvm;
+
+typedef MCDisassembler::DecodeStatus DecodeStatus;
+
+namespace {
+
+/// LC3bDisassembler - a disassembler class for LC3b.
+class LC3bDisassembler : public MCDisassembler {
+public:
+	/// Constructor     - Initializes the disassembler.
+	///
+	LC3bDisassembler(const MCSubtargetInfo &STI, const MCRegisterInfo *Info,
+	                 bool bigEndian) :
+		MCDisassembler(STI), RegInfo(Info), isBigEndian(bigEndian) {}
+
+	virtual ~LC3bDisassembler() {}
+
+	const MCRegisterInfo *getRegInfo() const { return RegInfo; }
+
+	/// getInstruction - See MCDisassembler.
+	virtual DecodeStatus getInstruction(MCInst &instr,
+	                                    uint64_t &size,
+	                                    const MemoryObject &region,
+	                                    uint64_t address,
+	                                    raw_ostream &vStream,
+	                                    raw_ostream &cStream) const;
+
+private:
+	const MCRegisterInfo *RegInfo;
+	bool isBigEndian;
+};
+
+} // end anonymous namespace
+
+// Forward declare these because the autogenerated code will reference them.
+// Definitions are further down.
+static DecodeStatus DecodeLC3bRegsRegisterClass(MCInst &Inst,
+                                                unsigned RegNo,
+                                                uint64_t Address,
+                                                const void *Decoder);
+
+static DecodeStatus DecodeSimm4(MCInst &Inst,
+                                unsigned Insn,
+                                uint64_t Address,
+                                const void *Decoder);
+
+static DecodeStatus DecodeSimm5(MCInst &Inst,
+                                unsigned Insn,
+                                uint64_t Address,
+                                const void *Decoder);
+
+static DecodeStatus DecodeMem(MCInst &Inst,
+                              unsigned Insn,
+                              uint64_t Address,
+                              const void *Decoder);
+
+static DecodeStatus DecodeBranchTarget(MCInst &Inst,
+                                       unsigned Offset,
+                                       uint64_t Address,
+                                       const void *Decoder);
+
+static DecodeStatus DecodeJumpTarget(MCInst &Inst,
+                                     unsigned Offset,
+                                     uint64_t Address,
+                                     const void *Decoder);
+
+namespace llvm {
+extern Target TheLC3bTarget, TheLC3belTarget;
+}
+
+static MCDisassembler *createLC3bDisassembler(
+                       const Target &T,
+                       const MCSubtargetInfo &STI) {
+	return new LC3bDisassembler(STI, T.createMCRegInfo(""), true);
+}
+
+static MCDisassembler *createLC3belDisassembler(
+                       const Target &T,
+                       const MCSubtargetInfo &STI) {
+	return new LC3bDisassembler(STI, T.createMCRegInfo(""), false);
+}
+
+extern "C" void LLVMInitializeLC3bDisassembler() {
+	// Register the disassembler.
+	TargetRegistry::RegisterMCDisassembler(TheLC3bTarget,
+	                                       createLC3bDisassembler);
+	TargetRegistry::RegisterMCDisassembler(TheLC3belTarget,
+	                                       createLC3belDisassembler);
+}
+
+
+#include "LC3bGenDisassemblerTables.inc"
+
+/// readInstruction16 - read two bytes from the MemoryObject and return the
+/// instruction word according to the given endianess
+static DecodeStatus readInstruction16(const MemoryObject &region,
+                                      uint64_t address,
+                                      uint64_t &size,
+                                      uint16_t &insn,
+                                      bool isBigEndian) {
+	uint8_t Bytes[2];
+
+	if (region.readBytes(address, 2, Bytes, NULL) == -1) {
+		size = 0;
+		return MCDisassembler::Fail;
+	}
+
+	if (isBigEndian)
+		insn = (Bytes[0] << 8) | Bytes[1];
+	else
+		insn = (Bytes[1] << 8) | Bytes[0];
+
+	return MCDisassembler::Success;
+}
+
+DecodeStatus
+LC3bDisassembler::getInstruction(MCInst &instr,
+                                 uint64_t &Size,
+                                 const MemoryObject &Region,
+                                 uint64_t Address,
+                                 raw_ostream &vStream,
+                                 raw_ostream &cStream) const {
+	uint16_t Insn;
+
+	DecodeStatus Result = readInstruction16(Region, Address, Size,
+	                                        Insn, isBigEndian);
+	if (Result == MCDisassembler::Fail)
+		return MCDisassembler::Fail;
+
+	// Calling the auto-generated decoder function.
+	Result = decodeInstruction(DecoderTableLC3b16, instr, Insn, Address,
+	                           this, STI);
+	Size = 2;
+	return Result;
+}
+
+static DecodeStatus DecodeLC3bRegsRegisterClass(MCInst &Inst,
+                                                unsigned RegNo,
+                                                uint64_t Address,
+                                                const void *Decoder) {
+	if (RegNo > 7)
+		return MCDisassembler::Fail;
+	const LC3bDisassembler *Dis = static_cast<const LC3bDisassembler*>(Decoder);
+	unsigned Reg =
+		*(Dis->getRegInfo()->getRegClass(LC3b::LC3bRegsRegClassID).begin() + RegNo);
+	Inst.addOperand(MCOperand::CreateReg(Reg));
+	return MCDisassembler::Success;
+}
+
+// simm4 is the LSHF/RSHFL/RSHFA amount, which is unsigned.
+static DecodeStatus DecodeSimm4(MCInst &Inst,
+                                unsigned Insn,
+                                uint64_t Address,
+                                const void *Decoder) {
+	Inst.addOperand(MCOperand::CreateImm(Insn & 0xf));
+	return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeSimm5(MCInst &Inst,
+                                unsigned Insn,
+                                uint64_t Address,
+                                const void *Decoder) {
+	Inst.addOperand(MCOperand::CreateImm(SignExtend32<5>(Insn)));
+	return MCDisassembler::Success;
+}
+
+// LDB/LDW/STB/STW: ra, base and the offset in bytes, which is how the mem
+// operand holds it (LDW/STW scale offset6 by two).
+static DecodeStatus DecodeMem(MCInst &Inst,
+                              unsigned Insn,
+                              uint64_t Address,
+                              const void *Decoder) {
+	int Offset = SignExtend32<6>(Insn & 0x3f);
+	unsigned Ra = fieldFromInstruction(Insn, 9, 3);
+	unsigned Base = fieldFromInstruction(Insn, 6, 3);
+	unsigned Opcode = fieldFromInstruction(Insn, 12, 4);
+
+	if (Opcode == 0x6 || Opcode == 0x7)
+		Offset <<= 1;
+
+	DecodeLC3bRegsRegisterClass(Inst, Ra, Address, Decoder);
+	DecodeLC3bRegsRegisterClass(Inst, Base, Address, Decoder);
+	Inst.addOperand(MCOperand::CreateImm(Offset));
+
+	return MCDisassembler::Success;
+}
+
+// PCoffset9 of BR and LEA, in words from the next instruction.
+static DecodeStatus DecodeBranchTarget(MCInst &Inst,
+                                       unsigned Offset,
+                                       uint64_t Address,
+                                       const void *Decoder) {
+	Inst.addOperand(MCOperand::CreateImm(SignExtend32<9>(Offset)));
+	return MCDisassembler::Success;
+}
+
+// PCoffset11 of JSR, in words from the next instruction.
+static DecodeStatus DecodeJumpTarget(MCInst &Inst,
+                                     unsigned Offset,
+                                     uint64_t Address,
+                                     const void *Decoder) {
+	Inst.addOperand(MCOperand::CreateImm(SignExtend32<11>(Offset)));
+	return MCDisassembler::Success;
+}
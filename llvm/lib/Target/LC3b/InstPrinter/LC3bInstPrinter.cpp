@@ -0,0 +1,74 @@
+//===-- LC3bInstPrinter.cpp - Convert LC3b MCInst to assembly syntax ------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This class prints an LC3b MCInst to a .s file, in the syntax the LC3b
+// asm parser reads back: registers R0-R7 and '#' decimal immediates.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "asm-printer"
+#include "LC3bInstPrinter.h"
+#include "MCTargetDesc/LC3bMCTargetDesc.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCSymbol.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+#define PRINT_ALIAS_INSTR
+#include "LC3bGenAsmWriter.inc"
+
+void LC3bInstPrinter::printRegName(raw_ostream &OS, unsigned RegNo) const {
+	OS << getRegisterName(RegNo);
+}
+
+void LC3bInstPrinter::printInst(const MCInst *MI, raw_ostream &O,
+                                StringRef Annot) {
+	// The TRAP vectors of the OS services print as HALT, PUTS, ...
+	if (!printAliasInstr(MI, O))
+		printInstruction(MI, O);
+	printAnnotation(O, Annot);
+}
+
+void LC3bInstPrinter::printOperand(const MCInst *MI, unsigned OpNo,
+                                   raw_ostream &O) {
+	const MCOperand &Op = MI->getOperand(OpNo);
+	if (Op.isReg()) {
+		printRegName(O, Op.getReg());
+		return;
+	}
+	if (Op.isImm()) {
+		O << '#' << Op.getImm();
+		return;
+	}
+	assert(Op.isExpr() && "unknown operand kind in printOperand");
+	// MCExpr puts a label like $BB0_1 in parentheses, branches print it bare.
+	if (const MCSymbolRefExpr *SRE = dyn_cast<MCSymbolRefExpr>(Op.getExpr()))
+		if (SRE->getKind() == MCSymbolRefExpr::VK_None) {
+			O << SRE->getSymbol();
+			return;
+		}
+	O << *Op.getExpr();
+}
+
+/// printMemOperand - Print the "Rb, offset" pair of LDB/LDW/STB/STW. The
+/// operand holds the offset in bytes, LDW and STW count it in words.
+void LC3bInstPrinter::printMemOperand(const MCInst *MI, unsigned OpNo,
+                                      raw_ostream &O) {
+	printOperand(MI, OpNo, O);
+	O << ", ";
+	const MCOperand &Off = MI->getOperand(OpNo + 1);
+	if (Off.isImm() &&
+	    (MI->getOpcode() == LC3b::LDW || MI->getOpcode() == LC3b::STW)) {
+		assert((Off.getImm() & 1) == 0 && "unaligned word offset");
+		O << '#' << Off.getImm() / 2;
+		return;
+	}
+	printOperand(MI, OpNo + 1, O);
+}
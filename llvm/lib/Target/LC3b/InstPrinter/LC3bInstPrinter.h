@@ -0,0 +1,37 @@
+//===-- LC3bInstPrinter.h - Convert LC3b MCInst to assembly ----*- C++ -*-===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This class prints an LC3b MCInst to a .s file.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LC3bINSTPRINTER_H
+#define LC3bINSTPRINTER_H
+#include "llvm/MC/MCInstPrinter.h"
+
+namespace llvm {
+		class LC3bInstPrinter : public MCInstPrinter {
+		public:
+				LC3bInstPrinter(const MCAsmInfo &MAI, const MCInstrInfo &MII,
+				                const MCRegisterInfo &MRI)
+				: MCInstPrinter(MAI, MII, MRI) {}
+
+				// Autogenerated by tblgen.
+				void printInstruction(const MCInst *MI, raw_ostream &O);
+				static const char *getRegisterName(unsigned RegNo);
+				bool printAliasInstr(const MCInst *MI, raw_ostream &OS);
+
+				virtual void printRegName(raw_ostream &OS, unsigned RegNo) const;
+				virtual void printInst(const MCInst *MI, raw_ostream &O, StringRef Annot);
+
+		private:
+				void printOperand(const MCInst *MI, unsigned OpNo, raw_ostream &O);
+				void printMemOperand(const MCInst *MI, unsigned OpNo, raw_ostream &O);
+		};
+} // end namespace llvm
+#endif
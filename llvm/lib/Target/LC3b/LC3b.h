@@ -0,0 +1,49 @@
+//===-- LC3b.h - Top-level interface for LC3b representation ----*- C++ -*-===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the entry points for global functions defined in
+// the LLVM LC3b back-end.
+//
+//===----------------------------------------------------------------------===//
+#ifndef TARGET_LC3B_H
+#define TARGET_LC3B_H
+
+#include "MCTargetDesc/LC3bMCTargetDesc.h"
+#include "llvm/Target/TargetMachine.h"
+
+namespace LC3bCC {
+	// The n/z/p mask of BR: branch if one of the selected condition codes,
+	// set by the last ADD/AND/XOR/shift/load, is on.
+	enum CondCodes {
+		COND_P = 1,
+		COND_Z = 2,
+		COND_N = 4,
+		COND_ZP = COND_Z | COND_P,
+		COND_NP = COND_N | COND_P,
+		COND_NZ = COND_N | COND_Z,
+		COND_NZP = COND_N | COND_Z | COND_P
+	};
+}
+
+namespace llvm {
+	class LC3bTargetMachine;
+	class FunctionPass;
+	class ImmutablePass;
+
+	FunctionPass *createLC3bISelDag(LC3bTargetMachine &TM,
+	                                CodeGenOpt::Level OptLevel);
+	FunctionPass *createLC3bCountedLoopsPass(LC3bTargetMachine &TM);
+	FunctionPass *createLC3bLongBranchPass(LC3bTargetMachine &TM);
+	FunctionPass *createLC3bPeepholePass(LC3bTargetMachine &TM);
+	FunctionPass *createLC3bCycleEstimatePass(LC3bTargetMachine &TM);
+
+	ImmutablePass *createLC3bTargetTransformInfoPass(const LC3bTargetMachine *TM);
+} // end namespace llvm;
+
+#endif
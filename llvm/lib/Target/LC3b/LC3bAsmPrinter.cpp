@@ -28,8 +28,10 @@
 #include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCSymbol.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/Mangler.h"
@@ -51,188 +53,92 @@ void LC3bAsmPrinter::EmitInstruction(const MachineInstr *MI) {
 		PrintDebugValueComment(MI, OS);
 		return;
 	}
+	// The literal of a long branch is data in the middle of the code.
+	if (MI->getOpcode() == LC3b::LONG_BRANCH_ADDR) {
+		const MCSymbol *Target = MI->getOperand(0).getMBB()->getSymbol();
+		OutStreamer.EmitValue(MCSymbolRefExpr::Create(Target, OutContext), 2);
+		return;
+	}
+	if (MI->getOpcode() == LC3b::LONG_LEA) {
+		EmitLongLEA(MI);
+		return;
+	}
+	if (MI->getOpcode() == LC3b::LONG_CALL) {
+		EmitLongCall(MI);
+		return;
+	}
 	MCInst TmpInst0;
 	MCInstLowering.Lower(MI, TmpInst0);
 	OutStreamer.EmitInstruction(TmpInst0);
 }
-//===----------------------------------------------------------------------===//
-//
-// LC3b Asm Directives
-//
-// -- Frame directive "frame Stackpointer, Stacksize, RARegister"
-// Describe the stack frame.
-
-// -- Mask directives "(f)mask bitmask, offset"
-// Tells the assembler which registers are saved and where.
-// bitmask - contain a little endian bitset indicating which registers are 
-// saved on function prologue (e.g. with a 0x80000000 mask, 
-// the assembler knows the register 31 (RA) is saved at prologue.
-// offset - the position before stack pointer subtraction indicating where
-// the first saved register on prologue is located. 
-// (e.g. with a Consider the following function prologue:
-//
-// 		.frame $fp,48,$ra
-// 		.mask 0xc0000000,-8
-// 		addiu $sp, $sp, -48
-// 		st $ra, 40($sp)
-// 		st $fp, 36($sp)
-//
-// With a 0xc0000000 mask, the assembler knows the register 31 (RA) and
-// 30 (FP) are saved at prologue. As the save order on prologue is from
-// left to right, RA is saved first. A -8 offset means that after the
-// stack pointer subtration, the first register in the mask (RA) will be
-// saved at address 48-8=40.
-//
-//===----------------------------------------------------------------------===//
-
-//===----------------------------------------------------------------------===//
-// Mask directives
-//===----------------------------------------------------------------------===//
-
-/////////////////////////////////////////////////////////////////////////
-// 		.frame $sp,8,$lr
-//	-> 	.mask 0x00000000,0
-// 		.set noreorder
-// 		.set nomacro
-/////////////////////////////////////////////////////////////////////////
-// Create a bitmask with all callee saved registers for CPU or Floating Point
-// registers. For CPU registers consider RA, GP and FP for saving if necessary.
-
-void LC3bAsmPrinter::printSavedRegsBitmask(raw_ostream &O) {
-
-	// CPU and FPU Saved Registers Bitmasks
-	unsigned CPUBitmask = 0;
-	int CPUTopSavedRegOff;
-
-	// Set the CPU and FPU Bitmasks
-	const MachineFrameInfo *MFI = MF->getFrameInfo();
-	const std::vector<CalleeSavedInfo> &CSI = MFI->getCalleeSavedInfo();
-
-	// size of stack area to which FP callee-saved regs are saved.
-	unsigned CPURegSize = LC3b::CPURegsRegClass.getSize();
-	unsigned i = 0, e = CSI.size();
-
-	// Set CPU Bitmask.
-	for (; i != e; ++i) {
-		unsigned Reg = CSI[i].getReg();
-		unsigned RegNum = getLC3bRegisterNumbering(Reg);
-		CPUBitmask |= (1 << RegNum);
-	}
-
-	CPUTopSavedRegOff = CPUBitmask ? -CPURegSize : 0;
-	// Print CPUBitmask
-
-	O << "\t.mask \t"; printHex32(CPUBitmask, O);
-	O << ’,’ << CPUTopSavedRegOff << ’\n’;
-
-}
-
-// Print a 32 bit hex number with all numbers. FIXME
-void LC3bAsmPrinter::printHex32(unsigned Value, raw_ostream &O) {
-	O << "0x";
-	for (int i = 7; i >= 0; i--)
-		O.write_hex((Value & (0xF << (i*4))) >> (i*4));
-}
-
-//===----------------------------------------------------------------------===//
-// Frame and Set directives
-//===----------------------------------------------------------------------===//
-
-/////////////////////////////////////////////////////////////////////////
-//-> .frame $sp,8,$lr
-// .mask 0x00000000,0
-// .set noreorder
-// .set nomacro
-/////////////////////////////////////////////////////////////////////////
-/// Frame Directive
-void LC3bAsmPrinter::emitFrameDirective() {
-	const TargetRegisterInfo &RI = *TM.getRegisterInfo();
-	unsigned stackReg = RI.getFrameRegister(*MF);
-	unsigned returnReg = RI.getRARegister();
-	unsigned stackSize = MF->getFrameInfo()->getStackSize();
-	if (OutStreamer.hasRawTextSupport())
-		OutStreamer.EmitRawText("\t.frame\t$" 
-			+ StringRef(LC3bInstPrinter::getRegisterName(stackReg)).lower() 
-			+ "," + Twine(stackSize) + ",$" 
-			+ StringRef(LC3bInstPrinter::getRegisterName(returnReg)).lower()
-			);
-}
-
-/// Emit Set directives.
-const char *LC3bAsmPrinter::getCurrentABIString() const {
-	switch (Subtarget->getTargetABI()) {
-		case LC3bSubtarget::O32: return "abi32";
-		default: llvm_unreachable("Unknown LC3b ABI");;
-	}
-}
-
-/////////////////////////////////////////////////////////////////////////
-// 		.type main,	@function
-//	-> 	.ent main # @main
-// 	main:
-/////////////////////////////////////////////////////////////////////////
-
-void LC3bAsmPrinter::EmitFunctionEntryLabel() {
-	if (OutStreamer.hasRawTextSupport())
-	OutStreamer.EmitRawText("\t.ent\t" + Twine(CurrentFnSym->getName()));
-	OutStreamer.EmitLabel(CurrentFnSym);
-}
-/////////////////////////////////////////////////////////////////////////
-// 		.frame $sp,8,$pc
-// 		.mask 0x00000000,0
-//	-> 	.set noreorder
-//	-> 	.set nomacro
-/////////////////////////////////////////////////////////////////////////
-/// EmitFunctionBodyStart - Targets can override this to emit stuff before
-/// the first basic block in the function.
-
+/// EmitFunctionBodyStart - LC-3b assemblers take no frame or mask
+/// directives, only the operand lowering needs the function's context.
 void LC3bAsmPrinter::EmitFunctionBodyStart() {
 	MCInstLowering.Initialize(Mang, &MF->getContext());
-	emitFrameDirective();
-	if (OutStreamer.hasRawTextSupport()) {
-		SmallString<128> Str;
-		raw_svector_ostream OS(Str);
-		printSavedRegsBitmask(OS);
-		OutStreamer.EmitRawText(OS.str());
-		OutStreamer.EmitRawText(StringRef("\t.set\tnoreorder"));
-		OutStreamer.EmitRawText(StringRef("\t.set\tnomacro"));
-		if (LC3bFI->getEmitNOAT())
-			OutStreamer.EmitRawText(StringRef("\t.set\tat"));
-	}
 }
 
-/////////////////////////////////////////////////////////////////////////
-//	-> 	.set macro
-//	-> 	.set reorder
-//	-> 	.end main
-/////////////////////////////////////////////////////////////////////////
-/// EmitFunctionBodyEnd - Targets can override this to emit stuff after
-/// the last basic block in the function.
-
+/// EmitFunctionBodyEnd - The constant pool follows the code, in the same
+/// section, where the LEAs of its entries reach it. EmitConstantPool does
+/// nothing, the generic one would emit the pool ahead of the function.
 void LC3bAsmPrinter::EmitFunctionBodyEnd() {
-// There are instruction for this macros, but they must
-// always be at the function end, and we can’t emit and
-// break with BB logic.
-	if (OutStreamer.hasRawTextSupport()) {
-		if (LC3bFI->getEmitNOAT())
-			OutStreamer.EmitRawText(StringRef("\t.set\tat"));
-		OutStreamer.EmitRawText(StringRef("\t.set\tmacro"));
-		OutStreamer.EmitRawText(StringRef("\t.set\treorder"));
-		OutStreamer.EmitRawText("\t.end\t" + Twine(CurrentFnSym->getName()));
+	const std::vector<MachineConstantPoolEntry> &CP =
+		MF->getConstantPool()->getConstants();
+	for (unsigned i = 0, e = CP.size(); i != e; ++i) {
+		EmitAlignment(Log2_32(CP[i].getAlignment()));
+		OutStreamer.EmitLabel(GetCPISymbol(i));
+		if (CP[i].isMachineConstantPoolEntry())
+			EmitMachineConstantPoolValue(CP[i].Val.MachineCPVal);
+		else
+			EmitGlobalConstant(CP[i].Val.ConstVal);
 	}
 }
-/////////////////////////////////////////////////////////////////////////
-// 	.section .mdebug.abi32
-// 	.previous
-/////////////////////////////////////////////////////////////////////////
-void LC3bAsmPrinter::EmitStartOfAsmFile(Module &M) {
-// FIXME: Use SwitchSection.
-// Tell the assembler which ABI we are using
-	if (OutStreamer.hasRawTextSupport())
-		OutStreamer.EmitRawText("\t.section .mdebug." + Twine(getCurrentABIString()));
-	// return to previous section
-	if (OutStreamer.hasRawTextSupport())
-		OutStreamer.EmitRawText(StringRef("\t.previous"));
+
+/// EmitLongLEA - LONG_LEA loads the address of the entry from a literal
+/// that the BR skips.
+void LC3bAsmPrinter::EmitLongLEA(const MachineInstr *MI) {
+	unsigned Reg = MI->getOperand(0).getReg();
+	const MachineOperand &MO = MI->getOperand(1);
+	const MCSymbol *Sym = MO.isCPI() ? GetCPISymbol(MO.getIndex())
+	                                 : GetJTISymbol(MO.getIndex());
+
+	MCInst LEA, BR, LDW;
+	LEA.setOpcode(LC3b::LEA);
+	LEA.addOperand(MCOperand::CreateReg(Reg));
+	LEA.addOperand(MCOperand::CreateImm(1));
+	OutStreamer.EmitInstruction(LEA);
+	BR.setOpcode(LC3b::BRnzp);
+	BR.addOperand(MCOperand::CreateImm(1));
+	OutStreamer.EmitInstruction(BR);
+	OutStreamer.EmitValue(MCSymbolRefExpr::Create(Sym, OutContext), 2);
+	LDW.setOpcode(LC3b::LDW);
+	LDW.addOperand(MCOperand::CreateReg(Reg));
+	LDW.addOperand(MCOperand::CreateReg(Reg));
+	LDW.addOperand(MCOperand::CreateImm(0));
+	OutStreamer.EmitInstruction(LDW);
+}
+
+/// EmitLongCall - LONG_CALL loads the callee address into R7 from a literal
+/// that the BR skips, and calls through it.
+void LC3bAsmPrinter::EmitLongCall(const MachineInstr *MI) {
+	MCOperand Target = MCInstLowering.LowerOperand(MI->getOperand(0));
+
+	MCInst LEA, BR, LDW, JSRR;
+	LEA.setOpcode(LC3b::LEA);
+	LEA.addOperand(MCOperand::CreateReg(LC3b::R7));
+	LEA.addOperand(MCOperand::CreateImm(1));
+	OutStreamer.EmitInstruction(LEA);
+	BR.setOpcode(LC3b::BRnzp);
+	BR.addOperand(MCOperand::CreateImm(1));
+	OutStreamer.EmitInstruction(BR);
+	OutStreamer.EmitValue(Target.getExpr(), 2);
+	LDW.setOpcode(LC3b::LDW);
+	LDW.addOperand(MCOperand::CreateReg(LC3b::R7));
+	LDW.addOperand(MCOperand::CreateReg(LC3b::R7));
+	LDW.addOperand(MCOperand::CreateImm(0));
+	OutStreamer.EmitInstruction(LDW);
+	JSRR.setOpcode(LC3b::JSRR);
+	JSRR.addOperand(MCOperand::CreateReg(LC3b::R7));
+	OutStreamer.EmitInstruction(JSRR);
 }
 
 MachineLocation LC3bAsmPrinter::getDebugValueLocation(const MachineInstr *MI) const {
@@ -25,7 +25,6 @@ namespace llvm {
 		class Module;
 		class raw_ostream;
 		class LLVM_LIBRARY_VISIBILITY LC3bAsmPrinter : public AsmPrinter {
-				void EmitInstrWithMacroNoAT(const MachineInstr *MI);
 				public:
 				const LC3bSubtarget *Subtarget;
 				const LC3bFunctionInfo *LC3bFI;
@@ -40,14 +39,11 @@ namespace llvm {
 				virtual bool runOnMachineFunction(MachineFunction &MF);
 				//- EmitInstruction() must exists or will have run time error.
 				void EmitInstruction(const MachineInstr *MI);
-				void printSavedRegsBitmask(raw_ostream &O);
-				void printHex32(unsigned int Value, raw_ostream &O);
-				void emitFrameDirective();
-				const char *getCurrentABIString() const;
-				virtual void EmitFunctionEntryLabel();
+				void EmitLongLEA(const MachineInstr *MI);
+				void EmitLongCall(const MachineInstr *MI);
 				virtual void EmitFunctionBodyStart();
 				virtual void EmitFunctionBodyEnd();
-				void EmitStartOfAsmFile(Module &M);
+				virtual void EmitConstantPool() {}
 				virtual MachineLocation getDebugValueLocation(const MachineInstr *MI) const;
 				void PrintDebugValueComment(const MachineInstr *MI, raw_ostream &OS);
 		};
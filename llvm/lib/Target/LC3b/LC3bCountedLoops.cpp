@@ -0,0 +1,279 @@
+//===-- LC3bCountedLoops.cpp - Count loops down to zero -------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// LC3b has no loop instruction, but every ADD sets the n/z/p flags, so a
+// counter decremented right before the back edge is the whole loop test.
+// This pass rewrites counted loops whose induction variable only counts:
+//
+//	$loop:                            $loop:
+//	  ...                               ...
+//	  ADD   Ri, Ri, #1                  ADD   Rc, Rc, #-1
+//	  ADD   Rt, Ri, Rnegn               BRnp  $loop
+//	  BRnp  $loop
+//
+// with Rc = n - i computed once in the preheader. The latch compare is an
+// equality, which is what the exit test of a loop in canonical form is
+// (IndVarSimplify rewrites it to i.next != n), and the counter preserves
+// it exactly: i.next == n if and only if Rc - 1 == 0, wrap-around included.
+// BRcc then expands without a TST, see LC3bInstrInfo::expandPostRAPseudo.
+//
+// ScalarEvolution is not available on machine code; like the hardware loop
+// passes of Hexagon and PowerPC, the trip count is read off the induction
+// PHI, its +/-1 step and the compare. The pass runs before register
+// allocation, while the function is in SSA form.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "lc3b-counted-loops"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumCountedLoops, "Number of loops counted down to zero");
+
+static cl::opt<bool> DisableCountedLoops(
+	"disable-lc3b-counted-loops",
+	cl::init(false),
+	cl::desc("LC3b: Disable counting loops down to zero."),
+	cl::Hidden);
+
+namespace {
+	class LC3bCountedLoops : public MachineFunctionPass {
+	public:
+		static char ID;
+		LC3bCountedLoops(TargetMachine &tm)
+			: MachineFunctionPass(ID),
+			  TII(static_cast<const LC3bInstrInfo*>(tm.getInstrInfo())) {}
+
+		virtual const char *getPassName() const {
+			return "LC3b Counted Loops";
+		}
+
+		virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+			AU.setPreservesCFG();
+			AU.addRequired<MachineLoopInfo>();
+			AU.addPreserved<MachineLoopInfo>();
+			MachineFunctionPass::getAnalysisUsage(AU);
+		}
+
+		bool runOnMachineFunction(MachineFunction &F);
+
+	private:
+		bool convertLoop(MachineLoop *L);
+
+		const LC3bInstrInfo *TII;
+		MachineRegisterInfo *MRI;
+	};
+
+	char LC3bCountedLoops::ID = 0;
+} // end of anonymous namespace
+
+/// createLC3bCountedLoopsPass - Returns a pass that counts loops down to
+/// zero.
+FunctionPass *llvm::createLC3bCountedLoopsPass(LC3bTargetMachine &tm) {
+	return new LC3bCountedLoops(tm);
+}
+
+/// convertLoop - Replace the induction variable of L and its compare by a
+/// counter decremented in the latch. The loop must have a preheader and a
+/// single latch that is also its only exit, ending in a BRcc that leaves
+/// the loop exactly when
+///	Rt = ADD Ri.next, #imm  or  Rt = ADD Ri.next, Rinv
+/// is zero, with Ri.next = ADD Ri, #1 or #-1 and Rinv defined outside the
+/// loop. The DAG combiner may have turned the compare into one of Ri with
+/// the bound moved by a step, that is accepted too. Nothing else may read
+/// Ri or Ri.next: an induction variable the body uses would have to be
+/// kept next to the counter, and save nothing.
+bool LC3bCountedLoops::convertLoop(MachineLoop *L) {
+	MachineBasicBlock *Header = L->getHeader();
+	MachineBasicBlock *Preheader = L->getLoopPreheader();
+	MachineBasicBlock *Latch = L->getLoopLatch();
+	if (!Preheader || !Latch || L->getExitingBlock() != Latch)
+		return false;
+
+	// The exit test. BRcc to the header continues on NP, BRcc out of the
+	// loop leaves on Z; either way the loop runs while Rt != 0.
+	MachineBasicBlock::iterator Br = Latch->getFirstTerminator();
+	if (Br == Latch->end() || Br->getOpcode() != LC3b::BRcc)
+		return false;
+	MachineBasicBlock *Target = Br->getOperand(0).getMBB();
+	int64_t NZP = Br->getOperand(2).getImm();
+	if (!(Target == Header && NZP == LC3bCC::COND_NP) &&
+	    !(!L->contains(Target) && NZP == LC3bCC::COND_Z))
+		return false;
+
+	unsigned TestReg = Br->getOperand(1).getReg();
+	if (!TargetRegisterInfo::isVirtualRegister(TestReg) ||
+	    !MRI->hasOneNonDBGUse(TestReg))
+		return false;
+	MachineInstr *Test = MRI->getVRegDef(TestReg);
+	if (!Test || Test->getParent() != Latch ||
+	    (Test->getOpcode() != LC3b::ADDI && Test->getOpcode() != LC3b::ADD))
+		return false;
+
+	// Ri.next, or Ri when the compare was rewritten to test the value before
+	// the step, is one operand of the compare. The other is an immediate or
+	// loop invariant.
+	unsigned IVIdx = 0;
+	bool TestsNext = false;
+	for (unsigned i = 1; i != 3 && !IVIdx; ++i) {
+		const MachineOperand &MO = Test->getOperand(i);
+		if (!MO.isReg() || !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+			continue;
+		MachineInstr *Def = MRI->getVRegDef(MO.getReg());
+		if (!Def || !L->contains(Def->getParent()))
+			continue;
+		if (Def->getOpcode() == LC3b::ADDI) {
+			IVIdx = i;
+			TestsNext = true;
+		} else if (Def->isPHI() && Def->getParent() == Header)
+			IVIdx = i;
+	}
+	if (!IVIdx)
+		return false;
+	const MachineOperand &Inv = Test->getOperand(3 - IVIdx);
+	if (Inv.isReg()) {
+		MachineInstr *InvDef = MRI->getVRegDef(Inv.getReg());
+		if (!InvDef || L->contains(InvDef->getParent()))
+			return false;
+	}
+
+	unsigned IVReg, NextReg;
+	MachineInstr *Step, *Phi;
+	if (TestsNext) {
+		NextReg = Test->getOperand(IVIdx).getReg();
+		Step = MRI->getVRegDef(NextReg);
+		IVReg = Step->getOperand(1).getReg();
+		Phi = MRI->getVRegDef(IVReg);
+	} else {
+		IVReg = Test->getOperand(IVIdx).getReg();
+		Phi = MRI->getVRegDef(IVReg);
+		if (Phi->getNumOperands() != 5)
+			return false;
+		NextReg = Phi->getOperand(Phi->getOperand(2).getMBB() == Latch ? 1 : 3)
+			.getReg();
+		Step = MRI->getVRegDef(NextReg);
+		if (!Step || Step->getOpcode() != LC3b::ADDI ||
+		    Step->getOperand(1).getReg() != IVReg)
+			return false;
+	}
+	int64_t StepImm = Step->getOperand(2).getImm();
+	if (StepImm != 1 && StepImm != -1)
+		return false;
+
+	if (!Phi || !Phi->isPHI() || Phi->getParent() != Header ||
+	    Phi->getNumOperands() != 5)
+		return false;
+	unsigned InitReg = 0;
+	for (unsigned i = 1; i != 5; i += 2) {
+		MachineBasicBlock *MBB = Phi->getOperand(i + 1).getMBB();
+		unsigned Reg = Phi->getOperand(i).getReg();
+		if (MBB == Preheader)
+			InitReg = Reg;
+		else if (MBB != Latch || Reg != NextReg)
+			return false;
+	}
+	if (!InitReg)
+		return false;
+
+	// Ri feeds the step and Ri.next the PHI, and one of them the compare.
+	// Nothing else.
+	for (MachineRegisterInfo::use_nodbg_iterator UI = MRI->use_nodbg_begin(IVReg),
+	     UE = MRI->use_nodbg_end(); UI != UE; ++UI)
+		if (&*UI != Step && (TestsNext || &*UI != Test))
+			return false;
+	for (MachineRegisterInfo::use_nodbg_iterator UI = MRI->use_nodbg_begin(NextReg),
+	     UE = MRI->use_nodbg_end(); UI != UE; ++UI)
+		if (&*UI != Phi && (!TestsNext || &*UI != Test))
+			return false;
+
+	DEBUG(dbgs() << "LC3b counted loop: BB#" << Header->getNumber() << '\n');
+
+	// Rt is Ri.next - n, and Ri.next - n evaluated at Ri.next = init is
+	// init - n. Counting up the trip count is n - init, counting down it
+	// is init - n.
+	const TargetRegisterClass *RC = &LC3b::LC3bRegsRegClass;
+	MachineBasicBlock::iterator InsertPt = Preheader->getFirstTerminator();
+	DebugLoc DL = Br->getDebugLoc();
+	unsigned Diff = MRI->createVirtualRegister(RC);
+	MachineInstrBuilder MIB =
+		BuildMI(*Preheader, InsertPt, DL, TII->get(Test->getOpcode()), Diff)
+		.addReg(InitReg);
+	if (Inv.isReg()) {
+		MIB.addReg(Inv.getReg());
+		MRI->clearKillFlags(Inv.getReg());
+	} else
+		MIB.addImm(Inv.getImm());
+	MRI->clearKillFlags(InitReg);
+
+	unsigned Count = Diff;
+	if (StepImm == 1) {
+		unsigned Not = MRI->createVirtualRegister(RC);
+		Count = MRI->createVirtualRegister(RC);
+		BuildMI(*Preheader, InsertPt, DL, TII->get(LC3b::XORI), Not)
+			.addReg(Diff, RegState::Kill).addImm(-1);
+		BuildMI(*Preheader, InsertPt, DL, TII->get(LC3b::ADDI), Count)
+			.addReg(Not, RegState::Kill).addImm(1);
+	}
+	// A compare of Ri sees the counter one step later than one of Ri.next.
+	if (!TestsNext) {
+		unsigned Later = MRI->createVirtualRegister(RC);
+		BuildMI(*Preheader, InsertPt, DL, TII->get(LC3b::ADDI), Later)
+			.addReg(Count, RegState::Kill).addImm(1);
+		Count = Later;
+	}
+
+	// Rc = phi(count, Rc.next), and Rc.next = Rc - 1 right before the BRcc
+	// so that it sets the flags the branch reads.
+	unsigned Counter = MRI->createVirtualRegister(RC);
+	unsigned NextCounter = MRI->createVirtualRegister(RC);
+	BuildMI(*Header, Header->begin(), Phi->getDebugLoc(),
+	        TII->get(TargetOpcode::PHI), Counter)
+		.addReg(Count).addMBB(Preheader)
+		.addReg(NextCounter).addMBB(Latch);
+	BuildMI(*Latch, Br, DL, TII->get(LC3b::ADDI), NextCounter)
+		.addReg(Counter).addImm(-1);
+	Br->getOperand(1).setReg(NextCounter);
+	Br->getOperand(1).setIsKill(false);
+
+	Test->eraseFromParent();
+	Phi->eraseFromParent();
+	Step->eraseFromParent();
+	++NumCountedLoops;
+	return true;
+}
+
+bool LC3bCountedLoops::runOnMachineFunction(MachineFunction &F) {
+	if (DisableCountedLoops)
+		return false;
+
+	MRI = &F.getRegInfo();
+	MachineLoopInfo &MLI = getAnalysis<MachineLoopInfo>();
+
+	// Innermost loops only, they are where the time goes and their latch is
+	// not shared with a nested loop.
+	SmallVector<MachineLoop*, 8> Worklist(MLI.begin(), MLI.end());
+	bool Changed = false;
+	while (!Worklist.empty()) {
+		MachineLoop *L = Worklist.pop_back_val();
+		if (!L->empty()) {
+			Worklist.append(L->begin(), L->end());
+			continue;
+		}
+		Changed |= convertLoop(L);
+	}
+	return Changed;
+}
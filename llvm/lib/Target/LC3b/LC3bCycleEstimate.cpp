@@ -0,0 +1,79 @@
+//===-- LC3bCycleEstimate.cpp - Static LC3b cycle estimate ----------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// With -lc3b-cycle-estimate this pass prints, for every function, the sum
+// over its blocks of the block frequency relative to the entry times the
+// itinerary latency of the block's instructions. The LC-3b executes one
+// instruction at a time, so that is the expected number of cycles per call.
+// It is used to compare register allocators and other codegen options on
+// test/CodeGen/LC3b/regalloc-*.ll, and has no effect on the code.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "lc3b-cycle-estimate"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+namespace {
+	class LC3bCycleEstimate : public MachineFunctionPass {
+	public:
+		static char ID;
+		LC3bCycleEstimate(TargetMachine &tm)
+			: MachineFunctionPass(ID), TM(tm) {}
+
+		virtual const char *getPassName() const {
+			return "LC3b Cycle Estimate";
+		}
+
+		virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+			AU.setPreservesAll();
+			AU.addRequired<MachineBlockFrequencyInfo>();
+			MachineFunctionPass::getAnalysisUsage(AU);
+		}
+
+		bool runOnMachineFunction(MachineFunction &F);
+
+	private:
+		TargetMachine &TM;
+	};
+
+	char LC3bCycleEstimate::ID = 0;
+} // end of anonymous namespace
+
+bool LC3bCycleEstimate::runOnMachineFunction(MachineFunction &F) {
+	const TargetInstrInfo *TII = TM.getInstrInfo();
+	const InstrItineraryData *Itin = TM.getInstrItineraryData();
+	const MachineBlockFrequencyInfo &MBFI =
+		getAnalysis<MachineBlockFrequencyInfo>();
+
+	// Frequencies are fixed point with the entry at getEntryFrequency().
+	uint64_t Cycles = 0;
+	for (MachineFunction::iterator MBB = F.begin(), E = F.end(); MBB != E; ++MBB) {
+		uint64_t Latency = 0;
+		for (MachineBasicBlock::iterator I = MBB->begin(), IE = MBB->end();
+		     I != IE; ++I)
+			if (!I->isDebugValue())
+				Latency += TII->getInstrLatency(Itin, I);
+		Cycles += Latency * MBFI.getBlockFreq(MBB).getFrequency();
+	}
+
+	errs() << "LC3b cycle estimate: " << F.getName() << ' '
+	       << Cycles / BlockFrequency::getEntryFrequency() << '\n';
+	return false;
+}
+
+/// createLC3bCycleEstimatePass - Returns a pass that prints the static
+/// cycle estimate of each function. LC3bPassConfig adds it for
+/// -lc3b-cycle-estimate.
+FunctionPass *llvm::createLC3bCycleEstimatePass(LC3bTargetMachine &tm) {
+	return new LC3bCycleEstimate(tm);
+}
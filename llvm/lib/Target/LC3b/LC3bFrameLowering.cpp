@@ -19,78 +19,133 @@
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/RegisterScavenging.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ErrorHandling.h"
 using namespace llvm;
-//FIXME : check the file again something might be wrong.
 //- emitPrologue() and emitEpilogue must exist for main().
 //===----------------------------------------------------------------------===//
 //
 // Stack Frame Processing methods
 // +----------------------------+
 //
-// The stack is allocated decrementing the stack pointer on
-// the first instruction of a function prologue. Once decremented,
-// all stack references are done thought a positive offset
-// from the stack/frame pointer, so the stack is considering
-// to grow up! Otherwise terrible hacks would have to be made
-// to get this stack ABI compliant :)
+// R6 is the stack pointer and the only frame base, LC3b functions have no
+// frame pointer. The stack is allocated decrementing R6 on the first
+// instructions of the prologue; once decremented, all stack references are
+// done with a positive offset from R6.
 //
-// The stack frame required by the ABI (after call):
-// Offset
+// The stack frame (after the prologue):
 //
-// 0
-----------
-// 4 Args to pass
-// . saved $GP (used in PIC)
-// . Alloca allocations
-// . Local Area
-// . CPU "Callee Saved" Registers
-// . saved FP
-// . saved RA
-// . FPU "Callee Saved" Registers
-// StackSize
------------
+// R6 + StackSize + n : incoming stack arguments (5th and later)
+//                      ...
+// R6 + StackSize - 2 : callee saved registers (R7 first, when the function
+//                      makes calls, then R5/R4 if clobbered)
+//                      locals and spill slots
+// R6 + 0             : outgoing stack arguments of the calls made by this
+//                      function (MaxCallFrameSize bytes)
 //
-// Offset - offset from sp after stack allocation on function prologue
+// Leaf functions that need no stack object get StackSize == 0 and no
+// prologue or epilogue code at all, R7 stays in its register because it is
+// only saved when a JSR/JSRR clobbers it.
 //
-// The sp is the stack pointer subtracted/added from the stack size
-// at the Prologue/Epilogue
-//
-// References to the previous stack (to obtain arguments) are done
-// with offsets that exceeds the stack size: (stacksize+(4*(num_arg-1))
-//
-// Examples:
-// - reference to the actual stack frame
-// for any local area var there is smt like : FI >= 0, StackOffset: 4
-// st REGX, 4(SP)
-//
-// - reference to previous stack frame
-// suppose there’s a load to the 5th arguments : FI < 0, StackOffset: 16.
-// The emitted instruction will be something like:
-// ld REGX, 16+StackSize(SP)
-//
-// Since the total stack size is unknown on LowerFormalArguments, all
-// stack references (ObjectOffset) created to reference the function
-// arguments, are negative numbers. This way, on eliminateFrameIndex it’s
-// possible to detect those references and the offsets are adjusted to
-// their real location.
+// LDW/STW reach R6+[-64,62] and LDB/STB R6+[-32,31]; eliminateFrameIndex
+// falls back to a scavenged base register for anything further away.
 //
 //===----------------------------------------------------------------------===//
-//- Must have, hasFP() is pure virtual of parent
-// hasFP - Return true if the specified function should have a dedicated frame
-// pointer register. This is true if the function has variable sized allocas or
-// if frame pointer elimination is disabled.
 
+// hasFP - Return true if the specified function should have a dedicated frame
+// pointer register. LC3b never reserves one, every frame is addressed off R6.
 bool LC3bFrameLowering::hasFP(const MachineFunction &MF) const {
-	const MachineFrameInfo *MFI = MF.getFrameInfo();
-	return MF.getTarget().Options.DisableFramePointerElim(MF) ||
-	MFI->hasVarSizedObjects() || MFI->isFrameAddressTaken();
+	return false;
 }
+
+// hasReservedCallFrame - The outgoing argument area is part of the fixed
+// frame, so calls don't adjust R6.
+bool LC3bFrameLowering::hasReservedCallFrame(const MachineFunction &MF) const {
+	return !MF.getFrameInfo()->hasVarSizedObjects();
+}
+
 void LC3bFrameLowering::emitPrologue(MachineFunction &MF) const {
+	MachineBasicBlock &MBB = MF.front();	// Prolog goes in entry BB
+	MachineFrameInfo *MFI = MF.getFrameInfo();
+	const LC3bInstrInfo &TII =
+		*static_cast<const LC3bInstrInfo*>(MF.getTarget().getInstrInfo());
+	MachineBasicBlock::iterator MBBI = MBB.begin();
+	DebugLoc dl = MBBI != MBB.end() ? MBBI->getDebugLoc() : DebugLoc();
+
+	if (MFI->hasVarSizedObjects())
+		report_fatal_error("LC3b does not support dynamic stack allocation");
+
+	// First, compute final stack size.
+	uint64_t StackSize = MFI->getStackSize();
+
+	// No need to allocate space on the stack.
+	if (StackSize == 0)
+		return;
+
+	// Adjust stack : addi R6, R6, (-imm)
+	TII.adjustStackPtr(-(int64_t)StackSize, MBB, MBBI, dl);
 }
+
 void LC3bFrameLowering::emitEpilogue(MachineFunction &MF,
-	MachineBasicBlock &MBB) const {
+                                     MachineBasicBlock &MBB) const {
+	MachineBasicBlock::iterator MBBI = MBB.getLastNonDebugInstr();
+	MachineFrameInfo *MFI = MF.getFrameInfo();
+	const LC3bInstrInfo &TII =
+		*static_cast<const LC3bInstrInfo*>(MF.getTarget().getInstrInfo());
+	DebugLoc dl = MBBI->getDebugLoc();
+
+	// Get the number of bytes from FrameInfo
+	uint64_t StackSize = MFI->getStackSize();
+
+	if (!StackSize)
+		return;
+
+	// Adjust stack : addi R6, R6, imm
+	// The callee saved registers have already been reloaded above MBBI.
+	TII.adjustStackPtr(StackSize, MBB, MBBI, dl);
+}
+
+// Eliminate ADJCALLSTACKDOWN, ADJCALLSTACKUP pseudo instructions
+void LC3bFrameLowering::
+eliminateCallFramePseudoInstr(MachineFunction &MF, MachineBasicBlock &MBB,
+                              MachineBasicBlock::iterator I) const {
+	const LC3bInstrInfo &TII =
+		*static_cast<const LC3bInstrInfo*>(MF.getTarget().getInstrInfo());
+
+	if (!hasReservedCallFrame(MF)) {
+		int64_t Amount = I->getOperand(0).getImm();
+
+		if (I->getOpcode() == LC3b::ADJCALLSTACKDOWN)
+			Amount = -Amount;
+
+		if (Amount)
+			TII.adjustStackPtr(Amount, MBB, I, I->getDebugLoc());
+	}
+
+	MBB.erase(I);
 }
 
+void LC3bFrameLowering::
+processFunctionBeforeCalleeSavedScan(MachineFunction &MF,
+                                     RegScavenger *RS) const {
+	// Frame index elimination needs a scratch register once an offset falls
+	// outside the imm5 of ADD (frame addresses) or the offset6 of LDW/STW.
+	// Reserve an emergency spill slot so the scavenger always has one.
+	const MachineFrameInfo *MFI = MF.getFrameInfo();
+	int64_t IncomingArgSize = 0;
+	for (int I = MFI->getObjectIndexBegin(); I != 0; ++I)
+		IncomingArgSize = std::max(IncomingArgSize,
+		                           MFI->getObjectOffset(I) + MFI->getObjectSize(I));
+	uint64_t MaxSPOffset = IncomingArgSize + MFI->estimateStackSize(MF);
+
+	if (isInt<5>(MaxSPOffset))
+		return;
+
+	const TargetRegisterClass *RC = &LC3b::LC3bRegsRegClass;
+	int FI = MF.getFrameInfo()->CreateStackObject(RC->getSize(),
+	                                              RC->getAlignment(), false);
+	RS->addScavengingFrameIndex(FI);
+}
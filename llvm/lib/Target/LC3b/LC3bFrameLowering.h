@@ -1,4 +1,9 @@
+//===-- LC3bFrameLowering.h - Define frame lowering for LC3b ----*- C++ -*-===//
 //
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
 //
 //===----------------------------------------------------------------------===//
 #ifndef LC3b_FRAMEINFO_H
@@ -12,7 +17,7 @@ namespace llvm {
 				protected:
 				const LC3bSubtarget &STI;
 				public:
-				explicit LC3bFrameLowering(const Cpu0Subtarget &sti) : TargetFrameLowering(StackGrowsDown, 8, 0),STI(sti) {
+				explicit LC3bFrameLowering(const LC3bSubtarget &sti) : TargetFrameLowering(StackGrowsDown, 2, 0),STI(sti) {
 				}
 				/// emitProlog/emitEpilog - These methods insert prolog and epilog code into
 				/// the function.
@@ -20,8 +25,9 @@ namespace llvm {
 				void emitPrologue(MachineFunction &MF) const;
 				void emitEpilogue(MachineFunction &MF, MachineBasicBlock &MBB) const;
 				bool hasFP(const MachineFunction &MF) const;
+				bool hasReservedCallFrame(const MachineFunction &MF) const;
+				void eliminateCallFramePseudoInstr(MachineFunction &MF, MachineBasicBlock &MBB, MachineBasicBlock::iterator I) const;
+				void processFunctionBeforeCalleeSavedScan(MachineFunction &MF, RegScavenger *RS) const;
 		};
 } // End llvm namespace
 #endif
-
-
@@ -0,0 +1,380 @@
+//===-- LC3bISelDAGToDAG.cpp - A dag to dag inst selector for LC3b --------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines an instruction selector for the LC3b target.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "LC3b-isel"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "MCTargetDesc/LC3bBaseInfo.h"
+#include "LC3bTargetObjectFile.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/CodeGen/FunctionLoweringInfo.h"
+#include "llvm/CodeGen/MachineConstantPool.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/SelectionDAGISel.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+//===----------------------------------------------------------------------===//
+// Instruction Selector Implementation
+//===----------------------------------------------------------------------===//
+
+//===----------------------------------------------------------------------===//
+// LC3bDAGToDAGISel - LC3b specific code to select LC3b machine
+// instructions for SelectionDAG operations.
+//===----------------------------------------------------------------------===//
+namespace {
+
+class LC3bDAGToDAGISel : public SelectionDAGISel {
+	/// Subtarget - Keep a pointer to the LC3bSubtarget around so that we can
+	/// make the right decision when generating code for different targets.
+	const LC3bSubtarget &Subtarget;
+
+	/// CodeAfter - Estimated bytes of code from the start of each block to
+	/// the end of the function, where the constant pool goes.
+	DenseMap<const BasicBlock*, uint64_t> CodeAfter;
+
+public:
+	explicit LC3bDAGToDAGISel(LC3bTargetMachine &tm, CodeGenOpt::Level OptLevel)
+		: SelectionDAGISel(tm, OptLevel),
+		  Subtarget(tm.getSubtarget<LC3bSubtarget>()) {}
+
+	virtual const char *getPassName() const {
+		return "LC3b DAG->DAG Pattern Instruction Selection";
+	}
+
+	virtual bool runOnMachineFunction(MachineFunction &MF);
+
+private:
+	// Include the pieces autogenerated from the target description.
+	#include "LC3bGenDAGISel.inc"
+
+	bool isPoolOutOfRange() const;
+
+	SDNode *Select(SDNode *N);
+	SDNode *SelectLiteral(const Constant *C, EVT VT, DebugLoc DL);
+	SDNode *SelectConstant(SDNode *N);
+	SDNode *SelectGlobalAddress(SDNode *N);
+	SDNode *SelectPow2(SDNode *N);
+	SDNode *SelectShift(SDNode *N);
+
+	// Complex Pattern.
+	bool SelectAddr(SDNode *Parent, SDValue N, SDValue &Base, SDValue &Offset);
+	bool SelectSmallData(SDValue Addr, SDValue &Base, SDValue &Offset);
+};
+
+} // end anonymous namespace
+
+/// IRInstSize - Bytes of code an IR instruction is assumed to become, two
+/// LC-3b instructions.
+static const unsigned IRInstSize = 4;
+
+bool LC3bDAGToDAGISel::runOnMachineFunction(MachineFunction &MF) {
+	CodeAfter.clear();
+	const Function *F = MF.getFunction();
+	uint64_t Bytes = 0;
+	for (Function::const_iterator BB = F->end(), E = F->begin(); BB != E;) {
+		--BB;
+		Bytes += BB->size() * IRInstSize;
+		CodeAfter[&*BB] = Bytes;
+	}
+	return SelectionDAGISel::runOnMachineFunction(MF);
+}
+
+/// isPoolOutOfRange - Whether the constant pool may be past the reach of an
+/// LEA in the block being selected. LC3bLongBranch makes the final call, this
+/// only picks the cheaper way to build a constant.
+bool LC3bDAGToDAGISel::isPoolOutOfRange() const {
+	const BasicBlock *BB = FuncInfo->MBB->getBasicBlock();
+	return !isInt<9>(CodeAfter.lookup(BB) / 2);
+}
+
+/// isLegalMemOffset - LDW/STW scale offset6 by two, LDB/STB use it as a byte
+/// offset. Parent is the load or store the address belongs to.
+static bool isLegalMemOffset(SDNode *Parent, int64_t Offset) {
+	unsigned Size = 2;
+	if (const MemSDNode *Mem = dyn_cast_or_null<MemSDNode>(Parent))
+		Size = Mem->getMemoryVT().getStoreSize();
+	if (Size == 1)
+		return isInt<6>(Offset);
+	return (Offset & 1) == 0 && isInt<6>(Offset >> 1);
+}
+
+/// SelectSmallData - A global in the small data area, or a constant offset
+/// from one, is R5 plus sym@SDAREL, resolved by the linker.
+bool LC3bDAGToDAGISel::
+SelectSmallData(SDValue Addr, SDValue &Base, SDValue &Offset) {
+	int64_t Disp = 0;
+	if (CurDAG->isBaseWithConstantOffset(Addr)) {
+		Disp = cast<ConstantSDNode>(Addr.getOperand(1))->getSExtValue();
+		Addr = Addr.getOperand(0);
+	}
+
+	GlobalAddressSDNode *GA = dyn_cast<GlobalAddressSDNode>(Addr);
+	if (!GA)
+		return false;
+	const LC3bTargetObjectFile &TLOF = static_cast<const LC3bTargetObjectFile&>(
+		getTargetLowering().getObjFileLowering());
+	if (!TLOF.IsGlobalInSmallSection(GA->getGlobal(), TM))
+		return false;
+
+	EVT ValTy = Addr.getValueType();
+	Base = CurDAG->getRegister(LC3b::R5, ValTy);
+	Offset = CurDAG->getTargetGlobalAddress(GA->getGlobal(), Addr.getDebugLoc(),
+	                                        ValTy, GA->getOffset() + Disp,
+	                                        LC3bII::MO_SDAREL);
+	return true;
+}
+
+/// ComplexPattern used on LC3bInstrInfo.
+/// Used on LC3b Load/Store instructions
+bool LC3bDAGToDAGISel::
+SelectAddr(SDNode *Parent, SDValue Addr, SDValue &Base, SDValue &Offset) {
+	EVT ValTy = Addr.getValueType();
+
+	if (SelectSmallData(Addr, Base, Offset))
+		return true;
+
+	// if Address is FI, get the TargetFrameIndex.
+	if (FrameIndexSDNode *FIN = dyn_cast<FrameIndexSDNode>(Addr)) {
+		Base = CurDAG->getTargetFrameIndex(FIN->getIndex(), ValTy);
+		Offset = CurDAG->getTargetConstant(0, ValTy);
+		return true;
+	}
+
+	// Addresses of the form FI+const or Reg+const.
+	if (CurDAG->isBaseWithConstantOffset(Addr)) {
+		ConstantSDNode *CN = cast<ConstantSDNode>(Addr.getOperand(1));
+		if (isLegalMemOffset(Parent, CN->getSExtValue())) {
+			// If the first operand is a FI, get the TargetFI Node
+			if (FrameIndexSDNode *FIN =
+			        dyn_cast<FrameIndexSDNode>(Addr.getOperand(0)))
+				Base = CurDAG->getTargetFrameIndex(FIN->getIndex(), ValTy);
+			else
+				Base = Addr.getOperand(0);
+
+			Offset = CurDAG->getTargetConstant(CN->getZExtValue(), ValTy);
+			return true;
+		}
+	}
+
+	Base = Addr;
+	Offset = CurDAG->getTargetConstant(0, ValTy);
+	return true;
+}
+
+/// SelectLiteral - LEA of C in the function's constant pool and an LDW of it.
+SDNode *LC3bDAGToDAGISel::SelectLiteral(const Constant *C, EVT VT,
+                                        DebugLoc DL) {
+	// getConstantPoolIndex shares the entry between equal constants.
+	SDValue CP = CurDAG->getTargetConstantPool(C, VT, 2);
+	SDNode *Addr = CurDAG->getMachineNode(LC3b::LEA, DL, VT, CP);
+	MachineSDNode *Load =
+		CurDAG->getMachineNode(LC3b::LDW, DL, VT, MVT::Other, SDValue(Addr, 0),
+		                       CurDAG->getTargetConstant(0, VT),
+		                       CurDAG->getEntryNode());
+	MachineSDNode::mmo_iterator MemOp = MF->allocateMemRefsArray(1);
+	MemOp[0] = MF->getMachineMemOperand(MachinePointerInfo::getConstantPool(),
+	                                    MachineMemOperand::MOLoad, 2, 2);
+	Load->setMemRefs(MemOp, MemOp + 1);
+	return Load;
+}
+
+/// SelectConstant - Build a constant outside simm5 with the cheapest of an
+/// AND/ADD/XOR/LSHF sequence and a LEA+LDW from the function's constant pool,
+/// see LC3bInstrInfo::loadImmediate for the same choice after selection.
+SDNode *LC3bDAGToDAGISel::SelectConstant(SDNode *Node) {
+	const LC3bInstrInfo &TII =
+		*static_cast<const LC3bInstrInfo*>(TM.getInstrInfo());
+	int64_t Imm = cast<ConstantSDNode>(Node)->getSExtValue();
+	EVT VT = Node->getValueType(0);
+	DebugLoc DL = Node->getDebugLoc();
+	bool OptSize = MF->getFunction()->getAttributes().
+		hasAttribute(AttributeSet::FunctionIndex, Attribute::OptimizeForSize);
+
+	LC3bInstrInfo::ImmSequence Seq;
+	if (!TII.getImmSequence(Imm, Seq) ||
+	    TII.isConstantPoolCheaper(Seq, OptSize, isPoolOutOfRange())) {
+		DEBUG(errs() << "LC3b: constant " << Imm << " from the constant pool\n");
+		const Constant *C = ConstantInt::get(Type::getInt16Ty(*CurDAG->getContext()), Imm);
+		return SelectLiteral(C, VT, DL);
+	}
+
+	DEBUG(errs() << "LC3b: constant " << Imm << " in " << Seq.size()
+	             << " instructions\n");
+	// AND of an undefined register with #0 starts every sequence.
+	SDValue Res(CurDAG->getMachineNode(TargetOpcode::IMPLICIT_DEF, DL, VT), 0);
+	for (unsigned i = 0, e = Seq.size(); i != e; ++i)
+		Res = SDValue(CurDAG->getMachineNode(Seq[i].Opcode, DL, VT, Res,
+		                                     CurDAG->getTargetConstant(Seq[i].Imm, VT)),
+		              0);
+	return Res.getNode();
+}
+
+/// SelectGlobalAddress - The address of a global as a value. With
+/// -code-model=small every global is within PCoffset9 of the code and this
+/// is a LEA, otherwise the address is a literal in the function's constant
+/// pool. Loads and stores of small data never get here, see SelectSmallData.
+SDNode *LC3bDAGToDAGISel::SelectGlobalAddress(SDNode *Node) {
+	GlobalAddressSDNode *GA = cast<GlobalAddressSDNode>(Node);
+	const GlobalValue *GV = GA->getGlobal();
+	int64_t Offset = GA->getOffset();
+	EVT VT = Node->getValueType(0);
+	DebugLoc DL = Node->getDebugLoc();
+
+	if (TM.getCodeModel() == CodeModel::Small)
+		return CurDAG->SelectNodeTo(Node, LC3b::LEA, VT,
+		                            CurDAG->getTargetGlobalAddress(GV, DL, VT,
+		                                                           Offset));
+
+	DEBUG(errs() << "LC3b: address of " << GV->getName()
+	             << " from the constant pool\n");
+	const Constant *C = GV;
+	if (Offset) {
+		Type *Int16Ty = Type::getInt16Ty(*CurDAG->getContext());
+		Constant *Addr =
+			ConstantExpr::getPtrToInt(const_cast<GlobalValue*>(GV), Int16Ty);
+		C = ConstantExpr::getAdd(Addr, ConstantInt::get(Int16Ty, Offset));
+	}
+	return SelectLiteral(C, VT, DL);
+}
+
+/// SelectPow2 - 1 << x, which the bit test lowering of switch builds, as a
+/// load from a table of the sixteen powers of two in the constant pool. LC3b
+/// only shifts by constant amounts; x is in range after the bit test's range
+/// check.
+SDNode *LC3bDAGToDAGISel::SelectPow2(SDNode *Node) {
+	SDValue X = Node->getOperand(1);
+	EVT VT = Node->getValueType(0);
+	DebugLoc DL = Node->getDebugLoc();
+
+	uint16_t Pow2[16];
+	for (unsigned i = 0; i != 16; ++i)
+		Pow2[i] = 1 << i;
+	const Constant *C =
+		ConstantDataArray::get(*CurDAG->getContext(), ArrayRef<uint16_t>(Pow2));
+	SDValue CP = CurDAG->getTargetConstantPool(C, VT, 2);
+	SDNode *Table = CurDAG->getMachineNode(LC3b::LEA, DL, VT, CP);
+	SDNode *Offset = CurDAG->getMachineNode(LC3b::ADD, DL, VT, X, X);
+	SDNode *Addr = CurDAG->getMachineNode(LC3b::ADD, DL, VT, SDValue(Table, 0),
+	                                      SDValue(Offset, 0));
+	MachineSDNode *Load =
+		CurDAG->getMachineNode(LC3b::LDW, DL, VT, MVT::Other, SDValue(Addr, 0),
+		                       CurDAG->getTargetConstant(0, VT),
+		                       CurDAG->getEntryNode());
+	MachineSDNode::mmo_iterator MemOp = MF->allocateMemRefsArray(1);
+	MemOp[0] = MF->getMachineMemOperand(MachinePointerInfo::getConstantPool(),
+	                                    MachineMemOperand::MOLoad, 2, 2);
+	Load->setMemRefs(MemOp, MemOp + 1);
+	return Load;
+}
+
+/// SelectShift - A shift by a register amount, of an i16 or of the two
+/// halves of an i32 (SHL_PARTS and friends), as the SHIFT/SHIFT32 loop.
+SDNode *LC3bDAGToDAGISel::SelectShift(SDNode *Node) {
+	EVT VT = Node->getValueType(0);
+	unsigned Op;
+	switch (Node->getOpcode()) {
+	default: llvm_unreachable("Not a shift");
+	case ISD::SHL: case ISD::SHL_PARTS: Op = ISD::SHL; break;
+	case ISD::SRL: case ISD::SRL_PARTS: Op = ISD::SRL; break;
+	case ISD::SRA: case ISD::SRA_PARTS: Op = ISD::SRA; break;
+	}
+	SDValue OpV = CurDAG->getTargetConstant(Op, VT);
+
+	if (Node->getNumValues() == 1)
+		return CurDAG->SelectNodeTo(Node, LC3b::SHIFT, VT, Node->getOperand(0),
+		                            Node->getOperand(1), OpV);
+	SDValue Ops[] = { Node->getOperand(0), Node->getOperand(1),
+	                  Node->getOperand(2), OpV };
+	return CurDAG->SelectNodeTo(Node, LC3b::SHIFT32, VT, VT, Ops, 4);
+}
+
+/// Select instructions not customized! Used for
+/// expanded, promoted and normal instructions
+SDNode *LC3bDAGToDAGISel::Select(SDNode *Node) {
+	DEBUG(errs() << "Selecting: "; Node->dump(CurDAG); errs() << "\n");
+
+	// If we have a custom node, we already have selected!
+	if (Node->isMachineOpcode()) {
+		DEBUG(errs() << "== "; Node->dump(CurDAG); errs() << "\n");
+		return NULL;
+	}
+
+	// The address of a stack object is R6 + offset, the frame index is
+	// replaced by eliminateFrameIndex.
+	if (Node->getOpcode() == ISD::FrameIndex) {
+		int FI = cast<FrameIndexSDNode>(Node)->getIndex();
+		EVT VT = Node->getValueType(0);
+		SDValue TFI = CurDAG->getTargetFrameIndex(FI, VT);
+		return CurDAG->SelectNodeTo(Node, LC3b::ADDI, VT, TFI,
+		                            CurDAG->getTargetConstant(0, VT));
+	}
+
+	// The address of a jump table, see LC3bTargetLowering for the dispatch.
+	if (Node->getOpcode() == ISD::JumpTable) {
+		int JTI = cast<JumpTableSDNode>(Node)->getIndex();
+		EVT VT = Node->getValueType(0);
+		return CurDAG->SelectNodeTo(Node, LC3b::LEA, VT,
+		                            CurDAG->getTargetJumpTable(JTI, VT));
+	}
+
+	if (Node->getOpcode() == ISD::GlobalAddress)
+		return SelectGlobalAddress(Node);
+
+	switch (Node->getOpcode()) {
+	default: break;
+	case ISD::SHL:
+	case ISD::SRL:
+	case ISD::SRA: {
+		if (isa<ConstantSDNode>(Node->getOperand(1)))
+			break;
+		ConstantSDNode *One = dyn_cast<ConstantSDNode>(Node->getOperand(0));
+		if (Node->getOpcode() == ISD::SHL && One && One->getZExtValue() == 1)
+			return SelectPow2(Node);
+		return SelectShift(Node);
+	}
+	case ISD::SHL_PARTS:
+	case ISD::SRL_PARTS:
+	case ISD::SRA_PARTS:
+		return SelectShift(Node);
+	}
+
+	// simm5 constants are LI5, see LC3bInstrInfo.td.
+	if (Node->getOpcode() == ISD::Constant &&
+	    !isInt<5>(cast<ConstantSDNode>(Node)->getSExtValue()))
+		return SelectConstant(Node);
+
+	// Select the default instruction
+	SDNode *ResNode = SelectCode(Node);
+
+	DEBUG(errs() << "=> ");
+	if (ResNode == NULL || ResNode == Node)
+		DEBUG(Node->dump(CurDAG));
+	else
+		DEBUG(ResNode->dump(CurDAG));
+	DEBUG(errs() << "\n");
+	return ResNode;
+}
+
+/// createLC3bISelDag - This pass converts a legalized DAG into a
+/// LC3b-specific DAG, ready for instruction scheduling.
+FunctionPass *llvm::createLC3bISelDag(LC3bTargetMachine &TM,
+                                      CodeGenOpt::Level OptLevel) {
+	return new LC3bDAGToDAGISel(TM, OptLevel);
+}
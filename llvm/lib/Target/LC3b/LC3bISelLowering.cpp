@@ -7,14 +7,15 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file defines the interfaces that Cpu0 uses to lower LLVM code into a
+// This file defines the interfaces that LC3b uses to lower LLVM code into a
 // selection DAG.
 //
 //===----------------------------------------------------------------------===//
 #define DEBUG_TYPE "LC3b-lower"
 #include "LC3bISelLowering.h"
+#include "LC3bMachineFunction.h"
 #include "LC3bTargetMachine.h"
-#include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
+#include "LC3bTargetObjectFile.h"
 #include "LC3bSubtarget.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
@@ -30,23 +31,1232 @@
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/SelectionDAGISel.h"
 #include "llvm/CodeGen/ValueTypes.h"
+#include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
-LC3bTargetLowering:: LC3bTargetLowering(LC3bTargetMachine &TM) : TargetLowering(TM, new TargetLoweringObjectFileELF()), Subtarget(&TM.getSubtarget<LC3bSubtarget>()) {
+
+static cl::opt<unsigned>
+MulExpandLimit("lc3b-mul-expand-limit", cl::Hidden, cl::init(12),
+               cl::desc("Maximum number of LSHF/ADD instructions a multiply "
+                        "by a constant is expanded into"));
+
+LC3bTargetLowering:: LC3bTargetLowering(LC3bTargetMachine &TM) : TargetLowering(TM, new LC3bTargetObjectFile()), Subtarget(&TM.getSubtarget<LC3bSubtarget>()) {
+		// Set up the register classes.
+		addRegisterClass(MVT::i16, &LC3b::LC3bRegsRegClass);
+
+		// Compute derived properties from the register classes
+		computeRegisterProperties();
+
+		// LC3b has no multiply or divide. Multiplies by a constant are
+		// expanded in LowerMUL, everything else calls the helpers in
+		// Runtime/ (__mulhi3, __divhi3, __udivhi3, __modhi3, __umodhi3).
+		setOperationAction(ISD::MUL,       MVT::i16, Custom);
+		setOperationAction(ISD::MULHS,     MVT::i16, Expand);
+		setOperationAction(ISD::MULHU,     MVT::i16, Expand);
+		setOperationAction(ISD::SMUL_LOHI, MVT::i16, Expand);
+		setOperationAction(ISD::UMUL_LOHI, MVT::i16, Expand);
+		setOperationAction(ISD::SDIV,      MVT::i16, Expand);
+		setOperationAction(ISD::UDIV,      MVT::i16, Expand);
+		setOperationAction(ISD::SREM,      MVT::i16, Expand);
+		setOperationAction(ISD::UREM,      MVT::i16, Expand);
+		setOperationAction(ISD::SDIVREM,   MVT::i16, Expand);
+		setOperationAction(ISD::UDIVREM,   MVT::i16, Expand);
+
+		// Compares only exist as the n/z/p flags of the value being branched
+		// on, see EmitNZP. SETCC and SELECT become SELECT_CC, BRCOND becomes
+		// BR_CC.
+		setOperationAction(ISD::BR_CC,     MVT::i16, Custom);
+		setOperationAction(ISD::BRCOND,    MVT::Other, Expand);
+		setOperationAction(ISD::SELECT_CC, MVT::i16, Custom);
+		setOperationAction(ISD::SELECT,    MVT::i16, Expand);
+		setOperationAction(ISD::SETCC,     MVT::i16, Expand);
+
+		// i32 lives in register pairs. ADD/SUB compute the carry from the
+		// sign bits instead of with an unsigned compare, and branches
+		// decide on the high words before looking at the low ones.
+		setOperationAction(ISD::ADD,       MVT::i32, Custom);
+		setOperationAction(ISD::SUB,       MVT::i32, Custom);
+		setOperationAction(ISD::BR_CC,     MVT::i32, Custom);
+
+		// LSHF/RSHFL/RSHFA shift by a constant. Shifts by a register, of an
+		// i16 or of the halves of an i32, are loops selected by SelectShift,
+		// so the *_PARTS nodes are Legal.
+		setOperationAction(ISD::SHL_PARTS, MVT::i16, Legal);
+		setOperationAction(ISD::SRL_PARTS, MVT::i16, Legal);
+		setOperationAction(ISD::SRA_PARTS, MVT::i16, Legal);
+
+		// Bytes are LDB/STB. LDB sign extends, so a zero extending load is
+		// an LDB and an AND with 0xff that the combiner drops when the high
+		// byte is never read, as for bytes copied with STB.
+		setLoadExtAction(ISD::EXTLOAD,  MVT::i1, Promote);
+		setLoadExtAction(ISD::ZEXTLOAD, MVT::i1, Promote);
+		setLoadExtAction(ISD::SEXTLOAD, MVT::i1, Promote);
+		setLoadExtAction(ISD::ZEXTLOAD, MVT::i8, Expand);
+
+		// No rotates, and sign extending a register is a LSHF/RSHFA pair.
+		setOperationAction(ISD::ROTL,      MVT::i16, Expand);
+		setOperationAction(ISD::ROTR,      MVT::i16, Expand);
+		setOperationAction(ISD::SIGN_EXTEND_INREG, MVT::i8, Expand);
+		setOperationAction(ISD::SIGN_EXTEND_INREG, MVT::i1, Expand);
+
+		// Byte updates of packed i16 words become STB, and branches on i32
+		// compares BR_CC, see PerformDAGCombine.
+		setTargetDAGCombine(ISD::STORE);
+		setTargetDAGCombine(ISD::BRCOND);
+
+		// A copied word is an LDW/STW pair, two instructions, against six per
+		// word in the MEMCPY loop of LC3bSelectionDAGInfo. Unroll up to eight.
+		MaxStoresPerMemcpy = MaxStoresPerMemset = 8;
+		MaxStoresPerMemcpyOptSize = MaxStoresPerMemsetOptSize = 4;
+
+		// Switches. A jump table is LEA, ADD, ADD, LDW and JMP after the range
+		// check, its entries are data words, see LC3bDAGToDAGISel::Select.
+		// Bit tests find 1 << x in a table too (SelectPow2), since SHL has to
+		// stay Legal for them.
+		setOperationAction(ISD::BR_JT,     MVT::Other, Expand);
+		setJumpTableLimits();
+
+		setStackPointerRegisterToSaveRestore(LC3b::R6);
+		setBooleanContents(ZeroOrOneBooleanContent);
+		setMinFunctionAlignment(1);
+}
+
+const char *LC3bTargetLowering::getTargetNodeName(unsigned Opcode) const {
+		switch (Opcode) {
+		case LC3bISD::Ret:		return "LC3bISD::Ret";
+		case LC3bISD::JmpLink:	return "LC3bISD::JmpLink";
+		case LC3bISD::BR_CC:	return "LC3bISD::BR_CC";
+		case LC3bISD::BR_CC32:	return "LC3bISD::BR_CC32";
+		case LC3bISD::SELECT_CC:	return "LC3bISD::SELECT_CC";
+		case LC3bISD::MEMCPY:	return "LC3bISD::MEMCPY";
+		case LC3bISD::MEMSET:	return "LC3bISD::MEMSET";
+		default:				return NULL;
+		}
+}
+
+SDValue LC3bTargetLowering::LowerOperation(SDValue Op, SelectionDAG &DAG) const {
+		switch (Op.getOpcode()) {
+		case ISD::MUL:	return LowerMUL(Op, DAG);
+		case ISD::BR_CC:	return LowerBR_CC(Op, DAG);
+		case ISD::SELECT_CC:	return LowerSELECT_CC(Op, DAG);
+		default:
+				llvm_unreachable("unimplemented operand");
+		}
+}
+
+/// ReplaceNodeResults - i32 ADD and SUB. Without a carry flag the generic
+/// expansion finds the carry with an unsigned compare of the low words, a
+/// dozen instructions and a branch here. The carry out of bit 15 is the
+/// sign of
+///   a + b: (a & b) | ((a ^ b) & ~sum)
+///   a - b: (~a & b) | (~(a ^ b) & diff)
+/// whose two halves never share a bit, so the OR is an XOR. RSHFL #15 turns
+/// the sign into the 0 or 1 added to (subtracted from) the high words, and
+/// with a constant operand the combiner reduces it to two or three ALU
+/// operations.
+void LC3bTargetLowering::ReplaceNodeResults(SDNode *N,
+                                            SmallVectorImpl<SDValue> &Results,
+                                            SelectionDAG &DAG) const {
+		assert((N->getOpcode() == ISD::ADD || N->getOpcode() == ISD::SUB) &&
+		       N->getValueType(0) == MVT::i32 && "Unexpected node to replace");
+		DebugLoc dl = N->getDebugLoc();
+		EVT VT = MVT::i16;
+		bool IsAdd = N->getOpcode() == ISD::ADD;
+		SDValue Lo = DAG.getIntPtrConstant(0), Hi = DAG.getIntPtrConstant(1);
+		SDValue ALo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, N->getOperand(0), Lo);
+		SDValue AHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, N->getOperand(0), Hi);
+		SDValue BLo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, N->getOperand(1), Lo);
+		SDValue BHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, N->getOperand(1), Hi);
+		SDValue AllOnes = DAG.getConstant(-1, VT);
+
+		SDValue ResLo = DAG.getNode(N->getOpcode(), dl, VT, ALo, BLo);
+		SDValue Gen, Prop;
+		if (IsAdd) {
+				Gen = DAG.getNode(ISD::AND, dl, VT, ALo, BLo);
+				Prop = DAG.getNode(ISD::AND, dl, VT,
+				                   DAG.getNode(ISD::XOR, dl, VT, ALo, BLo),
+				                   DAG.getNode(ISD::XOR, dl, VT, ResLo, AllOnes));
+		} else {
+				Gen = DAG.getNode(ISD::AND, dl, VT,
+				                  DAG.getNode(ISD::XOR, dl, VT, ALo, AllOnes), BLo);
+				Prop = DAG.getNode(ISD::AND, dl, VT,
+				                   DAG.getNode(ISD::XOR, dl, VT,
+				                               DAG.getNode(ISD::XOR, dl, VT, ALo, BLo),
+				                               AllOnes),
+				                   ResLo);
+		}
+		SDValue Carry = DAG.getNode(ISD::SRL, dl, VT,
+		                            DAG.getNode(ISD::XOR, dl, VT, Gen, Prop),
+		                            DAG.getConstant(15, MVT::i16));
+		SDValue ResHi = DAG.getNode(N->getOpcode(), dl, VT,
+		                            DAG.getNode(N->getOpcode(), dl, VT, AHi, BHi),
+		                            Carry);
+		Results.push_back(DAG.getNode(ISD::BUILD_PAIR, dl, MVT::i32, ResLo, ResHi));
+}
+
+/// PerformSTORECombine - Turn the read-modify-write of one byte of a word
+///   (store (or (and (load p), 0xff00), x), p), x & 0xff00 known zero
+/// into (truncstore x, p) and likewise for the high byte, which is what C
+/// code working on two characters packed per word does. One STB replaces
+/// the LDW, the masking AND, the OR and the STW.
+static SDValue PerformSTORECombine(SDNode *N, SelectionDAG &DAG,
+                                   const DataLayout *DL) {
+	StoreSDNode *ST = cast<StoreSDNode>(N);
+	SDValue Val = ST->getValue();
+	if (ST->isTruncatingStore() || !ST->isUnindexed() || ST->isVolatile() ||
+	    Val.getValueType() != MVT::i16 || Val.getOpcode() != ISD::OR ||
+	    !Val.hasOneUse())
+		return SDValue();
+
+	for (unsigned i = 0; i != 2; ++i) {
+		SDValue Masked = Val.getOperand(i), Byte = Val.getOperand(1 - i);
+		if (Masked.getOpcode() != ISD::AND || !Masked.hasOneUse())
+			continue;
+		ConstantSDNode *Mask = dyn_cast<ConstantSDNode>(Masked.getOperand(1));
+		LoadSDNode *LD = dyn_cast<LoadSDNode>(Masked.getOperand(0));
+		if (!Mask || !LD || !ISD::isNormalLoad(LD) || LD->isVolatile() ||
+		    !Masked.getOperand(0).hasOneUse() ||
+		    LD->getBasePtr() != ST->getBasePtr() ||
+		    ST->getChain() != SDValue(LD, 1))
+			continue;
+
+		// Which byte of the word is replaced, 0 is the low one.
+		unsigned Half;
+		if (Mask->getZExtValue() == 0xff00)
+			Half = 0;
+		else if (Mask->getZExtValue() == 0x00ff)
+			Half = 1;
+		else
+			continue;
+		if (!DAG.MaskedValueIsZero(Byte, APInt(16, Half ? 0x00ff : 0xff00)))
+			continue;
+
+		DebugLoc dl = N->getDebugLoc();
+		if (Half)
+			Byte = DAG.getNode(ISD::SRL, dl, MVT::i16, Byte,
+			                   DAG.getConstant(8, MVT::i16));
+		unsigned Offset = DL->isLittleEndian() ? Half : 1 - Half;
+		SDValue Ptr = ST->getBasePtr();
+		if (Offset)
+			Ptr = DAG.getNode(ISD::ADD, dl, Ptr.getValueType(), Ptr,
+			                  DAG.getConstant(Offset, Ptr.getValueType()));
+		return DAG.getTruncStore(LD->getChain(), dl, Byte, Ptr,
+		                         ST->getPointerInfo().getWithOffset(Offset),
+		                         MVT::i8, false, ST->isNonTemporal(),
+		                         Offset ? 1 : ST->getAlignment());
+	}
+	return SDValue();
+}
+
+/// PerformBRCONDCombine - The combiner only folds a SETCC into BR_CC for a
+/// legal compare type. An i32 compare would be expanded into both word
+/// compares and a select, so form the BR_CC here and let LowerBR_CC32 split
+/// it when the type is legalized.
+static SDValue PerformBRCONDCombine(SDNode *N, SelectionDAG &DAG) {
+	SDValue Cond = N->getOperand(1);
+	if (Cond.getOpcode() != ISD::SETCC ||
+	    Cond.getOperand(0).getValueType() != MVT::i32)
+		return SDValue();
+	return DAG.getNode(ISD::BR_CC, N->getDebugLoc(), MVT::Other,
+	                   N->getOperand(0), Cond.getOperand(2),
+	                   Cond.getOperand(0), Cond.getOperand(1), N->getOperand(2));
+}
+
+SDValue LC3bTargetLowering::PerformDAGCombine(SDNode *N,
+                                              DAGCombinerInfo &DCI) const {
+		switch (N->getOpcode()) {
+		case ISD::STORE:
+				return PerformSTORECombine(N, DCI.DAG, getDataLayout());
+		case ISD::BRCOND:
+				return PerformBRCONDCombine(N, DCI.DAG);
+		default:
+				return SDValue();
+		}
+}
+
+//===----------------------------------------------------------------------===//
+//  Addressing modes and immediates, for CodeGenPrepare and, through
+//  BasicTTI, LoopStrengthReduce
+//===----------------------------------------------------------------------===//
+
+bool LC3bTargetLowering::isLegalAddImmediate(int64_t Imm) const {
+		return isInt<5>(Imm);
+}
+
+/// isLegalICmpImmediate - A compare with zero only needs the flags of the
+/// value, an equality compare with another constant is an ADD of its
+/// negation, see EmitNZP.
+bool LC3bTargetLowering::isLegalICmpImmediate(int64_t Imm) const {
+		return Imm == 0 || isInt<5>(-Imm);
 }
+
+/// isLegalAddressingMode - LDB/STB take a base register plus a simm6 byte
+/// offset, LDW/STW a simm6 word offset. There is no reg+reg or scaled index
+/// and no absolute address; every word of an i32 must be in reach. A bare
+/// base register is always legal, aggregates larger than the offset range
+/// are split with their own address arithmetic.
+bool LC3bTargetLowering::isLegalAddressingMode(const AddrMode &AM,
+                                               Type *Ty) const {
+		if (AM.BaseGV)
+				return false;
+
+		switch (AM.Scale) {
+		case 0:
+				break;
+		case 1:
+				if (!AM.HasBaseReg)
+						break;
+				return false;
+		default:
+				return false;
+		}
+
+		if (!AM.BaseOffs)
+				return true;
+
+		uint64_t Size = Ty->isSized() ? getDataLayout()->getTypeStoreSize(Ty) : 2;
+		if (Size == 1)
+				return isInt<6>(AM.BaseOffs);
+		int64_t Last = AM.BaseOffs + (int64_t)Size - 2;
+		return (AM.BaseOffs & 1) == 0 && isInt<6>(AM.BaseOffs >> 1) &&
+		       isInt<6>(Last >> 1);
+}
+
+/// isTruncateFree - An i32 truncates to its low word, and narrower values
+/// live in whole registers anyway.
+bool LC3bTargetLowering::isTruncateFree(Type *Ty1, Type *Ty2) const {
+		if (!Ty1->isIntegerTy() || !Ty2->isIntegerTy())
+				return false;
+		unsigned Bits1 = Ty1->getPrimitiveSizeInBits();
+		return Bits1 <= 32 && Ty2->getPrimitiveSizeInBits() < Bits1;
+}
+
+bool LC3bTargetLowering::isTruncateFree(EVT VT1, EVT VT2) const {
+		if (!VT1.isInteger() || !VT2.isInteger())
+				return false;
+		unsigned Bits1 = VT1.getSizeInBits();
+		return Bits1 <= 32 && VT2.getSizeInBits() < Bits1;
+}
+
+//===----------------------------------------------------------------------===//
+//  Lower helper functions
+//===----------------------------------------------------------------------===//
+
+/// getInstrLatency - Cycles of Opcode according to LC3bGenericItineraries.
+unsigned LC3bTargetLowering::getInstrLatency(unsigned Opcode) const {
+		const InstrItineraryData *Itins = getTargetMachine().getInstrItineraryData();
+		if (!Itins || Itins->isEmpty())
+				return 1;
+		const TargetInstrInfo *TII = getTargetMachine().getInstrInfo();
+		return Itins->getStageLatency(TII->get(Opcode).getSchedClass());
+}
+
+/// getMulCallLatency - __mulhi3 runs one AND/ADD/LSHF/RSHFL/BR round per
+/// multiplier bit; assume half of the 16 rounds on average, plus the JSR and
+/// RET.
+unsigned LC3bTargetLowering::getMulCallLatency() const {
+		unsigned AluLat = getInstrLatency(LC3b::ADD);
+		unsigned ShfLat = getInstrLatency(LC3b::LSHF);
+		unsigned BrLat = getInstrLatency(LC3b::JSR);
+		return 2 * BrLat + 8 * (2 * AluLat + ShfLat + BrLat);
+}
+
+/// getDivCallLatency - __udivhi3 and __divhi3 always run the 16 rounds of a
+/// restoring division, two LSHF, four ADD and three BR each.
+unsigned LC3bTargetLowering::getDivCallLatency() const {
+		unsigned AluLat = getInstrLatency(LC3b::ADD);
+		unsigned ShfLat = getInstrLatency(LC3b::LSHF);
+		unsigned BrLat = getInstrLatency(LC3b::JSR);
+		return 2 * BrLat + 16 * (4 * AluLat + 2 * ShfLat + 3 * BrLat);
+}
+
+/// setJumpTableLimits - Weigh a jump table against the binary search
+/// SelectionDAGBuilder emits otherwise, with the itinerary latencies. A step
+/// of the search is an ordered compare, which takes four ALU operations and a
+/// SUB without a carry flag (see EmitNZP), and a BR. The table costs one
+/// word per value in its range and a fixed dispatch, it is used from the
+/// number of cases where the search would be slower, and while every case
+/// saves at least the words of its search step.
+void LC3bTargetLowering::setJumpTableLimits() {
+		unsigned AluLat = getInstrLatency(LC3b::ADD);
+		unsigned BrLat = getInstrLatency(LC3b::BRnzp);
+		unsigned StepCycles = 6 * AluLat + BrLat;
+		unsigned DispatchCycles = 3 * AluLat + getInstrLatency(LC3b::LEA) +
+		                          getInstrLatency(LC3b::LDW) +
+		                          getInstrLatency(LC3b::JMP);
+
+		// The search visits log2(N) steps.
+		unsigned Entries = 2;
+		while (Log2_32(Entries) * StepCycles < DispatchCycles)
+				Entries *= 2;
+		setMinimumJumpTableEntries(std::max(Entries, 3U));
+
+		// A step is 8 words (with the leaf's compare against its value).
+		const unsigned StepWords = 8;
+		setMinimumJumpTableDensity(100 / StepWords);
+}
+
+namespace {
+		/// MulSequence - x * C written as a sum of x << Shift terms, the negative
+		/// terms are summed separately and subtracted once at the end.
+		struct MulSequence {
+				SmallVector<std::pair<unsigned, bool>, 16> Terms;	// (Shift, Negative)
+				bool NegateResult;
+				unsigned NumShifts, NumAlu;
+
+				MulSequence() : NegateResult(false), NumShifts(0), NumAlu(0) {}
+
+				void addTerm(unsigned Shift, bool Negative) {
+						Terms.push_back(std::make_pair(Shift, Negative));
+				}
+
+				/// finish - Count the instructions: one LSHF per shifted term, one ADD
+				/// to combine each term, and XOR #-1/ADD #1 for every negation.
+				void finish() {
+						unsigned NumPos = 0, NumNeg = 0;
+						for (unsigned i = 0, e = Terms.size(); i != e; ++i) {
+								if (Terms[i].first)
+										++NumShifts;
+								++(Terms[i].second ? NumNeg : NumPos);
+						}
+						NumAlu = (NumPos ? NumPos - 1 : 0) + (NumNeg ? NumNeg - 1 : 0);
+						if (NumNeg)
+								NumAlu += NumPos ? 3 : 2;	// negate, then add to the positive sum
+						if (NegateResult)
+								NumAlu += 2;
+				}
+
+				unsigned getNumInstrs() const { return NumShifts + NumAlu; }
+		};
+}
+
+/// getBinaryMulSequence - One term per set bit of C.
+static MulSequence getBinaryMulSequence(uint16_t C, bool Negate) {
+		MulSequence S;
+		S.NegateResult = Negate;
+		for (unsigned Bit = 0; Bit != 16; ++Bit)
+				if (C & (1u << Bit))
+						S.addTerm(Bit, false);
+		S.finish();
+		return S;
+}
+
+/// getNAFMulSequence - Terms from the non-adjacent form of C, which turns runs
+/// of ones into a single add and subtract (x * 15 = (x << 4) - x).
+static MulSequence getNAFMulSequence(uint16_t C, bool Negate) {
+		MulSequence S;
+		S.NegateResult = Negate;
+		uint32_t V = C;
+		for (unsigned Bit = 0; V && Bit != 16; ++Bit, V >>= 1) {
+				if (!(V & 1))
+						continue;
+				if (V & 2) {
+						// ...11 -> subtract here and carry into the next bit.
+						S.addTerm(Bit, true);
+						V += 1;
+				} else {
+						S.addTerm(Bit, false);
+						V -= 1;
+				}
+		}
+		S.finish();
+		return S;
+}
+
+/// LowerMUL - A multiply by a constant becomes the cheapest LSHF/ADD sequence
+/// under the itinerary latencies, as long as it beats calling __mulhi3. The
+/// other multiplies are left to the default expansion into a libcall.
+SDValue LC3bTargetLowering::LowerMUL(SDValue Op, SelectionDAG &DAG) const {
+		ConstantSDNode *CN = dyn_cast<ConstantSDNode>(Op.getOperand(1));
+		if (!CN)
+				return SDValue();
+
+		EVT VT = Op.getValueType();
+		DebugLoc dl = Op.getDebugLoc();
+		SDValue X = Op.getOperand(0);
+		uint16_t C = CN->getZExtValue();
+
+		if (C == 0)
+				return DAG.getConstant(0, VT);
+
+		unsigned AluLat = getInstrLatency(LC3b::ADD);
+		unsigned ShfLat = getInstrLatency(LC3b::LSHF);
+
+		// Candidates for C and for -C followed by a negation.
+		MulSequence Candidates[] = {
+				getBinaryMulSequence(C, false),
+				getNAFMulSequence(C, false),
+				getBinaryMulSequence(-C, true),
+				getNAFMulSequence(-C, true)
+		};
+		const MulSequence *Best = 0;
+		unsigned BestCycles = ~0U;
+		for (unsigned i = 0; i != array_lengthof(Candidates); ++i) {
+				unsigned Cycles = Candidates[i].NumShifts * ShfLat + Candidates[i].NumAlu * AluLat;
+				if (Cycles < BestCycles) {
+						Best = &Candidates[i];
+						BestCycles = Cycles;
+				}
+		}
+
+		unsigned LibCallCycles = getMulCallLatency();
+		unsigned Limit = MulExpandLimit;
+		// At -Os only expand when it is no bigger than setting up the call.
+		if (DAG.getMachineFunction().getFunction()->getAttributes().
+		      hasAttribute(AttributeSet::FunctionIndex, Attribute::OptimizeForSize))
+				Limit = std::min(Limit, 3U);
+		if (BestCycles >= LibCallCycles || Best->getNumInstrs() > Limit)
+				return SDValue();
+
+		DEBUG(dbgs() << "LC3b: mul by " << C << " as " << Best->getNumInstrs()
+		             << " instructions, " << BestCycles << " cycles\n");
+
+		EVT ShiftTy = getShiftAmountTy(VT);
+		SDValue Pos, Neg;
+		for (unsigned i = 0, e = Best->Terms.size(); i != e; ++i) {
+				unsigned Shift = Best->Terms[i].first;
+				SDValue T = Shift ? DAG.getNode(ISD::SHL, dl, VT, X, DAG.getConstant(Shift, ShiftTy)) : X;
+				SDValue &Sum = Best->Terms[i].second ? Neg : Pos;
+				Sum = Sum.getNode() ? DAG.getNode(ISD::ADD, dl, VT, Sum, T) : T;
+		}
+
+		SDValue Res = Pos;
+		if (Neg.getNode())
+				Res = DAG.getNode(ISD::SUB, dl, VT, Pos.getNode() ? Pos : DAG.getConstant(0, VT), Neg);
+		if (Best->NegateResult)
+				Res = DAG.getNode(ISD::SUB, dl, VT, DAG.getConstant(0, VT), Res);
+		return Res;
+}
+
+/// EmitNZP - Reduce LHS CC RHS to a value whose n/z/p flags answer it, and
+/// the BR mask to test them with. LC3b has no compare and no carry or
+/// overflow flag: compares against zero test the value itself, (in)equality
+/// tests LHS - RHS, and ordered compares test the sign of
+///   (a - b) ^ ((a ^ b) & ((a - b) ^ a))
+/// which is a < b even when a - b overflows (Hacker's Delight 2-12).
+/// Unsigned compares flip both sign bits first.
+static SDValue EmitNZP(SDValue LHS, SDValue RHS, ISD::CondCode CC,
+                       unsigned &NZP, DebugLoc dl, SelectionDAG &DAG) {
+		EVT VT = LHS.getValueType();
+
+		// Keep a constant on the right.
+		if (isa<ConstantSDNode>(LHS) && !isa<ConstantSDNode>(RHS)) {
+				std::swap(LHS, RHS);
+				CC = ISD::getSetCCSwappedOperands(CC);
+		}
+
+		// x < 1 is x <= 0 and x > -1 is x >= 0.
+		if (ConstantSDNode *C = dyn_cast<ConstantSDNode>(RHS)) {
+				int64_t Imm = C->getSExtValue();
+				if ((Imm == 1 && (CC == ISD::SETLT || CC == ISD::SETGE)) ||
+				    (Imm == -1 && (CC == ISD::SETGT || CC == ISD::SETLE))) {
+						RHS = DAG.getConstant(0, VT);
+						CC = Imm == 1 ? (CC == ISD::SETLT ? ISD::SETLE : ISD::SETGT)
+						              : (CC == ISD::SETGT ? ISD::SETGE : ISD::SETLT);
+				}
+		}
+
+		ConstantSDNode *RC = dyn_cast<ConstantSDNode>(RHS);
+		if (RC && RC->isNullValue()) {
+				switch (CC) {
+				default: break;
+				case ISD::SETEQ:
+				case ISD::SETULE: NZP = LC3bCC::COND_Z;  return LHS;
+				case ISD::SETNE:
+				case ISD::SETUGT: NZP = LC3bCC::COND_NP; return LHS;
+				case ISD::SETLT:  NZP = LC3bCC::COND_N;  return LHS;
+				case ISD::SETLE:  NZP = LC3bCC::COND_NZ; return LHS;
+				case ISD::SETGT:  NZP = LC3bCC::COND_P;  return LHS;
+				case ISD::SETGE:  NZP = LC3bCC::COND_ZP; return LHS;
+				}
+		}
+
+		switch (CC) {
+		default: llvm_unreachable("Invalid integer condition!");
+		case ISD::SETEQ:
+				NZP = LC3bCC::COND_Z;
+				return DAG.getNode(ISD::SUB, dl, VT, LHS, RHS);
+		case ISD::SETNE:
+				NZP = LC3bCC::COND_NP;
+				return DAG.getNode(ISD::SUB, dl, VT, LHS, RHS);
+		case ISD::SETULT:
+		case ISD::SETULE:
+		case ISD::SETUGT:
+		case ISD::SETUGE: {
+				SDValue SignBit = DAG.getConstant(0x8000, VT);
+				LHS = DAG.getNode(ISD::XOR, dl, VT, LHS, SignBit);
+				RHS = DAG.getNode(ISD::XOR, dl, VT, RHS, SignBit);
+				CC = CC == ISD::SETULT ? ISD::SETLT :
+				     CC == ISD::SETULE ? ISD::SETLE :
+				     CC == ISD::SETUGT ? ISD::SETGT : ISD::SETGE;
+				break;
+		}
+		case ISD::SETLT:
+		case ISD::SETLE:
+		case ISD::SETGT:
+		case ISD::SETGE:
+				break;
+		}
+
+		// a > b is b < a, a <= b is !(b < a).
+		if (CC == ISD::SETGT || CC == ISD::SETLE)
+				std::swap(LHS, RHS);
+		NZP = (CC == ISD::SETLT || CC == ISD::SETGT) ? LC3bCC::COND_N
+		                                               : LC3bCC::COND_ZP;
+
+		SDValue Diff = DAG.getNode(ISD::SUB, dl, VT, LHS, RHS);
+		SDValue Ovf = DAG.getNode(ISD::AND, dl, VT,
+		                          DAG.getNode(ISD::XOR, dl, VT, LHS, RHS),
+		                          DAG.getNode(ISD::XOR, dl, VT, Diff, LHS));
+		return DAG.getNode(ISD::XOR, dl, VT, Diff, Ovf);
+}
+
+SDValue LC3bTargetLowering::LowerBR_CC(SDValue Op, SelectionDAG &DAG) const {
+		SDValue Chain = Op.getOperand(0);
+		ISD::CondCode CC = cast<CondCodeSDNode>(Op.getOperand(1))->get();
+		SDValue LHS = Op.getOperand(2);
+		SDValue RHS = Op.getOperand(3);
+		SDValue Dest = Op.getOperand(4);
+		DebugLoc dl = Op.getDebugLoc();
+
+		if (LHS.getValueType() == MVT::i32)
+				return LowerBR_CC32(Op, DAG);
+
+		unsigned NZP;
+		SDValue Val = EmitNZP(LHS, RHS, CC, NZP, dl, DAG);
+		return DAG.getNode(LC3bISD::BR_CC, dl, MVT::Other, Chain, Dest, Val,
+		                   DAG.getTargetConstant(NZP, MVT::i16));
+}
+
+/// LowerBR_CC32 - Branch on an i32 compare, deciding on the high words
+/// first:
+///   a < b:  branch if hi(a) < hi(b), fall through if hi(a) != hi(b), branch
+///           if lo(a) <u lo(b)
+///   a == b: fall through if hi(a) != hi(b), branch if lo(a) == lo(b)
+///   a != b: branch if hi(a) != hi(b), branch if lo(a) != lo(b)
+/// The generic expansion computes both word compares and selects between
+/// them. A sign test (a < 0, a >= 0) only looks at the high word.
+SDValue LC3bTargetLowering::LowerBR_CC32(SDValue Op, SelectionDAG &DAG) const {
+		SDValue Chain = Op.getOperand(0);
+		ISD::CondCode CC = cast<CondCodeSDNode>(Op.getOperand(1))->get();
+		SDValue LHS = Op.getOperand(2);
+		SDValue RHS = Op.getOperand(3);
+		SDValue Dest = Op.getOperand(4);
+		DebugLoc dl = Op.getDebugLoc();
+		EVT VT = MVT::i16;
+
+		SDValue Lo = DAG.getIntPtrConstant(0), Hi = DAG.getIntPtrConstant(1);
+		SDValue LHSLo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, LHS, Lo);
+		SDValue LHSHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, LHS, Hi);
+		SDValue RHSLo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, RHS, Lo);
+		SDValue RHSHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, VT, RHS, Hi);
+
+		unsigned NZP;
+		ConstantSDNode *RC = dyn_cast<ConstantSDNode>(RHS);
+		// The combiner turns a >= 0 into a > -1.
+		if (RC && RC->isAllOnesValue() && (CC == ISD::SETGT || CC == ISD::SETLE)) {
+				CC = CC == ISD::SETGT ? ISD::SETGE : ISD::SETLT;
+				RHSHi = DAG.getConstant(0, VT);
+		} else if (!RC || !RC->isNullValue())
+				RC = 0;
+		if (RC && (CC == ISD::SETLT || CC == ISD::SETGE)) {
+				SDValue Val = EmitNZP(LHSHi, RHSHi, CC, NZP, dl, DAG);
+				return DAG.getNode(LC3bISD::BR_CC, dl, MVT::Other, Chain, Dest, Val,
+				                   DAG.getTargetConstant(NZP, VT));
+		}
+
+		// The high word test, strict for ordered compares.
+		SDValue HiVal, NeVal;
+		unsigned HiNZP = 0, NeNZP = 0;
+		ISD::CondCode HiCC = CC, LoCC = CC;
+		switch (CC) {
+		default: llvm_unreachable("Invalid integer condition!");
+		case ISD::SETEQ:
+				NeVal = EmitNZP(LHSHi, RHSHi, ISD::SETNE, NeNZP, dl, DAG);
+				break;
+		case ISD::SETNE:
+				HiVal = EmitNZP(LHSHi, RHSHi, ISD::SETNE, HiNZP, dl, DAG);
+				break;
+		case ISD::SETLT: case ISD::SETLE: HiCC = ISD::SETLT; break;
+		case ISD::SETGT: case ISD::SETGE: HiCC = ISD::SETGT; break;
+		case ISD::SETULT: case ISD::SETULE: HiCC = ISD::SETULT; break;
+		case ISD::SETUGT: case ISD::SETUGE: HiCC = ISD::SETUGT; break;
+		}
+		if (CC != ISD::SETEQ && CC != ISD::SETNE) {
+				HiVal = EmitNZP(LHSHi, RHSHi, HiCC, HiNZP, dl, DAG);
+				NeVal = EmitNZP(LHSHi, RHSHi, ISD::SETNE, NeNZP, dl, DAG);
+				// The low words compare unsigned.
+				if (ISD::isSignedIntSetCC(CC))
+						LoCC = CC == ISD::SETLT ? ISD::SETULT : CC == ISD::SETLE ? ISD::SETULE :
+						       CC == ISD::SETGT ? ISD::SETUGT : ISD::SETUGE;
+		}
+		unsigned LoNZP;
+		SDValue LoVal = EmitNZP(LHSLo, RHSLo, LoCC, LoNZP, dl, DAG);
+
+		// Unused tests keep a zero mask and repeat a register.
+		if (!HiVal.getNode())
+				HiVal = LoVal;
+		if (!NeVal.getNode())
+				NeVal = LoVal;
+		SDValue Ops[] = { Chain, Dest, HiVal, DAG.getTargetConstant(HiNZP, VT),
+		                  NeVal, DAG.getTargetConstant(NeNZP, VT),
+		                  LoVal, DAG.getTargetConstant(LoNZP, VT) };
+		return DAG.getNode(LC3bISD::BR_CC32, dl, MVT::Other, Ops, 8);
+}
+
+SDValue LC3bTargetLowering::LowerSELECT_CC(SDValue Op, SelectionDAG &DAG) const {
+		SDValue LHS = Op.getOperand(0);
+		SDValue RHS = Op.getOperand(1);
+		SDValue TrueV = Op.getOperand(2);
+		SDValue FalseV = Op.getOperand(3);
+		ISD::CondCode CC = cast<CondCodeSDNode>(Op.getOperand(4))->get();
+		DebugLoc dl = Op.getDebugLoc();
+
+		unsigned NZP;
+		SDValue Val = EmitNZP(LHS, RHS, CC, NZP, dl, DAG);
+		return DAG.getNode(LC3bISD::SELECT_CC, dl, Op.getValueType(), TrueV, FalseV,
+		                   Val, DAG.getTargetConstant(NZP, MVT::i16));
+}
+
+/// EmitInstrWithCustomInserter - SELECT becomes
+///   thisMBB:  BRcc $rb, $nzp, sinkMBB
+///   falseMBB: (fall through)
+///   sinkMBB:  $dst = PHI [$t, thisMBB], [$f, falseMBB]
+MachineBasicBlock *
+LC3bTargetLowering::EmitInstrWithCustomInserter(MachineInstr *MI,
+                                                MachineBasicBlock *BB) const {
+		if (MI->getOpcode() == LC3b::BRcc32)
+				return EmitBRcc32(MI, BB);
+		if (MI->getOpcode() == LC3b::MEMCPY || MI->getOpcode() == LC3b::MEMSET)
+				return EmitMemLoop(MI, BB);
+		if (MI->getOpcode() == LC3b::SHIFT || MI->getOpcode() == LC3b::SHIFT32)
+				return EmitShiftLoop(MI, BB);
+		assert(MI->getOpcode() == LC3b::SELECT && "Unexpected instr type to insert");
+		const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
+		DebugLoc dl = MI->getDebugLoc();
+		const BasicBlock *LLVM_BB = BB->getBasicBlock();
+		MachineFunction *F = BB->getParent();
+		MachineFunction::iterator I = BB;
+		++I;
+
+		MachineBasicBlock *thisMBB = BB;
+		MachineBasicBlock *falseMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		MachineBasicBlock *sinkMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		F->insert(I, falseMBB);
+		F->insert(I, sinkMBB);
+
+		// Everything after the SELECT moves to sinkMBB.
+		sinkMBB->splice(sinkMBB->begin(), BB,
+		                llvm::next(MachineBasicBlock::iterator(MI)), BB->end());
+		sinkMBB->transferSuccessorsAndUpdatePHIs(BB);
+		BB->addSuccessor(falseMBB);
+		BB->addSuccessor(sinkMBB);
+		falseMBB->addSuccessor(sinkMBB);
+
+		BuildMI(BB, dl, TII.get(LC3b::BRcc))
+			.addMBB(sinkMBB)
+			.addReg(MI->getOperand(3).getReg())
+			.addImm(MI->getOperand(4).getImm());
+
+		BuildMI(*sinkMBB, sinkMBB->begin(), dl, TII.get(LC3b::PHI),
+		        MI->getOperand(0).getReg())
+			.addReg(MI->getOperand(1).getReg()).addMBB(thisMBB)
+			.addReg(MI->getOperand(2).getReg()).addMBB(falseMBB);
+
+		MI->eraseFromParent();
+		return sinkMBB;
+}
+
+/// EmitBRcc32 - BRcc32 becomes
+///   thisMBB: BRcc $hi, $hinzp, dst
+///   neMBB:   BRcc $ne, $nenzp, contMBB
+///   loMBB:   BRcc $lo, $lonzp, dst
+///   contMBB: (the terminators after BRcc32, to the false successor)
+/// The false successor is not known yet, the BR to it (if any) is emitted
+/// into contMBB after this returns. BRcc expands to TST+BR after register
+/// allocation, so each of them ends a block of its own.
+MachineBasicBlock *
+LC3bTargetLowering::EmitBRcc32(MachineInstr *MI, MachineBasicBlock *BB) const {
+		const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
+		DebugLoc dl = MI->getDebugLoc();
+		const BasicBlock *LLVM_BB = BB->getBasicBlock();
+		MachineFunction *F = BB->getParent();
+		MachineFunction::iterator I = BB;
+		++I;
+
+		MachineBasicBlock *Dest = MI->getOperand(0).getMBB();
+		unsigned HiNZP = MI->getOperand(2).getImm();
+		unsigned NeNZP = MI->getOperand(4).getImm();
+		// Only a degenerate branch has the same true and false successor.
+		bool DestIsFalse = BB->succ_size() == 1;
+
+		MachineBasicBlock *neMBB = BB;
+		if (HiNZP && NeNZP) {
+				neMBB = F->CreateMachineBasicBlock(LLVM_BB);
+				F->insert(I, neMBB);
+		}
+		MachineBasicBlock *loMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		MachineBasicBlock *contMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		F->insert(I, loMBB);
+		F->insert(I, contMBB);
+
+		contMBB->splice(contMBB->begin(), BB,
+		                llvm::next(MachineBasicBlock::iterator(MI)), BB->end());
+		contMBB->transferSuccessorsAndUpdatePHIs(BB);
+
+		// The edges into Dest now come from thisMBB and loMBB.
+		if (!DestIsFalse)
+				contMBB->removeSuccessor(Dest);
+		for (MachineBasicBlock::iterator PN = Dest->begin();
+		     PN != Dest->end() && PN->isPHI(); ++PN) {
+				for (unsigned i = 1, e = PN->getNumOperands(); i != e; i += 2) {
+						if (PN->getOperand(i + 1).getMBB() != contMBB)
+								continue;
+						unsigned Reg = PN->getOperand(i).getReg();
+						if (DestIsFalse)
+								MachineInstrBuilder(*F, PN).addReg(Reg).addMBB(loMBB);
+						else
+								PN->getOperand(i + 1).setMBB(loMBB);
+						if (HiNZP)
+								MachineInstrBuilder(*F, PN).addReg(Reg).addMBB(BB);
+						break;
+				}
+		}
+
+		if (HiNZP) {
+				BuildMI(BB, dl, TII.get(LC3b::BRcc)).addMBB(Dest)
+					.addReg(MI->getOperand(1).getReg()).addImm(HiNZP);
+				BB->addSuccessor(Dest);
+		}
+		if (neMBB != BB)
+				BB->addSuccessor(neMBB);
+		if (NeNZP) {
+				BuildMI(neMBB, dl, TII.get(LC3b::BRcc)).addMBB(contMBB)
+					.addReg(MI->getOperand(3).getReg()).addImm(NeNZP);
+				neMBB->addSuccessor(contMBB);
+		}
+		neMBB->addSuccessor(loMBB);
+
+		BuildMI(loMBB, dl, TII.get(LC3b::BRcc)).addMBB(Dest)
+			.addReg(MI->getOperand(5).getReg()).addImm(MI->getOperand(6).getImm());
+		loMBB->addSuccessor(Dest);
+		loMBB->addSuccessor(contMBB);
+
+		MI->eraseFromParent();
+		return contMBB;
+}
+
+/// EmitMemLoop - MEMCPY/MEMSET of $cnt steps of $size bytes become
+///   thisMBB: (fall through)
+///   loopMBB: $d = PHI [$dst, thisMBB], [$d1, loopMBB]
+///            ($s = PHI [$src, thisMBB], [$s1, loopMBB])
+///            $c = PHI [$cnt, thisMBB], [$c1, loopMBB]
+///            ($t = LDW/LDB $s, 0)
+///            STW/STB $t or $val, $d, 0
+///            ($s1 = ADD $s, $size)
+///            $d1 = ADD $d, $size
+///            $c1 = ADD $c, -1
+///            BRcc $c1, p, loopMBB
+///   exitMBB: (the rest of thisMBB)
+/// The count is at least one. LC3b has no post-increment addressing, the
+/// ADDs step the pointers, and the last one sets the flags BRcc tests.
+MachineBasicBlock *
+LC3bTargetLowering::EmitMemLoop(MachineInstr *MI, MachineBasicBlock *BB) const {
+		const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
+		DebugLoc dl = MI->getDebugLoc();
+		const BasicBlock *LLVM_BB = BB->getBasicBlock();
+		MachineFunction *F = BB->getParent();
+		MachineRegisterInfo &MRI = F->getRegInfo();
+		const TargetRegisterClass *RC = &LC3b::LC3bRegsRegClass;
+		MachineFunction::iterator I = BB;
+		++I;
+
+		bool IsCopy = MI->getOpcode() == LC3b::MEMCPY;
+		unsigned Step = MI->getOperand(3).getImm();
+		unsigned Load = Step == 2 ? LC3b::LDW : LC3b::LDB;
+		unsigned Store = Step == 2 ? LC3b::STW : LC3b::STB;
+
+		MachineBasicBlock *thisMBB = BB;
+		MachineBasicBlock *loopMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		MachineBasicBlock *exitMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		F->insert(I, loopMBB);
+		F->insert(I, exitMBB);
+
+		exitMBB->splice(exitMBB->begin(), BB,
+		                llvm::next(MachineBasicBlock::iterator(MI)), BB->end());
+		exitMBB->transferSuccessorsAndUpdatePHIs(BB);
+		BB->addSuccessor(loopMBB);
+		loopMBB->addSuccessor(loopMBB);
+		loopMBB->addSuccessor(exitMBB);
+
+		unsigned D = MRI.createVirtualRegister(RC);
+		unsigned D1 = MRI.createVirtualRegister(RC);
+		unsigned C = MRI.createVirtualRegister(RC);
+		unsigned C1 = MRI.createVirtualRegister(RC);
+		BuildMI(loopMBB, dl, TII.get(LC3b::PHI), D)
+			.addReg(MI->getOperand(0).getReg()).addMBB(thisMBB)
+			.addReg(D1).addMBB(loopMBB);
+		BuildMI(loopMBB, dl, TII.get(LC3b::PHI), C)
+			.addReg(MI->getOperand(2).getReg()).addMBB(thisMBB)
+			.addReg(C1).addMBB(loopMBB);
+
+		unsigned Val = MI->getOperand(1).getReg();
+		if (IsCopy) {
+				unsigned S = MRI.createVirtualRegister(RC);
+				unsigned S1 = MRI.createVirtualRegister(RC);
+				BuildMI(loopMBB, dl, TII.get(LC3b::PHI), S)
+					.addReg(MI->getOperand(1).getReg()).addMBB(thisMBB)
+					.addReg(S1).addMBB(loopMBB);
+				Val = MRI.createVirtualRegister(RC);
+				BuildMI(loopMBB, dl, TII.get(Load), Val).addReg(S).addImm(0);
+				BuildMI(loopMBB, dl, TII.get(LC3b::ADDI), S1).addReg(S).addImm(Step);
+		}
+		BuildMI(loopMBB, dl, TII.get(Store)).addReg(Val).addReg(D).addImm(0);
+		BuildMI(loopMBB, dl, TII.get(LC3b::ADDI), D1).addReg(D).addImm(Step);
+		BuildMI(loopMBB, dl, TII.get(LC3b::ADDI), C1).addReg(C).addImm(-1);
+		BuildMI(loopMBB, dl, TII.get(LC3b::BRcc))
+			.addMBB(loopMBB).addReg(C1).addImm(LC3bCC::COND_P);
+
+		MI->eraseFromParent();
+		return exitMBB;
+}
+
+/// EmitShiftLoop - SHIFT and SHIFT32 by $amt become
+///   thisMBB: BRcc $amt, z, exitMBB
+///   loopMBB: $v = PHI [$val, thisMBB], [$v1, loopMBB]
+///            $c = PHI [$amt, thisMBB], [$c1, loopMBB]
+///            $v1 = $v shifted by one
+///            $c1 = ADD $c, -1
+///            BRcc $c1, p, loopMBB
+///   exitMBB: $dst = PHI [$val, thisMBB], [$v1, loopMBB]
+/// An i32 moves the bit crossing between its halves with an ADD, as
+/// $hi1 = LSHF $hi, 1 + RSHFL $lo, 15 for a left shift.
+MachineBasicBlock *
+LC3bTargetLowering::EmitShiftLoop(MachineInstr *MI, MachineBasicBlock *BB) const {
+		const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
+		DebugLoc dl = MI->getDebugLoc();
+		const BasicBlock *LLVM_BB = BB->getBasicBlock();
+		MachineFunction *F = BB->getParent();
+		MachineRegisterInfo &MRI = F->getRegInfo();
+		const TargetRegisterClass *RC = &LC3b::LC3bRegsRegClass;
+		MachineFunction::iterator I = BB;
+		++I;
+
+		bool Is32 = MI->getOpcode() == LC3b::SHIFT32;
+		unsigned NumDefs = Is32 ? 2 : 1;
+		unsigned Amt = MI->getOperand(2 * NumDefs).getReg();
+		unsigned Op = MI->getOperand(2 * NumDefs + 1).getImm();
+		unsigned Shift = Op == ISD::SHL ? LC3b::LSHF :
+		                 Op == ISD::SRL ? LC3b::RSHFL : LC3b::RSHFA;
+
+		MachineBasicBlock *thisMBB = BB;
+		MachineBasicBlock *loopMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		MachineBasicBlock *exitMBB = F->CreateMachineBasicBlock(LLVM_BB);
+		F->insert(I, loopMBB);
+		F->insert(I, exitMBB);
+
+		exitMBB->splice(exitMBB->begin(), BB,
+		                llvm::next(MachineBasicBlock::iterator(MI)), BB->end());
+		exitMBB->transferSuccessorsAndUpdatePHIs(BB);
+		BB->addSuccessor(loopMBB);
+		BB->addSuccessor(exitMBB);
+		loopMBB->addSuccessor(loopMBB);
+		loopMBB->addSuccessor(exitMBB);
+
+		BuildMI(BB, dl, TII.get(LC3b::BRcc))
+			.addMBB(exitMBB).addReg(Amt).addImm(LC3bCC::COND_Z);
+
+		// One PHI per word of the value, the low word first.
+		unsigned V[2], V1[2];
+		for (unsigned i = 0; i != NumDefs; ++i) {
+				V[i] = MRI.createVirtualRegister(RC);
+				V1[i] = MRI.createVirtualRegister(RC);
+				BuildMI(loopMBB, dl, TII.get(LC3b::PHI), V[i])
+					.addReg(MI->getOperand(NumDefs + i).getReg()).addMBB(thisMBB)
+					.addReg(V1[i]).addMBB(loopMBB);
+		}
+		unsigned C = MRI.createVirtualRegister(RC);
+		unsigned C1 = MRI.createVirtualRegister(RC);
+		BuildMI(loopMBB, dl, TII.get(LC3b::PHI), C)
+			.addReg(Amt).addMBB(thisMBB)
+			.addReg(C1).addMBB(loopMBB);
+
+		if (!Is32)
+				BuildMI(loopMBB, dl, TII.get(Shift), V1[0]).addReg(V[0]).addImm(1);
+		else {
+				// From is the word losing a bit to To.
+				unsigned From = Op == ISD::SHL ? 0 : 1, To = 1 - From;
+				unsigned Carry = MRI.createVirtualRegister(RC);
+				unsigned Part = MRI.createVirtualRegister(RC);
+				BuildMI(loopMBB, dl, TII.get(Op == ISD::SHL ? LC3b::RSHFL : LC3b::LSHF),
+				        Carry).addReg(V[From]).addImm(15);
+				BuildMI(loopMBB, dl, TII.get(Op == ISD::SHL ? LC3b::LSHF : LC3b::RSHFL),
+				        Part).addReg(V[To]).addImm(1);
+				BuildMI(loopMBB, dl, TII.get(LC3b::ADD), V1[To])
+					.addReg(Part).addReg(Carry);
+				BuildMI(loopMBB, dl, TII.get(Shift), V1[From]).addReg(V[From]).addImm(1);
+		}
+		BuildMI(loopMBB, dl, TII.get(LC3b::ADDI), C1).addReg(C).addImm(-1);
+		BuildMI(loopMBB, dl, TII.get(LC3b::BRcc))
+			.addMBB(loopMBB).addReg(C1).addImm(LC3bCC::COND_P);
+
+		for (unsigned i = 0; i != NumDefs; ++i)
+				BuildMI(*exitMBB, exitMBB->begin(), dl, TII.get(LC3b::PHI),
+				        MI->getOperand(i).getReg())
+					.addReg(MI->getOperand(NumDefs + i).getReg()).addMBB(thisMBB)
+					.addReg(V1[i]).addMBB(loopMBB);
+
+		MI->eraseFromParent();
+		return exitMBB;
+}
+
 #include "LC3bGenCallingConv.inc"
+
+//===----------------------------------------------------------------------===//
+//                  Call Calling Convention Implementation
+//===----------------------------------------------------------------------===//
+//
+// The first four i16 arguments are passed in R0-R3, the rest (and every
+// argument of a variadic call) in word slots at R6+0, R6+2, ... at the point
+// of the JSR. Values are returned in R0 (and R1 for the high half of a split
+// value). R4, R5 and R7 are callee saved, see CSR_LC3b in LC3bCallingConv.td.
+//
+//===----------------------------------------------------------------------===//
+
 /// LowerFormalArguments - transform physical registers into virtual registers
 /// and generate load operations for arguments places on the stack.
 SDValue LC3bTargetLowering::LowerFormalArguments(SDValue Chain,CallingConv::ID CallConv, bool isVarArg, const SmallVectorImpl<ISD::InputArg> &Ins, DebugLoc dl, SelectionDAG &DAG,SmallVectorImpl<SDValue> &InVals) const {
+		MachineFunction &MF = DAG.getMachineFunction();
+		MachineFrameInfo *MFI = MF.getFrameInfo();
+		MachineRegisterInfo &RegInfo = MF.getRegInfo();
+		LC3bFunctionInfo *FuncInfo = MF.getInfo<LC3bFunctionInfo>();
+
+		// Assign locations to all of the incoming arguments.
+		SmallVector<CCValAssign, 16> ArgLocs;
+		CCState CCInfo(CallConv, isVarArg, MF, getTargetMachine(), ArgLocs, *DAG.getContext());
+		CCInfo.AnalyzeFormalArguments(Ins, CC_LC3b);
+
+		// Create frame index for the start of the first vararg value
+		if (isVarArg)
+				FuncInfo->setVarArgsFrameIndex(MFI->CreateFixedObject(2, CCInfo.getNextStackOffset(), true));
+
+		for (unsigned i = 0, e = ArgLocs.size(); i != e; ++i) {
+				CCValAssign &VA = ArgLocs[i];
+				if (VA.isRegLoc()) {
+						// Arguments passed in registers
+						EVT RegVT = VA.getLocVT();
+						assert(RegVT == MVT::i16 && "Unhandled LC3b argument type");
+						unsigned VReg = RegInfo.createVirtualRegister(&LC3b::LC3bRegsRegClass);
+						RegInfo.addLiveIn(VA.getLocReg(), VReg);
+						SDValue ArgValue = DAG.getCopyFromReg(Chain, dl, VReg, RegVT);
+
+						// If this is an 8-bit value, it is really passed promoted to 16
+						// bits. Insert an assert[sz]ext to capture this, then truncate to the
+						// right size.
+						if (VA.getLocInfo() == CCValAssign::SExt)
+								ArgValue = DAG.getNode(ISD::AssertSext, dl, RegVT, ArgValue, DAG.getValueType(VA.getValVT()));
+						else if (VA.getLocInfo() == CCValAssign::ZExt)
+								ArgValue = DAG.getNode(ISD::AssertZext, dl, RegVT, ArgValue, DAG.getValueType(VA.getValVT()));
+
+						if (VA.getLocInfo() != CCValAssign::Full)
+								ArgValue = DAG.getNode(ISD::TRUNCATE, dl, VA.getValVT(), ArgValue);
+
+						InVals.push_back(ArgValue);
+						continue;
+				}
+
+				// Sanity check
+				assert(VA.isMemLoc());
+
+				// The caller left the argument at R6+LocMemOffset, create a fixed
+				// object for it; the frame lowering rebases it past our own frame.
+				unsigned ObjSize = VA.getLocVT().getSizeInBits()/8;
+				int FI = MFI->CreateFixedObject(ObjSize, VA.getLocMemOffset(), true);
+
+				// Create the SelectionDAG nodes corresponding to a load
+				// from this parameter
+				SDValue FIN = DAG.getFrameIndex(FI, getPointerTy());
+				InVals.push_back(DAG.getLoad(VA.getLocVT(), dl, Chain, FIN, MachinePointerInfo::getFixedStack(FI), false, false, false, 0));
+		}
+
 		return Chain;
 }
+
+/// LowerCall - functions arguments are copied from virtual regs to
+/// (physical regs)/(stack frame), CALLSEQ_START and CALLSEQ_END are emitted.
+SDValue LC3bTargetLowering::LowerCall(TargetLowering::CallLoweringInfo &CLI, SmallVectorImpl<SDValue> &InVals) const {
+		SelectionDAG &DAG						= CLI.DAG;
+		DebugLoc &dl							= CLI.DL;
+		SmallVector<ISD::OutputArg, 32> &Outs	= CLI.Outs;
+		SmallVector<SDValue, 32> &OutVals		= CLI.OutVals;
+		SmallVector<ISD::InputArg, 32> &Ins		= CLI.Ins;
+		SDValue Chain							= CLI.Chain;
+		SDValue Callee							= CLI.Callee;
+		CallingConv::ID CallConv				= CLI.CallConv;
+		bool isVarArg							= CLI.IsVarArg;
+
+		// LC3b does not support tail call optimization.
+		CLI.IsTailCall = false;
+
+		// Analyze operands of the call, assigning locations to each operand.
+		SmallVector<CCValAssign, 16> ArgLocs;
+		CCState CCInfo(CallConv, isVarArg, DAG.getMachineFunction(), getTargetMachine(), ArgLocs, *DAG.getContext());
+		CCInfo.AnalyzeCallOperands(Outs, CC_LC3b);
+
+		// Get a count of how many bytes are to be pushed on the stack.
+		unsigned NumBytes = CCInfo.getNextStackOffset();
+
+		Chain = DAG.getCALLSEQ_START(Chain, DAG.getIntPtrConstant(NumBytes, true));
+
+		SmallVector<std::pair<unsigned, SDValue>, 4> RegsToPass;
+		SmallVector<SDValue, 8> MemOpChains;
+		SDValue StackPtr;
+
+		// Walk the register/memloc assignments, inserting copies/loads.
+		for (unsigned i = 0, e = ArgLocs.size(); i != e; ++i) {
+				CCValAssign &VA = ArgLocs[i];
+				SDValue Arg = OutVals[i];
+
+				// Promote the value if needed.
+				switch (VA.getLocInfo()) {
+				default: llvm_unreachable("Unknown loc info!");
+				case CCValAssign::Full: break;
+				case CCValAssign::SExt:
+						Arg = DAG.getNode(ISD::SIGN_EXTEND, dl, VA.getLocVT(), Arg);
+						break;
+				case CCValAssign::ZExt:
+						Arg = DAG.getNode(ISD::ZERO_EXTEND, dl, VA.getLocVT(), Arg);
+						break;
+				case CCValAssign::AExt:
+						Arg = DAG.getNode(ISD::ANY_EXTEND, dl, VA.getLocVT(), Arg);
+						break;
+				}
+
+				// Arguments that can be passed on register must be kept at RegsToPass
+				// vector
+				if (VA.isRegLoc()) {
+						RegsToPass.push_back(std::make_pair(VA.getLocReg(), Arg));
+						continue;
+				}
+
+				assert(VA.isMemLoc());
+				if (StackPtr.getNode() == 0)
+						StackPtr = DAG.getCopyFromReg(Chain, dl, LC3b::R6, getPointerTy());
+
+				SDValue PtrOff = DAG.getNode(ISD::ADD, dl, getPointerTy(), StackPtr, DAG.getIntPtrConstant(VA.getLocMemOffset()));
+				MemOpChains.push_back(DAG.getStore(Chain, dl, Arg, PtrOff, MachinePointerInfo(), false, false, 0));
+		}
+
+		// Transform all store nodes into one single node because all store nodes are
+		// independent of each other.
+		if (!MemOpChains.empty())
+				Chain = DAG.getNode(ISD::TokenFactor, dl, MVT::Other, &MemOpChains[0], MemOpChains.size());
+
+		// Build a sequence of copy-to-reg nodes chained together with token chain and
+		// flag operands which copy the outgoing args into registers. The InFlag in
+		// necessary since all emitted instructions must be stuck together.
+		SDValue InFlag;
+		for (unsigned i = 0, e = RegsToPass.size(); i != e; ++i) {
+				Chain = DAG.getCopyToReg(Chain, dl, RegsToPass[i].first, RegsToPass[i].second, InFlag);
+				InFlag = Chain.getValue(1);
+		}
+
+		// If the callee is a GlobalAddress node (quite common, every direct call is)
+		// turn it into a TargetGlobalAddress node so that legalize doesn't hack it,
+		// it is selected as JSR. Anything else goes through a register and JSRR.
+		if (GlobalAddressSDNode *G = dyn_cast<GlobalAddressSDNode>(Callee))
+				Callee = DAG.getTargetGlobalAddress(G->getGlobal(), dl, getPointerTy());
+		else if (ExternalSymbolSDNode *E = dyn_cast<ExternalSymbolSDNode>(Callee))
+				Callee = DAG.getTargetExternalSymbol(E->getSymbol(), getPointerTy());
+
+		// Returns a chain & a flag for retval copy to use.
+		SDVTList NodeTys = DAG.getVTList(MVT::Other, MVT::Glue);
+		SmallVector<SDValue, 8> Ops;
+		Ops.push_back(Chain);
+		Ops.push_back(Callee);
+
+		// Add argument registers to the end of the list so that they are
+		// known live into the call.
+		for (unsigned i = 0, e = RegsToPass.size(); i != e; ++i)
+				Ops.push_back(DAG.getRegister(RegsToPass[i].first, RegsToPass[i].second.getValueType()));
+
+		// Add a register mask operand representing the call-preserved registers.
+		const TargetRegisterInfo *TRI = getTargetMachine().getRegisterInfo();
+		const uint32_t *Mask = TRI->getCallPreservedMask(CallConv);
+		assert(Mask && "Missing call preserved mask for calling convention");
+		Ops.push_back(DAG.getRegisterMask(Mask));
+
+		if (InFlag.getNode())
+				Ops.push_back(InFlag);
+
+		Chain = DAG.getNode(LC3bISD::JmpLink, dl, NodeTys, &Ops[0], Ops.size());
+		InFlag = Chain.getValue(1);
+
+		// Create the CALLSEQ_END node.
+		Chain = DAG.getCALLSEQ_END(Chain, DAG.getIntPtrConstant(NumBytes, true), DAG.getIntPtrConstant(0, true), InFlag);
+		InFlag = Chain.getValue(1);
+
+		// Handle result values, copying them out of physregs into vregs that we
+		// return.
+		return LowerCallResult(Chain, InFlag, CallConv, isVarArg, Ins, dl, DAG, InVals);
+}
+
+/// LowerCallResult - Lower the result values of a call into the
+/// appropriate copies out of appropriate physical registers.
+SDValue LC3bTargetLowering::LowerCallResult(SDValue Chain, SDValue InFlag, CallingConv::ID CallConv, bool isVarArg, const SmallVectorImpl<ISD::InputArg> &Ins, DebugLoc dl, SelectionDAG &DAG, SmallVectorImpl<SDValue> &InVals) const {
+		// Assign locations to each value returned by this call.
+		SmallVector<CCValAssign, 16> RVLocs;
+		CCState CCInfo(CallConv, isVarArg, DAG.getMachineFunction(), getTargetMachine(), RVLocs, *DAG.getContext());
+		CCInfo.AnalyzeCallResult(Ins, RetCC_LC3b);
+
+		// Copy all of the result registers out of their specified physreg.
+		for (unsigned i = 0; i != RVLocs.size(); ++i) {
+				Chain = DAG.getCopyFromReg(Chain, dl, RVLocs[i].getLocReg(), RVLocs[i].getValVT(), InFlag).getValue(1);
+				InFlag = Chain.getValue(2);
+				InVals.push_back(Chain.getValue(0));
+		}
+
+		return Chain;
+}
+
 //===----------------------------------------------------------------------===//
 //Return Value Calling Convention Implementation
 //===----------------------------------------------------------------------===//
 SDValue LC3bTargetLowering::LowerReturn(SDValue Chain, CallingConv::ID CallConv, bool isVarArg, const SmallVectorImpl<ISD::OutputArg> &Outs,const SmallVectorImpl<SDValue> &OutVals, DebugLoc dl, SelectionDAG &DAG) const {
-		return DAG.getNode(LC3bISD::Ret, dl, MVT::Other, Chain, DAG.getRegister(LC3b::LR, MVT::i32));
-}
+		// CCValAssign - represent the assignment of the return value to a location
+		SmallVector<CCValAssign, 16> RVLocs;
+
+		// CCState - Info about the registers and stack slot.
+		CCState CCInfo(CallConv, isVarArg, DAG.getMachineFunction(), getTargetMachine(), RVLocs, *DAG.getContext());
+
+		// Analize return values.
+		CCInfo.AnalyzeReturn(Outs, RetCC_LC3b);
+
+		SDValue Flag;
+		SmallVector<SDValue, 4> RetOps(1, Chain);
+
+		// Copy the result values into the output registers.
+		for (unsigned i = 0; i != RVLocs.size(); ++i) {
+				CCValAssign &VA = RVLocs[i];
+				assert(VA.isRegLoc() && "Can only return in registers!");
 
+				Chain = DAG.getCopyToReg(Chain, dl, VA.getLocReg(), OutVals[i], Flag);
+
+				// Guarantee that all emitted copies are stuck together,
+				// avoiding something bad.
+				Flag = Chain.getValue(1);
+				RetOps.push_back(DAG.getRegister(VA.getLocReg(), VA.getLocVT()));
+		}
+
+		RetOps[0] = Chain;	// Update chain.
+
+		// Add the flag if we have it.
+		if (Flag.getNode())
+				RetOps.push_back(Flag);
+
+		return DAG.getNode(LC3bISD::Ret, dl, MVT::Other, &RetOps[0], RetOps.size());
+}
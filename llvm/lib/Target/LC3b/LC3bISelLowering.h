@@ -22,7 +22,25 @@ namespace llvm {
 				enum NodeType {
 						// Start the numbering from where ISD NodeType finishes.
 						FIRST_NUMBER = ISD::BUILTIN_OP_END,
-						Ret
+						// Return, a RET (JMP R7) with the returned values glued to it.
+						Ret,
+						// JmpLink - JSR/JSRR to a function, the operands after the
+						// callee are the registers holding the arguments.
+						JmpLink,
+						// BR_CC - Branch if the flags of a register match an n/z/p
+						// mask, operands are chain, destination, register and mask.
+						BR_CC,
+						// BR_CC32 - Branch on an i32 compare: chain, destination and
+						// register/mask pairs for the high word, the high words
+						// differing and the low word, see LowerBR_CC.
+						BR_CC32,
+						// SELECT_CC - True and false value, register and n/z/p mask.
+						SELECT_CC,
+						// MEMCPY/MEMSET - Copy from a source pointer, or store a
+						// value, to a destination pointer: chain, destination,
+						// source or value, iteration count and step (1 or 2 bytes).
+						MEMCPY,
+						MEMSET
 				};
 		}
 		//===----------------------------
@@ -31,14 +49,56 @@ namespace llvm {
 		class LC3bTargetLowering : public TargetLowering {
 				public:
 				explicit LC3bTargetLowering(LC3bTargetMachine &TM);
+				/// getTargetNodeName - This method returns the name of a target specific
+				//  DAG node.
+				virtual const char *getTargetNodeName(unsigned Opcode) const;
+				/// LowerOperation - Provide custom lowering hooks for some operations.
+				virtual SDValue LowerOperation(SDValue Op, SelectionDAG &DAG) const;
+				/// ReplaceNodeResults - i32 ADD/SUB on register pairs.
+				virtual void ReplaceNodeResults(SDNode *N, SmallVectorImpl<SDValue> &Results,
+				                                SelectionDAG &DAG) const;
+				/// PerformDAGCombine - Byte updates of packed words become STB.
+				virtual SDValue PerformDAGCombine(SDNode *N, DAGCombinerInfo &DCI) const;
+				/// EmitInstrWithCustomInserter - Expand SELECT into a BRcc diamond,
+				/// BRcc32 into BRcc blocks and MEMCPY/MEMSET and SHIFT/SHIFT32
+				/// into loops.
+				virtual MachineBasicBlock *
+				EmitInstrWithCustomInserter(MachineInstr *MI, MachineBasicBlock *BB) const;
+				/// Shift amounts are i16, LSHF/RSHFL/RSHFA only encode 0-15.
+				virtual MVT getScalarShiftAmountTy(EVT LHSTy) const { return MVT::i16; }
+				/// isLegalAddImmediate - ADD takes a simm5.
+				virtual bool isLegalAddImmediate(int64_t Imm) const;
+				/// isLegalICmpImmediate - Zero, or a simm5 to ADD the negation of.
+				virtual bool isLegalICmpImmediate(int64_t Imm) const;
+				/// isLegalAddressingMode - A base register plus offset6.
+				virtual bool isLegalAddressingMode(const AddrMode &AM, Type *Ty) const;
+				/// isTruncateFree - Narrowing an integer of up to 32 bits.
+				virtual bool isTruncateFree(Type *Ty1, Type *Ty2) const;
+				virtual bool isTruncateFree(EVT VT1, EVT VT2) const;
+				/// getInstrLatency - Cycles of Opcode in the itinerary.
+				unsigned getInstrLatency(unsigned Opcode) const;
+				/// getMulCallLatency/getDivCallLatency - Expected cycles of a call
+				/// to the multiply and divide helpers in Runtime/.
+				unsigned getMulCallLatency() const;
+				unsigned getDivCallLatency() const;
 				private:
 				// Subtarget Info
 				const LC3bSubtarget *Subtarget;
+				// Lower Operand specifics
+				SDValue LowerMUL(SDValue Op, SelectionDAG &DAG) const;
+				SDValue LowerBR_CC(SDValue Op, SelectionDAG &DAG) const;
+				SDValue LowerBR_CC32(SDValue Op, SelectionDAG &DAG) const;
+				SDValue LowerSELECT_CC(SDValue Op, SelectionDAG &DAG) const;
+				void setJumpTableLimits();
+				MachineBasicBlock *EmitBRcc32(MachineInstr *MI, MachineBasicBlock *BB) const;
+				MachineBasicBlock *EmitMemLoop(MachineInstr *MI, MachineBasicBlock *BB) const;
+				MachineBasicBlock *EmitShiftLoop(MachineInstr *MI, MachineBasicBlock *BB) const;
 				//- must be exist without function all
 				virtual SDValue LowerFormalArguments(SDValue Chain,CallingConv::ID CallConv, bool isVarArg,const SmallVectorImpl<ISD::InputArg> &Ins, DebugLoc dl, SelectionDAG &DAG, SmallVectorImpl<SDValue> &InVals) const;
+				virtual SDValue LowerCall(TargetLowering::CallLoweringInfo &CLI, SmallVectorImpl<SDValue> &InVals) const;
+				SDValue LowerCallResult(SDValue Chain, SDValue InFlag, CallingConv::ID CallConv, bool isVarArg, const SmallVectorImpl<ISD::InputArg> &Ins, DebugLoc dl, SelectionDAG &DAG, SmallVectorImpl<SDValue> &InVals) const;
 				//- must be exist without function all
 				virtual SDValue LowerReturn(SDValue Chain,CallingConv::ID CallConv, bool isVarArg,const SmallVectorImpl<ISD::OutputArg> &Outs,const SmallVectorImpl<SDValue> &OutVals,DebugLoc dl, SelectionDAG &DAG) const;
 		};
 }
 #endif // LC3bISELLOWERING_H
-
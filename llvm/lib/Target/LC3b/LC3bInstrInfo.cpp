@@ -6,21 +6,502 @@
 // License. See LICENSE.TXT for details.
 //
 //===----------------------------------------------------------------------===//
-
-/
+//
 // This file contains the LC3b implementation of the TargetInstrInfo class.
 //
 //===----------------------------------------------------------------------===//
 #include "LC3bInstrInfo.h"
 #include "LC3bTargetMachine.h"
+#include "llvm/CodeGen/MachineConstantPool.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineMemOperand.h"
+#include "llvm/CodeGen/RegisterScavenging.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/Support/ManagedStatic.h"
+#include <vector>
 #define GET_INSTRINFO_CTOR
 #include "LC3bGenInstrInfo.inc"
 using namespace llvm;
-LC3bInstrInfo::LC3bInstrInfo(LC3bTargetMachine &tm) : TM(tm), RI(*TM.getSubtargetImpl(), *this) {}
+LC3bInstrInfo::LC3bInstrInfo(LC3bTargetMachine &tm)
+	: LC3bGenInstrInfo(LC3b::ADJCALLSTACKDOWN, LC3b::ADJCALLSTACKUP),
+	  TM(tm), RI(*TM.getSubtargetImpl(), *this) {}
 
 const LC3bRegisterInfo &LC3bInstrInfo::getRegisterInfo() const {
 		return RI;
 }
 
+void LC3bInstrInfo::copyPhysReg(MachineBasicBlock &MBB,
+                                MachineBasicBlock::iterator I, DebugLoc DL,
+                                unsigned DestReg, unsigned SrcReg,
+                                bool KillSrc) const {
+	assert(LC3b::LC3bRegsRegClass.contains(DestReg, SrcReg) &&
+	       "Impossible reg-to-reg copy");
+	BuildMI(MBB, I, DL, get(LC3b::ADDI), DestReg)
+		.addReg(SrcReg, getKillRegState(KillSrc)).addImm(0);
+}
+
+static MachineMemOperand *getFrameMemOperand(MachineBasicBlock &MBB, int FI,
+                                             unsigned Flag) {
+	MachineFunction &MF = *MBB.getParent();
+	MachineFrameInfo &MFI = *MF.getFrameInfo();
+	return MF.getMachineMemOperand(MachinePointerInfo::getFixedStack(FI), Flag,
+	                               MFI.getObjectSize(FI),
+	                               MFI.getObjectAlignment(FI));
+}
+
+void LC3bInstrInfo::
+storeRegToStackSlot(MachineBasicBlock &MBB, MachineBasicBlock::iterator I,
+                    unsigned SrcReg, bool isKill, int FI,
+                    const TargetRegisterClass *RC,
+                    const TargetRegisterInfo *TRI) const {
+	DebugLoc DL;
+	if (I != MBB.end()) DL = I->getDebugLoc();
+	MachineMemOperand *MMO = getFrameMemOperand(MBB, FI,
+	                                            MachineMemOperand::MOStore);
+
+	BuildMI(MBB, I, DL, get(LC3b::STW)).addReg(SrcReg, getKillRegState(isKill))
+		.addFrameIndex(FI).addImm(0).addMemOperand(MMO);
+}
+
+void LC3bInstrInfo::
+loadRegFromStackSlot(MachineBasicBlock &MBB, MachineBasicBlock::iterator I,
+                     unsigned DestReg, int FI,
+                     const TargetRegisterClass *RC,
+                     const TargetRegisterInfo *TRI) const {
+	DebugLoc DL;
+	if (I != MBB.end()) DL = I->getDebugLoc();
+	MachineMemOperand *MMO = getFrameMemOperand(MBB, FI,
+	                                            MachineMemOperand::MOLoad);
 
+	BuildMI(MBB, I, DL, get(LC3b::LDW), DestReg)
+		.addFrameIndex(FI).addImm(0).addMemOperand(MMO);
+}
+
+/// getBranchOpcode - The BR testing the n/z/p mask NZP.
+static unsigned getBranchOpcode(unsigned NZP) {
+	switch (NZP) {
+	default: llvm_unreachable("Invalid n/z/p mask!");
+	case LC3bCC::COND_N:   return LC3b::BRn;
+	case LC3bCC::COND_Z:   return LC3b::BRz;
+	case LC3bCC::COND_P:   return LC3b::BRp;
+	case LC3bCC::COND_NZ:  return LC3b::BRnz;
+	case LC3bCC::COND_NP:  return LC3b::BRnp;
+	case LC3bCC::COND_ZP:  return LC3b::BRzp;
+	case LC3bCC::COND_NZP: return LC3b::BRnzp;
+	}
+}
+
+/// getBranchNZP - The n/z/p mask a BR tests, 0 for other opcodes.
+static unsigned getBranchNZP(unsigned Opc) {
+	switch (Opc) {
+	default:          return 0;
+	case LC3b::BRn:   return LC3bCC::COND_N;
+	case LC3b::BRz:   return LC3bCC::COND_Z;
+	case LC3b::BRp:   return LC3bCC::COND_P;
+	case LC3b::BRnz:  return LC3bCC::COND_NZ;
+	case LC3b::BRnp:  return LC3bCC::COND_NP;
+	case LC3b::BRzp:  return LC3bCC::COND_ZP;
+	case LC3b::BRnzp: return LC3bCC::COND_NZP;
+	}
+}
+
+/// AnalyzeBranch - The condition is the register and mask of a BRcc, or
+/// just the mask of a BR after BRcc has been expanded, when the flags are
+/// already set in the block.
+bool LC3bInstrInfo::AnalyzeBranch(MachineBasicBlock &MBB,
+                                  MachineBasicBlock *&TBB,
+                                  MachineBasicBlock *&FBB,
+                                  SmallVectorImpl<MachineOperand> &Cond,
+                                  bool AllowModify) const {
+	MachineBasicBlock::iterator I = MBB.end();
+	while (I != MBB.begin()) {
+		--I;
+		if (I->isDebugValue())
+			continue;
+		if (!isUnpredicatedTerminator(I))
+			break;
+		// RET, JMP, BRcc32 and anything else we do not understand.
+		if (!I->isBranch() || I->isIndirectBranch())
+			return true;
+
+		unsigned Opc = I->getOpcode();
+		if (Opc == LC3b::BRnzp) {
+			if (!AllowModify) {
+				TBB = I->getOperand(0).getMBB();
+				continue;
+			}
+			// Nothing after an unconditional branch is reached.
+			while (llvm::next(I) != MBB.end())
+				llvm::next(I)->eraseFromParent();
+			Cond.clear();
+			FBB = 0;
+			if (MBB.isLayoutSuccessor(I->getOperand(0).getMBB())) {
+				TBB = 0;
+				I->eraseFromParent();
+				I = MBB.end();
+				continue;
+			}
+			TBB = I->getOperand(0).getMBB();
+			continue;
+		}
+
+		if (Opc != LC3b::BRcc && !getBranchNZP(Opc))
+			return true;
+		// Only one conditional branch per block.
+		if (!Cond.empty())
+			return true;
+		FBB = TBB;
+		TBB = I->getOperand(0).getMBB();
+		if (Opc == LC3b::BRcc) {
+			Cond.push_back(MachineOperand::CreateReg(I->getOperand(1).getReg(),
+			                                         false));
+			Cond.push_back(I->getOperand(2));
+		} else
+			Cond.push_back(MachineOperand::CreateImm(getBranchNZP(Opc)));
+	}
+	return false;
+}
 
+unsigned LC3bInstrInfo::RemoveBranch(MachineBasicBlock &MBB) const {
+	MachineBasicBlock::iterator I = MBB.end();
+	unsigned Count = 0;
+	while (I != MBB.begin()) {
+		--I;
+		if (I->isDebugValue())
+			continue;
+		if (I->getOpcode() != LC3b::BRcc && !getBranchNZP(I->getOpcode()))
+			break;
+		I->eraseFromParent();
+		I = MBB.end();
+		++Count;
+	}
+	return Count;
+}
+
+unsigned LC3bInstrInfo::InsertBranch(MachineBasicBlock &MBB,
+                                     MachineBasicBlock *TBB,
+                                     MachineBasicBlock *FBB,
+                                     const SmallVectorImpl<MachineOperand> &Cond,
+                                     DebugLoc DL) const {
+	assert(TBB && "InsertBranch must not be told to insert a fallthrough");
+	assert((Cond.size() <= 2) && "LC3b branch conditions have two components!");
+
+	if (Cond.empty()) {
+		assert(!FBB && "Unconditional branch with multiple successors!");
+		BuildMI(&MBB, DL, get(LC3b::BRnzp)).addMBB(TBB);
+		return 1;
+	}
+
+	if (Cond.size() == 2)
+		BuildMI(&MBB, DL, get(LC3b::BRcc)).addMBB(TBB)
+			.addReg(Cond[0].getReg()).addImm(Cond[1].getImm());
+	else
+		BuildMI(&MBB, DL, get(getBranchOpcode(Cond[0].getImm()))).addMBB(TBB);
+
+	if (!FBB)
+		return 1;
+	BuildMI(&MBB, DL, get(LC3b::BRnzp)).addMBB(FBB);
+	return 2;
+}
+
+/// ReverseBranchCondition - The complementary mask tests the same flags.
+bool LC3bInstrInfo::
+ReverseBranchCondition(SmallVectorImpl<MachineOperand> &Cond) const {
+	MachineOperand &NZP = Cond.back();
+	unsigned Opposite = ~NZP.getImm() & LC3bCC::COND_NZP;
+	if (!Opposite)
+		return true;
+	NZP.setImm(Opposite);
+	return false;
+}
+
+/// flagsReflect - Whether the n/z/p flags at I were set from the value Reg
+/// holds at I: the last instruction setting them wrote Reg, tested it, or
+/// copied it, and Reg was not changed since.
+static bool flagsReflect(MachineBasicBlock &MBB, MachineBasicBlock::iterator I,
+                         unsigned Reg, const TargetRegisterInfo *TRI) {
+	while (I != MBB.begin()) {
+		--I;
+		if (I->isDebugValue())
+			continue;
+		if (I->isCall() || I->isInlineAsm() || I->hasUnmodeledSideEffects())
+			return false;
+		if (I->modifiesRegister(LC3b::NZP, TRI)) {
+			if (I->getOpcode() == LC3b::TST)
+				return I->getOperand(0).getReg() == Reg;
+			if (I->getNumOperands() < 2 || !I->getOperand(0).isReg() ||
+			    !I->getOperand(0).isDef())
+				return false;
+			if (I->getOperand(0).getReg() == Reg)
+				return true;
+			// ADD Rd, Reg, #0 sets the flags from Reg as well.
+			return I->getOpcode() == LC3b::ADDI && I->getOperand(1).isReg() &&
+			       I->getOperand(1).getReg() == Reg &&
+			       I->getOperand(2).isImm() && I->getOperand(2).getImm() == 0;
+		}
+		if (I->modifiesRegister(Reg, TRI))
+			return false;
+	}
+	return false;
+}
+
+bool LC3bInstrInfo::expandPostRAPseudo(MachineBasicBlock::iterator MI) const {
+	MachineBasicBlock &MBB = *MI->getParent();
+	DebugLoc DL = MI->getDebugLoc();
+
+	switch (MI->getOpcode()) {
+	default:
+		return false;
+	case LC3b::RetLR:
+		// Keep the implicit uses of the return value, the post-RA scheduler
+		// would otherwise rename into it.
+		BuildMI(MBB, MI, DL, get(LC3b::RET)).copyImplicitOps(MI);
+		MBB.erase(MI);
+		return true;
+	case LC3b::LI5: {
+		unsigned Reg = MI->getOperand(0).getReg();
+		int64_t Imm = MI->getOperand(1).getImm();
+		BuildMI(MBB, MI, DL, get(LC3b::ANDI), Reg)
+			.addReg(Reg, RegState::Undef).addImm(0);
+		if (Imm)
+			BuildMI(MBB, MI, DL, get(LC3b::ADDI), Reg)
+				.addReg(Reg, RegState::Kill).addImm(Imm);
+		MBB.erase(MI);
+		return true;
+	}
+	case LC3b::BRcc:
+		break;
+	}
+	const MachineOperand &Val = MI->getOperand(1);
+
+	if (!flagsReflect(MBB, MI, Val.getReg(), &RI))
+		BuildMI(MBB, MI, DL, get(LC3b::TST))
+			.addReg(Val.getReg(), getKillRegState(Val.isKill()));
+	BuildMI(MBB, MI, DL, get(getBranchOpcode(MI->getOperand(2).getImm())))
+		.addMBB(MI->getOperand(0).getMBB());
+
+	MBB.erase(MI);
+	return true;
+}
+
+bool LC3bInstrInfo::isReallyTriviallyReMaterializable(const MachineInstr *MI,
+                                                      AliasAnalysis *AA) const {
+	return MI->getOpcode() == LC3b::LI5;
+}
+
+unsigned LC3bInstrInfo::GetInstSizeInBytes(const MachineInstr *MI) const {
+	switch (MI->getOpcode()) {
+	default:
+		return MI->getDesc().getSize();
+	case LC3b::LI5:
+		return MI->getOperand(1).getImm() ? 4 : 2;
+	case TargetOpcode::INLINEASM: {	// Inline Asm: Variable size.
+		const MachineFunction *MF = MI->getParent()->getParent();
+		const char *AsmStr = MI->getOperand(0).getSymbolName();
+		return getInlineAsmLength(AsmStr, *MF->getTarget().getMCAsmInfo());
+	}
+	}
+}
+
+/// MaxStackAdjustChain - Longest ADD R6, R6, #imm5 chain adjustStackPtr
+/// emits. Past it the amount goes through a register, with at most three
+/// instructions and a pool word to build it and one ADD.
+static const unsigned MaxStackAdjustChain = 3;
+
+void LC3bInstrInfo::adjustStackPtr(int64_t Amount, MachineBasicBlock &MBB,
+                                   MachineBasicBlock::iterator I,
+                                   DebugLoc DL) const {
+	unsigned ChainLength = Amount < 0 ? (-Amount + 15) / 16 : (Amount + 13) / 14;
+	if (ChainLength > MaxStackAdjustChain) {
+		// A register that holds nothing at I: not an argument or return value,
+		// and not a callee saved register, the prologue has yet to save them
+		// and the epilogue has restored them.
+		RegScavenger RS;
+		RS.enterBasicBlock(&MBB);
+		if (I != MBB.begin())
+			RS.forward(llvm::prior(I));
+		BitVector Free = RS.getRegsAvailable(&LC3b::LC3bRegsRegClass);
+		for (const uint16_t *CSR = RI.getCalleeSavedRegs(); *CSR; ++CSR)
+			Free.reset(*CSR);
+		int Reg = Free.find_first();
+		if (Reg != -1) {
+			loadImmediate(Amount, Reg, MBB, I, DL);
+			BuildMI(MBB, I, DL, get(LC3b::ADD), LC3b::R6)
+				.addReg(LC3b::R6).addReg(Reg, RegState::Kill);
+			return;
+		}
+	}
+
+	// imm5 covers [-16, 15]; keep every step even so R6 stays word aligned.
+	while (Amount != 0) {
+		int64_t Step = Amount < 0 ? std::max<int64_t>(Amount, -16)
+		                          : std::min<int64_t>(Amount, 14);
+		BuildMI(MBB, I, DL, get(LC3b::ADDI), LC3b::R6)
+			.addReg(LC3b::R6).addImm(Step);
+		Amount -= Step;
+	}
+}
+
+//===----------------------------------------------------------------------===//
+// Constant materialization
+//===----------------------------------------------------------------------===//
+
+/// MaxImmSequence - Longest ALU sequence getImmSequence looks for. Within
+/// LEA range of the constant pool, LEA+LDW is faster than any sequence
+/// beyond simm5 and as large as three instructions. Out of range, LONG_LEA
+/// and LDW take 49 cycles and 12 bytes with the entry, five instructions
+/// still beat them; a sixth never does.
+static const unsigned MaxImmSequence = 5;
+
+namespace {
+	/// ImmSequenceTable - Shortest way to build every 16-bit value from a
+	/// cleared register, filled breadth first on the first query. Entry V
+	/// holds the last instruction of the sequence and the value it is
+	/// applied to.
+	struct ImmSequenceTable {
+		struct Entry {
+			uint16_t Opcode;	// 0 if V is not reachable in MaxImmSequence
+			int8_t Imm;
+			uint8_t Length;
+			uint16_t Prev;
+		};
+		Entry Entries[1 << 16];
+
+		ImmSequenceTable();
+
+	private:
+		void visit(std::vector<uint16_t> &Worklist, uint16_t From,
+		           uint16_t To, unsigned Opcode, int Imm) {
+			Entry &E = Entries[To];
+			if (E.Opcode)
+				return;
+			E.Opcode = Opcode;
+			E.Imm = Imm;
+			E.Length = Entries[From].Length + 1;
+			E.Prev = From;
+			Worklist.push_back(To);
+		}
+	};
+}
+
+ImmSequenceTable::ImmSequenceTable() {
+	memset(Entries, 0, sizeof(Entries));
+	Entries[0].Opcode = LC3b::ANDI;
+	Entries[0].Length = 1;
+
+	std::vector<uint16_t> Worklist(1, 0);
+	for (unsigned i = 0; i != Worklist.size(); ++i) {
+		uint16_t V = Worklist[i];
+		if (Entries[V].Length == MaxImmSequence)
+			continue;
+		for (int Imm = -16; Imm != 16; ++Imm) {
+			if (Imm == 0)
+				continue;
+			visit(Worklist, V, V + Imm, LC3b::ADDI, Imm);
+			visit(Worklist, V, V ^ uint16_t(Imm), LC3b::XORI, Imm);
+			visit(Worklist, V, V & uint16_t(Imm), LC3b::ANDI, Imm);
+		}
+		for (int Amt = 1; Amt != 16; ++Amt) {
+			visit(Worklist, V, V << Amt, LC3b::LSHF, Amt);
+			visit(Worklist, V, V >> Amt, LC3b::RSHFL, Amt);
+			visit(Worklist, V, int16_t(V) >> Amt, LC3b::RSHFA, Amt);
+		}
+	}
+}
+
+static ManagedStatic<ImmSequenceTable> ImmSequences;
+
+bool LC3bInstrInfo::getImmSequence(int64_t Imm, ImmSequence &Seq) {
+	assert((isInt<16>(Imm) || isUInt<16>(Imm)) && "Not a 16-bit constant");
+	const ImmSequenceTable::Entry *Entries = ImmSequences->Entries;
+	uint16_t V = Imm;
+	if (!Entries[V].Opcode)
+		return false;
+
+	Seq.resize(Entries[V].Length, ImmInst(LC3b::ANDI, 0));
+	for (unsigned i = Seq.size(); i-- != 1; V = Entries[V].Prev)
+		Seq[i] = ImmInst(Entries[V].Opcode, Entries[V].Imm);
+	return true;
+}
+
+unsigned LC3bInstrInfo::getOpcodeLatency(unsigned Opcode) const {
+	const InstrItineraryData *Itins = TM.getInstrItineraryData();
+	if (!Itins || Itins->isEmpty())
+		return 1;
+	return Itins->getStageLatency(get(Opcode).getSchedClass());
+}
+
+bool LC3bInstrInfo::isConstantPoolCheaper(const ImmSequence &Seq, bool OptSize,
+                                          bool FarPool) const {
+	if (Seq.empty())
+		return true;
+
+	// LEA+LDW, or LONG_LEA+LDW out of range, plus the pool entry itself.
+	unsigned Lea = FarPool ? LC3b::LONG_LEA : LC3b::LEA;
+	unsigned PoolCycles = getOpcodeLatency(Lea) + getOpcodeLatency(LC3b::LDW);
+	unsigned PoolSize = get(Lea).getSize() + get(LC3b::LDW).getSize() + 2;
+
+	unsigned SeqCycles = 0, SeqSize = 0;
+	for (unsigned i = 0, e = Seq.size(); i != e; ++i) {
+		SeqCycles += getOpcodeLatency(Seq[i].Opcode);
+		SeqSize += get(Seq[i].Opcode).getSize();
+	}
+
+	if (OptSize && PoolSize != SeqSize)
+		return PoolSize < SeqSize;
+	if (PoolCycles != SeqCycles)
+		return PoolCycles < SeqCycles;
+	return PoolSize < SeqSize;
+}
+
+/// isPoolOutOfRange - Whether the constant pool, emitted after the code of
+/// the function, may be past the reach of an LEA at I.
+static bool isPoolOutOfRange(const LC3bInstrInfo &TII, MachineBasicBlock &MBB,
+                             MachineBasicBlock::iterator I) {
+	uint64_t Bytes = 0;
+	for (MachineBasicBlock::iterator E = MBB.end(); I != E; ++I)
+		Bytes += TII.GetInstSizeInBytes(I);
+	MachineFunction::iterator MFI = &MBB, MFE = MBB.getParent()->end();
+	for (++MFI; MFI != MFE; ++MFI)
+		for (MachineBasicBlock::iterator MI = MFI->begin(), ME = MFI->end();
+		     MI != ME; ++MI)
+			Bytes += TII.GetInstSizeInBytes(MI);
+	return !isInt<9>(Bytes / 2);
+}
+
+void LC3bInstrInfo::loadImmediate(int64_t Imm, unsigned Reg,
+                                  MachineBasicBlock &MBB,
+                                  MachineBasicBlock::iterator I,
+                                  DebugLoc DL) const {
+	MachineFunction &MF = *MBB.getParent();
+	bool OptSize = MF.getFunction()->getAttributes().
+		hasAttribute(AttributeSet::FunctionIndex, Attribute::OptimizeForSize);
+
+	ImmSequence Seq;
+	if (!getImmSequence(Imm, Seq) ||
+	    isConstantPoolCheaper(Seq, OptSize, isPoolOutOfRange(*this, MBB, I))) {
+		// LEA Reg, CPI; LDW Reg, Reg, #0. Equal constants share the entry.
+		const Constant *C =
+			ConstantInt::get(Type::getInt16Ty(MF.getFunction()->getContext()),
+			                 Imm);
+		unsigned CPI = MF.getConstantPool()->getConstantPoolIndex(C, 2);
+		MachineMemOperand *MMO =
+			MF.getMachineMemOperand(MachinePointerInfo::getConstantPool(),
+			                        MachineMemOperand::MOLoad, 2, 2);
+		BuildMI(MBB, I, DL, get(LC3b::LEA), Reg).addConstantPoolIndex(CPI);
+		BuildMI(MBB, I, DL, get(LC3b::LDW), Reg)
+			.addReg(Reg, RegState::Kill).addImm(0).addMemOperand(MMO);
+		return;
+	}
+
+	// AND Reg, Reg, #0 clears the register whatever it held.
+	BuildMI(MBB, I, DL, get(LC3b::ANDI), Reg)
+		.addReg(Reg, RegState::Undef).addImm(0);
+	for (unsigned i = 1, e = Seq.size(); i != e; ++i)
+		BuildMI(MBB, I, DL, get(Seq[i].Opcode), Reg)
+			.addReg(Reg, RegState::Kill).addImm(Seq[i].Imm);
+}
@@ -7,7 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file contains the Cpu0 implementation of the TargetInstrInfo class.
+// This file contains the LC3b implementation of the TargetInstrInfo class.
 //
 //===----------------------------------------------------------------------===//
 #ifndef LC3bINSTRUCTIONINFO_H
@@ -15,13 +15,10 @@
 
 #include "LC3b.h"
 #include "LC3bRegisterInfo.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Target/TargetInstrInfo.h"
 
-#define GET_INSTRINFO_HEADER
-#include "LC3bGenInstrInfo.inc"
-
-
 #define GET_INSTRINFO_HEADER
 #include "LC3bGenInstrInfo.inc"
 
@@ -30,19 +27,94 @@ namespace llvm {
 		LC3bTargetMachine &TM;
 		const LC3bRegisterInfo RI;
 	public:
+		/// ImmInst - One instruction of an ALU sequence building a constant.
+		/// The first one is always AND Rd, Rd, #0, every other one takes the
+		/// previous result as its register operand.
+		struct ImmInst {
+			unsigned Opcode;
+			int64_t Imm;
+			ImmInst(unsigned Opc, int64_t I) : Opcode(Opc), Imm(I) {}
+		};
+		typedef SmallVector<ImmInst, 8> ImmSequence;
+
 		explicit LC3bInstrInfo(LC3bTargetMachine &TM);
 		/// getRegisterInfo - TargetInstrInfo is a superset of MRegister info. As
 		/// such, whenever a client has an instance of instruction info, it should
 		/// always be able to get register info as well (through this method).
 		///
 		virtual const LC3bRegisterInfo &getRegisterInfo() const;
-	};
 
-	class LC3bInstrInfo : public LC3bGenInstrInfo {
-		LC3bTargetMachine &TM;
-	public:
-		explicit LC3bInstrInfo(LC3bTargetMachine &TM);
+		/// copyPhysReg - LC3b has no move, copies are ADD Rd, Rs, #0.
+		virtual void copyPhysReg(MachineBasicBlock &MBB,
+		                         MachineBasicBlock::iterator MI, DebugLoc DL,
+		                         unsigned DestReg, unsigned SrcReg,
+		                         bool KillSrc) const;
+
+		virtual void storeRegToStackSlot(MachineBasicBlock &MBB,
+		                                 MachineBasicBlock::iterator MI,
+		                                 unsigned SrcReg, bool isKill, int FrameIndex,
+		                                 const TargetRegisterClass *RC,
+		                                 const TargetRegisterInfo *TRI) const;
+
+		virtual void loadRegFromStackSlot(MachineBasicBlock &MBB,
+		                                  MachineBasicBlock::iterator MI,
+		                                  unsigned DestReg, int FrameIndex,
+		                                  const TargetRegisterClass *RC,
+		                                  const TargetRegisterInfo *TRI) const;
+
+		/// Branch analysis. The condition is either the register and n/z/p
+		/// mask of a BRcc, or just the mask of an expanded BR.
+		virtual bool AnalyzeBranch(MachineBasicBlock &MBB, MachineBasicBlock *&TBB,
+		                           MachineBasicBlock *&FBB,
+		                           SmallVectorImpl<MachineOperand> &Cond,
+		                           bool AllowModify) const;
+		virtual unsigned RemoveBranch(MachineBasicBlock &MBB) const;
+		virtual unsigned InsertBranch(MachineBasicBlock &MBB, MachineBasicBlock *TBB,
+		                              MachineBasicBlock *FBB,
+		                              const SmallVectorImpl<MachineOperand> &Cond,
+		                              DebugLoc DL) const;
+		virtual
+		bool ReverseBranchCondition(SmallVectorImpl<MachineOperand> &Cond) const;
+
+		/// expandPostRAPseudo - BRcc becomes TST and a BR on the n/z/p mask, or
+		/// just the BR when the flags already come from the tested register.
+		virtual bool expandPostRAPseudo(MachineBasicBlock::iterator MI) const;
+
+		/// isReallyTriviallyReMaterializable - LI5 only defines the flags on top
+		/// of its result, and they never live across its position before
+		/// register allocation.
+		virtual bool isReallyTriviallyReMaterializable(const MachineInstr *MI,
+		                                               AliasAnalysis *AA) const;
+
+		/// GetInstSizeInBytes - Return the number of bytes of code the specified
+		/// instruction may be.
+		unsigned GetInstSizeInBytes(const MachineInstr *MI) const;
+
+		/// adjustStackPtr - Add Amount to R6 with a short chain of
+		/// ADD R6, R6, #imm5, or with one ADD of a free register the amount is
+		/// loaded into.
+		void adjustStackPtr(int64_t Amount, MachineBasicBlock &MBB,
+		                    MachineBasicBlock::iterator I, DebugLoc DL) const;
+
+		/// getImmSequence - Find the shortest AND/ADD/XOR/LSHF sequence that
+		/// builds Imm from a cleared register. Returns false when every sequence
+		/// is longer than MaxImmSequence instructions.
+		static bool getImmSequence(int64_t Imm, ImmSequence &Seq);
+
+		/// getOpcodeLatency - Cycles of Opcode according to the itineraries.
+		unsigned getOpcodeLatency(unsigned Opcode) const;
+
+		/// isConstantPoolCheaper - Whether LEA+LDW from the constant pool beats
+		/// the ALU sequence Seq (empty if there is none). FarPool charges the
+		/// LONG_LEA of a pool out of LEA range instead. Cycles decide, code
+		/// size breaks ties; under OptSize it is the other way around.
+		bool isConstantPoolCheaper(const ImmSequence &Seq, bool OptSize,
+		                           bool FarPool) const;
+
+		/// loadImmediate - Materialize the 16-bit constant Imm in Reg, with the
+		/// cheapest of an ALU sequence and a constant pool load.
+		void loadImmediate(int64_t Imm, unsigned Reg, MachineBasicBlock &MBB,
+		                   MachineBasicBlock::iterator I, DebugLoc DL) const;
 	};
 }
 #endif
-
@@ -0,0 +1,608 @@
+//===-- LC3bLongBranch.cpp - Emit long branches ---------------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass expands a BR into a long branch if its target is out of the
+// PCoffset9 range (-256..255 words from the next instruction). Block offsets
+// are computed from instruction sizes, only the branches out of range are
+// rewritten, so the common case stays a single BR:
+//
+//	BRcc	$tgt          BR!cc	$fallthrough
+//	                  $longbr:
+//	                      LEA	Rx, #2
+//	                      LDW	Rx, Rx, #0
+//	                      JMP	Rx
+//	                      .2byte	$tgt
+//	                  $fallthrough:
+//
+// Rx is a register that is not live into $tgt.
+//
+// The constant pool and the jump tables follow the function in .text, see
+// LC3bAsmPrinter::EmitFunctionBodyEnd. An LEA of one of their entries that
+// is out of range becomes a LONG_LEA, which loads the address from a literal:
+//
+//	LEA	Rx, $cpi          LEA	Rx, #1
+//	                      BRnzp	#1
+//	                      .2byte	$cpi
+//	                      LDW	Rx, Rx, #0
+//
+// Unlike LEA, the LDW sets the flags. If a branch after the LEA tests flags
+// set before it, the LONG_LEA moves in front of the instruction setting them.
+//
+// JSR reaches -1024..1023 words. Functions are laid out in .text in module
+// order, so only a recursive call or a call to a function emitted before has
+// a known distance. A JSR to any other callee, or out of range of its callee,
+// becomes a LONG_CALL, which calls through R7 loaded from a literal:
+//
+//	JSR	$callee       LEA	R7, #1
+//	                      BRnzp	#1
+//	                      .2byte	$callee
+//	                      LDW	R7, R7, #0
+//	                      JSRR	R7
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "lc3b-long-branch"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/CodeGen/MachineConstantPool.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineJumpTableInfo.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(LongBranches, "Number of long branches.");
+STATISTIC(LongLEAs,     "Number of LEAs out of range of the constant pool.");
+STATISTIC(LongCalls,    "Number of calls through a literal.");
+
+static cl::opt<bool> SkipLongBranch(
+	"skip-lc3b-long-branch",
+	cl::init(false),
+	cl::desc("LC3b: Skip long branch pass."),
+	cl::Hidden);
+
+static cl::opt<bool> ForceLongBranch(
+	"force-lc3b-long-branch",
+	cl::init(false),
+	cl::desc("LC3b: Expand all branches to long format."),
+	cl::Hidden);
+
+namespace {
+	typedef MachineBasicBlock::iterator Iter;
+	typedef MachineBasicBlock::reverse_iterator ReverseIter;
+
+	struct MBBInfo {
+		uint64_t Size;
+		bool HasLongBranch;
+		MachineInstr *Br;
+
+		MBBInfo() : Size(0), HasLongBranch(false), Br(0) {}
+	};
+
+	class LC3bLongBranch : public MachineFunctionPass {
+	public:
+		static char ID;
+		LC3bLongBranch(TargetMachine &tm)
+			: MachineFunctionPass(ID), TM(tm),
+			  TII(static_cast<const LC3bInstrInfo*>(tm.getInstrInfo())) {}
+
+		virtual const char *getPassName() const {
+			return "LC3b Long Branch";
+		}
+
+		virtual bool doInitialization(Module &M);
+		bool runOnMachineFunction(MachineFunction &F);
+
+	private:
+		void splitMBB(MachineBasicBlock *MBB);
+		void initMBBInfo();
+		void initPoolOffsets();
+		bool isInText(const Function &F) const;
+		void recordFunction();
+		int64_t computeOffset(const MachineInstr *Br);
+		int64_t computeInstrEnd(const MachineInstr *MI);
+		int64_t computeLEAOffset(const MachineInstr *LEA);
+		bool isCallInRange(const MachineInstr *JSR);
+		unsigned getScratchReg(const MachineBasicBlock &TgtMBB);
+		void expandToLongBranch(MBBInfo &Info);
+		void expandToLongLEA(MachineInstr *LEA);
+
+		const TargetMachine &TM;
+		const LC3bInstrInfo *TII;
+		MachineFunction *MF;
+		SmallVector<MBBInfo, 16> MBBInfos;
+		// The LEAs of constant pool entries and jump tables, those that need
+		// a LONG_LEA, and where the entries are from the end of the code.
+		SmallVector<MachineInstr*, 16> PoolLEAs;
+		SmallPtrSet<MachineInstr*, 4> LongPoolLEAs;
+		SmallVector<uint64_t, 16> CPOffsets, JTOffsets;
+		uint64_t PoolSize;
+		// The JSRs and those that become a LONG_CALL.
+		SmallVector<MachineInstr*, 16> Calls;
+		SmallPtrSet<MachineInstr*, 4> LongCallSet;
+		// Where the functions of the module laid out so far start in .text,
+		// where its end is, and where the current function starts.
+		DenseMap<const Function*, uint64_t> FunctionAddrs;
+		uint64_t TextSize, FunctionAddr;
+	};
+
+	char LC3bLongBranch::ID = 0;
+} // end of anonymous namespace
+
+/// createLC3bLongBranchPass - Returns a pass that converts branches to long
+/// branches.
+FunctionPass *llvm::createLC3bLongBranchPass(LC3bTargetMachine &tm) {
+	return new LC3bLongBranch(tm);
+}
+
+/// LongBranchSeqSize - LEA, LDW, JMP and the address literal.
+static const unsigned LongBranchSeqSize = 8;
+
+/// LongLEAGrowth - A LONG_LEA is LEA, BR, the literal and LDW in place of
+/// the LEA.
+static const unsigned LongLEAGrowth = 6;
+
+/// LongCallGrowth - A LONG_CALL is LEA, BR, the literal, LDW and JSRR in
+/// place of the JSR.
+static const unsigned LongCallGrowth = 8;
+
+/// isDirectBranch - BRn ... BRnzp, the branches with a PCoffset9 target.
+static bool isDirectBranch(const MachineInstr &MI) {
+	return MI.isBranch() && !MI.isIndirectBranch();
+}
+
+/// isPoolLEA - The LEA of a constant pool entry or a jump table.
+static bool isPoolLEA(const MachineInstr &MI) {
+	return MI.getOpcode() == LC3b::LEA &&
+	       (MI.getOperand(1).isCPI() || MI.getOperand(1).isJTI());
+}
+
+/// getOppositeBranchOpc - The BR testing the complementary n/z/p bits.
+static unsigned getOppositeBranchOpc(unsigned Opc) {
+	switch (Opc) {
+	default: llvm_unreachable("Illegal opcode!");
+	case LC3b::BRn:  return LC3b::BRzp;
+	case LC3b::BRzp: return LC3b::BRn;
+	case LC3b::BRz:  return LC3b::BRnp;
+	case LC3b::BRnp: return LC3b::BRz;
+	case LC3b::BRp:  return LC3b::BRnz;
+	case LC3b::BRnz: return LC3b::BRp;
+	}
+}
+
+// Traverse the list of instructions backwards until a non-debug instruction is
+// found or it reaches E.
+static ReverseIter getNonDebugInstr(ReverseIter B, ReverseIter E) {
+	for (; B != E; ++B)
+		if (!B->isDebugValue())
+			return B;
+
+	return E;
+}
+
+// Split MBB if it has two direct branches.
+void LC3bLongBranch::splitMBB(MachineBasicBlock *MBB) {
+	ReverseIter End = MBB->rend();
+	ReverseIter LastBr = getNonDebugInstr(MBB->rbegin(), End);
+
+	// Return if MBB has no branch instructions.
+	if (LastBr == End || !isDirectBranch(*LastBr))
+		return;
+
+	ReverseIter FirstBr = getNonDebugInstr(llvm::next(LastBr), End);
+
+	// MBB has only one branch instruction if FirstBr is not a branch
+	// instruction.
+	if (FirstBr == End || !isDirectBranch(*FirstBr))
+		return;
+
+	// Create a new MBB. Move instructions in MBB to the newly created MBB.
+	MachineBasicBlock *NewMBB =
+		MF->CreateMachineBasicBlock(MBB->getBasicBlock());
+
+	// Insert NewMBB and fix control flow.
+	MachineBasicBlock *Tgt = FirstBr->getOperand(0).getMBB();
+	NewMBB->transferSuccessors(MBB);
+	NewMBB->removeSuccessor(Tgt);
+	MBB->addSuccessor(NewMBB);
+	MBB->addSuccessor(Tgt);
+	MF->insert(llvm::next(MachineFunction::iterator(MBB)), NewMBB);
+
+	NewMBB->splice(NewMBB->end(), MBB, (++LastBr).base(), MBB->end());
+
+	// The registers live out of MBB into the new block are its live-ins.
+	for (MachineBasicBlock::succ_iterator SI = NewMBB->succ_begin(),
+	     SE = NewMBB->succ_end(); SI != SE; ++SI)
+		for (MachineBasicBlock::livein_iterator LI = (*SI)->livein_begin(),
+		     LE = (*SI)->livein_end(); LI != LE; ++LI)
+			if (!NewMBB->isLiveIn(*LI))
+				NewMBB->addLiveIn(*LI);
+}
+
+// Fill MBBInfos.
+void LC3bLongBranch::initMBBInfo() {
+	// Split the MBBs if they have two branches. Each basic block should have at
+	// most one branch after this loop is executed.
+	for (MachineFunction::iterator I = MF->begin(), E = MF->end(); I != E;)
+		splitMBB(I++);
+
+	MF->RenumberBlocks();
+	MBBInfos.clear();
+	MBBInfos.resize(MF->size());
+	PoolLEAs.clear();
+	LongPoolLEAs.clear();
+	Calls.clear();
+	LongCallSet.clear();
+
+	for (unsigned I = 0, E = MBBInfos.size(); I < E; ++I) {
+		MachineBasicBlock *MBB = MF->getBlockNumbered(I);
+
+		// Compute size of MBB.
+		for (MachineBasicBlock::instr_iterator MI = MBB->instr_begin();
+		     MI != MBB->instr_end(); ++MI) {
+			MBBInfos[I].Size += TII->GetInstSizeInBytes(&*MI);
+			if (isPoolLEA(*MI))
+				PoolLEAs.push_back(&*MI);
+			else if (MI->getOpcode() == LC3b::JSR)
+				Calls.push_back(&*MI);
+		}
+
+		// Search for MBB's branch instruction.
+		ReverseIter End = MBB->rend();
+		ReverseIter Br = getNonDebugInstr(MBB->rbegin(), End);
+
+		if (Br != End && isDirectBranch(*Br))
+			MBBInfos[I].Br = (++Br).base();
+	}
+}
+
+// Compute offset of branch in number of bytes, from the instruction after
+// it. The branch is the last instruction of its block.
+int64_t LC3bLongBranch::computeOffset(const MachineInstr *Br) {
+	int64_t Offset = 0;
+	int ThisMBB = Br->getParent()->getNumber();
+	int TargetMBB = Br->getOperand(0).getMBB()->getNumber();
+
+	// Compute offset of a forward branch.
+	if (ThisMBB < TargetMBB) {
+		for (int N = ThisMBB + 1; N < TargetMBB; ++N)
+			Offset += MBBInfos[N].Size;
+
+		return Offset;
+	}
+
+	// Compute offset of a backward branch.
+	for (int N = ThisMBB; N >= TargetMBB; --N)
+		Offset += MBBInfos[N].Size;
+
+	return -Offset;
+}
+
+// Fill CPOffsets and JTOffsets, the distance of each constant pool entry and
+// jump table from the end of the code, in the order LC3bAsmPrinter emits
+// them.
+void LC3bLongBranch::initPoolOffsets() {
+	const DataLayout &TD = *TM.getDataLayout();
+	const std::vector<MachineConstantPoolEntry> &CP =
+		MF->getConstantPool()->getConstants();
+	uint64_t Offset = 0;
+
+	CPOffsets.clear();
+	for (unsigned i = 0, e = CP.size(); i != e; ++i) {
+		Offset = RoundUpToAlignment(Offset, CP[i].getAlignment());
+		CPOffsets.push_back(Offset);
+		Offset += TD.getTypeAllocSize(CP[i].getType());
+	}
+
+	JTOffsets.clear();
+	if (const MachineJumpTableInfo *MJTI = MF->getJumpTableInfo()) {
+		const std::vector<MachineJumpTableEntry> &JT = MJTI->getJumpTables();
+		for (unsigned i = 0, e = JT.size(); i != e; ++i) {
+			Offset = RoundUpToAlignment(Offset, MJTI->getEntryAlignment(TD));
+			JTOffsets.push_back(Offset);
+			Offset += JT[i].MBBs.size() * MJTI->getEntrySize(TD);
+		}
+	}
+	PoolSize = Offset;
+}
+
+// A function in .text proper, where the functions before it in the module
+// are. Weak functions and explicit sections go elsewhere.
+bool LC3bLongBranch::isInText(const Function &F) const {
+	return !F.hasSection() && !F.isWeakForLinker() &&
+	       !TargetMachine::getFunctionSections();
+}
+
+// Note where the current function, its constant pool and jump tables end
+// up, for the calls of the functions after it.
+void LC3bLongBranch::recordFunction() {
+	const Function &F = *MF->getFunction();
+	if (!isInText(F))
+		return;
+
+	uint64_t Size = 0;
+	for (unsigned N = 0, E = MBBInfos.size(); N != E; ++N)
+		Size += MBBInfos[N].Size;
+	FunctionAddrs[&F] = FunctionAddr;
+	TextSize = FunctionAddr + Size + PoolSize;
+}
+
+// Compute offset of the instruction after MI in number of bytes, from the
+// start of the function. MI itself is counted in its short form.
+int64_t LC3bLongBranch::computeInstrEnd(const MachineInstr *MI) {
+	const MachineBasicBlock *MBB = MI->getParent();
+	int64_t Addr = 0;
+
+	for (int N = 0; N < MBB->getNumber(); ++N)
+		Addr += MBBInfos[N].Size;
+	for (MachineBasicBlock::const_instr_iterator I = MBB->instr_begin();
+	     &*I != MI; ++I) {
+		MachineInstr *Prev = const_cast<MachineInstr*>(&*I);
+		Addr += TII->GetInstSizeInBytes(Prev);
+		if (LongPoolLEAs.count(Prev))
+			Addr += LongLEAGrowth;
+		else if (LongCallSet.count(Prev))
+			Addr += LongCallGrowth;
+	}
+	return Addr + TII->GetInstSizeInBytes(MI);
+}
+
+// Compute offset of the entry an LEA addresses in number of bytes, from the
+// instruction after the LEA.
+int64_t LC3bLongBranch::computeLEAOffset(const MachineInstr *LEA) {
+	int64_t End = 0;
+	for (unsigned N = 0, E = MBBInfos.size(); N != E; ++N)
+		End += MBBInfos[N].Size;
+
+	const MachineOperand &MO = LEA->getOperand(1);
+	// A jump table operand carries no offset, its index is added at run time.
+	int64_t Entry = MO.isCPI() ? CPOffsets[MO.getIndex()] + MO.getOffset()
+	                           : JTOffsets[MO.getIndex()];
+	return End + Entry - computeInstrEnd(LEA);
+}
+
+// Check that a JSR reaches its callee, which needs the callee's address
+// relative to the current function.
+bool LC3bLongBranch::isCallInRange(const MachineInstr *JSR) {
+	const MachineOperand &MO = JSR->getOperand(0);
+	if (!MO.isGlobal())
+		return false;
+
+	const Function *F = MF->getFunction();
+	const Function *Callee = dyn_cast<Function>(MO.getGlobal());
+	int64_t Start;
+	if (Callee == F)
+		Start = 0;
+	else {
+		DenseMap<const Function*, uint64_t>::iterator I =
+			FunctionAddrs.find(Callee);
+		if (!isInText(*F) || I == FunctionAddrs.end())
+			return false;
+		Start = (int64_t)I->second - (int64_t)FunctionAddr;
+	}
+	return isInt<11>((Start + MO.getOffset() - computeInstrEnd(JSR)) / 2);
+}
+
+// Find a register the long branch can clobber, one that does not hold a value
+// TgtMBB needs. R6 is the stack pointer; the callee saved R4, R5 and R7 (the
+// return address) only qualify when the prologue saved them.
+unsigned LC3bLongBranch::getScratchReg(const MachineBasicBlock &TgtMBB) {
+	const TargetRegisterInfo *TRI = TM.getRegisterInfo();
+	const std::vector<CalleeSavedInfo> &CSI =
+		MF->getFrameInfo()->getCalleeSavedInfo();
+	const uint16_t *CSRegs = TRI->getCalleeSavedRegs(MF);
+	ArrayRef<MCPhysReg> Order =
+		LC3b::LC3bRegsRegClass.getRawAllocationOrder(*MF);
+
+	for (unsigned i = 0; i != Order.size(); ++i) {
+		unsigned Reg = Order[i];
+		if (Reg == LC3b::R6)
+			continue;
+
+		bool Saved = true;
+		for (const uint16_t *CSR = CSRegs; *CSR && Saved; ++CSR)
+			if (*CSR == Reg) {
+				Saved = false;
+				for (unsigned j = 0; j != CSI.size(); ++j)
+					Saved |= CSI[j].getReg() == Reg;
+			}
+		if (!Saved)
+			continue;
+
+		bool Live = false;
+		for (MachineBasicBlock::livein_iterator LI = TgtMBB.livein_begin(),
+		     LE = TgtMBB.livein_end(); LI != LE && !Live; ++LI)
+			Live = TRI->regsOverlap(*LI, Reg);
+		if (!Live)
+			return Reg;
+	}
+
+	report_fatal_error("LC3b: no free register for a long branch in " +
+	                   Twine(MF->getName()));
+}
+
+// Expand branch instructions to long branches.
+void LC3bLongBranch::expandToLongBranch(MBBInfo &I) {
+	MachineBasicBlock *MBB = I.Br->getParent();
+	MachineBasicBlock *TgtMBB = I.Br->getOperand(0).getMBB();
+	DebugLoc DL = I.Br->getDebugLoc();
+	MachineFunction::iterator FallThroughMBB = ++MachineFunction::iterator(MBB);
+	MachineBasicBlock *LongBrMBB = MF->CreateMachineBasicBlock(MBB->getBasicBlock());
+
+	MF->insert(FallThroughMBB, LongBrMBB);
+	MBB->removeSuccessor(TgtMBB);
+	MBB->addSuccessor(LongBrMBB);
+	LongBrMBB->addSuccessor(TgtMBB);
+	for (MachineBasicBlock::livein_iterator LI = TgtMBB->livein_begin(),
+	     LE = TgtMBB->livein_end(); LI != LE; ++LI)
+		LongBrMBB->addLiveIn(*LI);
+
+	// $longbr:
+	//  LEA Rx, #2        ; Rx = address of the literal
+	//  LDW Rx, Rx, #0
+	//  JMP Rx
+	//  .2byte $tgt
+	unsigned Reg = getScratchReg(*TgtMBB);
+	MachineBasicBlock::iterator Pos = LongBrMBB->end();
+	BuildMI(*LongBrMBB, Pos, DL, TII->get(LC3b::LEA), Reg).addImm(2);
+	BuildMI(*LongBrMBB, Pos, DL, TII->get(LC3b::LDW), Reg)
+		.addReg(Reg, RegState::Kill).addImm(0);
+	BuildMI(*LongBrMBB, Pos, DL, TII->get(LC3b::JMP))
+		.addReg(Reg, RegState::Kill);
+	BuildMI(*LongBrMBB, Pos, DL, TII->get(LC3b::LONG_BRANCH_ADDR))
+		.addMBB(TgtMBB);
+
+	DEBUG(dbgs() << "LC3b: long branch from BB#" << MBB->getNumber()
+	             << " to BB#" << TgtMBB->getNumber() << " through "
+	             << TM.getRegisterInfo()->getName(Reg) << "\n");
+
+	if (I.Br->isUnconditionalBranch()) {
+		// $longbr directly follows MBB now, fall through into it.
+		I.Br->eraseFromParent();
+		return;
+	}
+
+	// Branch around $longbr with the opposite condition.
+	assert(FallThroughMBB != MF->end() &&
+	       "Conditional branch at the end of the function");
+	BuildMI(*MBB, I.Br, DL, TII->get(getOppositeBranchOpc(I.Br->getOpcode())))
+		.addMBB(FallThroughMBB);
+	I.Br->eraseFromParent();
+}
+
+// Replace an LEA out of range of its constant pool entry or jump table by a
+// LONG_LEA. LDW clobbers the flags, so if they are tested after the LEA
+// before being set again, the LONG_LEA goes in front of the instruction that
+// set them. Rx must not be used between the two.
+void LC3bLongBranch::expandToLongLEA(MachineInstr *LEA) {
+	MachineBasicBlock *MBB = LEA->getParent();
+	const TargetRegisterInfo *TRI = TM.getRegisterInfo();
+	unsigned Reg = LEA->getOperand(0).getReg();
+	MachineBasicBlock::iterator Pos = LEA;
+
+	bool FlagsLive = false;
+	for (MachineBasicBlock::iterator I = llvm::next(Pos), E = MBB->end();
+	     I != E; ++I) {
+		if (I->readsRegister(LC3b::NZP, TRI)) {
+			FlagsLive = true;
+			break;
+		}
+		if (I->modifiesRegister(LC3b::NZP, TRI))
+			break;
+	}
+
+	if (FlagsLive) {
+		while (Pos != MBB->begin()) {
+			--Pos;
+			if (Pos->readsRegister(Reg, TRI) || Pos->modifiesRegister(Reg, TRI) ||
+			    Pos->isCall())
+				report_fatal_error("LC3b: constant pool out of range in " +
+				                   Twine(MF->getName()));
+			if (Pos->modifiesRegister(LC3b::NZP, TRI))
+				break;
+		}
+	}
+
+	MachineInstr *LongLEA =
+		BuildMI(*MBB, Pos, LEA->getDebugLoc(), TII->get(LC3b::LONG_LEA), Reg);
+	LongLEA->addOperand(LEA->getOperand(1));
+	LEA->eraseFromParent();
+}
+
+bool LC3bLongBranch::doInitialization(Module &M) {
+	FunctionAddrs.clear();
+	TextSize = 0;
+	return false;
+}
+
+bool LC3bLongBranch::runOnMachineFunction(MachineFunction &F) {
+	if (SkipLongBranch)
+		return false;
+
+	MF = &F;
+	FunctionAddr = RoundUpToAlignment(TextSize, UINT64_C(1) << F.getAlignment());
+	initMBBInfo();
+	initPoolOffsets();
+
+	SmallVector<MBBInfo, 16>::iterator I, E = MBBInfos.end();
+	bool EverMadeChange = false, MadeChange = true;
+
+	// Expanding a branch moves the blocks after it, so iterate until no
+	// other branch goes out of range.
+	while (MadeChange) {
+		MadeChange = false;
+
+		for (I = MBBInfos.begin(); I != E; ++I) {
+			// Skip if this MBB doesn't have a branch or the branch has already
+			// been converted to a long branch.
+			if (!I->Br || I->HasLongBranch)
+				continue;
+
+			// Check if the word offset fits into PCoffset9.
+			if (!ForceLongBranch && isInt<9>(computeOffset(I->Br) / 2))
+				continue;
+
+			I->HasLongBranch = true;
+			I->Size += LongBranchSeqSize;
+			++LongBranches;
+			EverMadeChange = MadeChange = true;
+		}
+
+		for (unsigned i = 0, e = PoolLEAs.size(); i != e; ++i) {
+			MachineInstr *LEA = PoolLEAs[i];
+			if (LongPoolLEAs.count(LEA) || isInt<9>(computeLEAOffset(LEA) / 2))
+				continue;
+
+			LongPoolLEAs.insert(LEA);
+			MBBInfos[LEA->getParent()->getNumber()].Size += LongLEAGrowth;
+			++LongLEAs;
+			EverMadeChange = MadeChange = true;
+		}
+
+		for (unsigned i = 0, e = Calls.size(); i != e; ++i) {
+			MachineInstr *JSR = Calls[i];
+			if (LongCallSet.count(JSR) ||
+			    (!ForceLongBranch && isCallInRange(JSR)))
+				continue;
+
+			LongCallSet.insert(JSR);
+			MBBInfos[JSR->getParent()->getNumber()].Size += LongCallGrowth;
+			++LongCalls;
+			EverMadeChange = MadeChange = true;
+		}
+	}
+
+	recordFunction();
+	if (!EverMadeChange)
+		return false;
+
+	// Do the expansion.
+	for (unsigned i = 0, e = PoolLEAs.size(); i != e; ++i)
+		if (LongPoolLEAs.count(PoolLEAs[i]))
+			expandToLongLEA(PoolLEAs[i]);
+	for (unsigned i = 0, e = Calls.size(); i != e; ++i)
+		if (LongCallSet.count(Calls[i]))
+			Calls[i]->setDesc(TII->get(LC3b::LONG_CALL));
+	for (I = MBBInfos.begin(); I != E; ++I)
+		if (I->HasLongBranch)
+			expandToLongBranch(*I);
+
+	MF->RenumberBlocks();
+
+	return true;
+}
@@ -1,7 +1,20 @@
-#include "Cpu0MCInstLower.h"
-#include "Cpu0AsmPrinter.h"
-#include "Cpu0InstrInfo.h"
-#include "MCTargetDesc/Cpu0BaseInfo.h"
+//===-- LC3bMCInstLower.cpp - Convert LC3b MachineInstr to MCInst ---------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains code to lower LC3b MachineInstrs to their corresponding
+// MCInst records.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3bMCInstLower.h"
+#include "LC3bAsmPrinter.h"
+#include "LC3bInstrInfo.h"
+#include "MCTargetDesc/LC3bBaseInfo.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineOperand.h"
@@ -12,38 +25,62 @@
 
 using namespace llvm;
 
-Cpu0MCInstLower::Cpu0MCInstLower(Cpu0AsmPrinter &asmprinter) : AsmPrinter(asmprinter) {}
+LC3bMCInstLower::LC3bMCInstLower(LC3bAsmPrinter &asmprinter) : AsmPrinter(asmprinter) {}
 
-void Cpu0MCInstLower::Initialize(Mangler *M, MCContext* C) {
+void LC3bMCInstLower::Initialize(Mangler *M, MCContext* C) {
 	Mang = M;
 	Ctx = C;
 }
 
-MCOperand Cpu0MCInstLower::LowerSymbolOperand(const MachineOperand &MO, MachineOperandType MOTy, unsigned Offset) const {
+MCOperand LC3bMCInstLower::LowerSymbolOperand(const MachineOperand &MO, MachineOperandType MOTy, unsigned Offset) const {
 	MCSymbolRefExpr::VariantKind Kind;
 	const MCSymbol *Symbol;
+	int64_t SymOffset = Offset;
 	switch(MO.getTargetFlags()) {
+		case LC3bII::MO_NO_FLAG:
+			Kind = MCSymbolRefExpr::VK_None;
+			break;
+		case LC3bII::MO_SDAREL:
+			Kind = MCSymbolRefExpr::VK_LC3b_SDAREL;
+			break;
 		default:
 			llvm_unreachable("Invalid target flag!");
 	}
 	switch (MOTy) {
 		case MachineOperand::MO_GlobalAddress:
 			Symbol = Mang->getSymbol(MO.getGlobal());
+			SymOffset += MO.getOffset();
+			break;
+		case MachineOperand::MO_ExternalSymbol:
+			Symbol = AsmPrinter.GetExternalSymbolSymbol(MO.getSymbolName());
+			SymOffset += MO.getOffset();
+			break;
+		case MachineOperand::MO_BlockAddress:
+			Symbol = AsmPrinter.GetBlockAddressSymbol(MO.getBlockAddress());
+			SymOffset += MO.getOffset();
+			break;
+		case MachineOperand::MO_ConstantPoolIndex:
+			Symbol = AsmPrinter.GetCPISymbol(MO.getIndex());
+			break;
+		case MachineOperand::MO_JumpTableIndex:
+			Symbol = AsmPrinter.GetJTISymbol(MO.getIndex());
+			break;
+		case MachineOperand::MO_MachineBasicBlock:
+			Symbol = MO.getMBB()->getSymbol();
 			break;
 		default:
 			llvm_unreachable("<unknown operand type>");
 	}
 	const MCSymbolRefExpr *MCSym = MCSymbolRefExpr::Create(Symbol, Kind, *Ctx);
-	if (!Offset)
+	if (!SymOffset)
 		return MCOperand::CreateExpr(MCSym);
-	// Assume offset is never negative.
-	assert(Offset > 0);
-	const MCConstantExpr *OffsetExpr = MCConstantExpr::Create(Offset, *Ctx);
+	// Fields of a global, or the bytes before it for a negative offset.
+	const MCConstantExpr *OffsetExpr = MCConstantExpr::Create(SymOffset, *Ctx);
 	const MCBinaryExpr *AddExpr = MCBinaryExpr::CreateAdd(MCSym, OffsetExpr, *Ctx);
 	return MCOperand::CreateExpr(AddExpr);
 }
 
-MCOperand Cpu0MCInstLower::LowerOperand(const MachineOperand& MO, unsigned offset) const {
+MCOperand LC3bMCInstLower::LowerOperand(const MachineOperand& MO, unsigned offset) const {
 	MachineOperandType MOTy = MO.getType();
 	switch (MOTy) {
 		default: llvm_unreachable("unknown operand type");
@@ -53,13 +90,20 @@ MCOperand Cpu0MCInstLower::LowerOperand(const MachineOperand& MO, unsigned offse
 			return MCOperand::CreateReg(MO.getReg());
 		case MachineOperand::MO_Immediate:
 			return MCOperand::CreateImm(MO.getImm() + offset);
+		case MachineOperand::MO_GlobalAddress:
+		case MachineOperand::MO_ExternalSymbol:
+		case MachineOperand::MO_BlockAddress:
+		case MachineOperand::MO_ConstantPoolIndex:
+		case MachineOperand::MO_JumpTableIndex:
+		case MachineOperand::MO_MachineBasicBlock:
+			return LowerSymbolOperand(MO, MOTy, offset);
 		case MachineOperand::MO_RegisterMask:
 			break;
 	}
 	return MCOperand();
 }
 
-void Cpu0MCInstLower::Lower(const MachineInstr *MI, MCInst &OutMI) const {
+void LC3bMCInstLower::Lower(const MachineInstr *MI, MCInst &OutMI) const {
 	OutMI.setOpcode(MI->getOpcode());
 	for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
 		const MachineOperand &MO = MI->getOperand(i);
@@ -68,4 +112,3 @@ void Cpu0MCInstLower::Lower(const MachineInstr *MI, MCInst &OutMI) const {
 			OutMI.addOperand(MCOp);
 	}
 }
-
@@ -22,10 +22,10 @@ public:
 	LC3bMCInstLower(LC3bAsmPrinter &asmprinter);
 	void Initialize(Mangler *mang, MCContext* C);
 	void Lower(const MachineInstr *MI, MCInst &OutMI) const;
+	MCOperand LowerOperand(const MachineOperand& MO, unsigned offset = 0) const;
 private:
 	MCOperand LowerSymbolOperand(const MachineOperand &MO,
 	MachineOperandType MOTy, unsigned Offset) const;
-	MCOperand LowerOperand(const MachineOperand& MO, unsigned offset = 0) const;
 };
 
 }
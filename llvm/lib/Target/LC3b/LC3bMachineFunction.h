@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 #ifndef LC3b_MACHINE_FUNCTION_INFO_H
 #define LC3b_MACHINE_FUNCTION_INFO_H
+#include "llvm/ADT/BitVector.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include <utility>
@@ -22,10 +23,26 @@ namespace llvm {
 		class LC3bFunctionInfo : public MachineFunctionInfo {
 				MachineFunction& MF;
 				unsigned MaxCallFrameSize;
-				public: LC3bFunctionInfo(MachineFunction& MF) : MF(MF), MaxCallFrameSize(0)
+				/// VarArgsFrameIndex - FrameIndex for start of varargs area.
+				int VarArgsFrameIndex;
+				/// CallCrossingRegs - Indexed by virtual register index, the
+				/// registers live across a call when register allocation first
+				/// asked for hints, see LC3bRegisterInfo::getRegAllocationHints.
+				BitVector CallCrossingRegs;
+				bool HasCallCrossingRegs;
+				public: LC3bFunctionInfo(MachineFunction& MF) : MF(MF), MaxCallFrameSize(0), VarArgsFrameIndex(0),
+				HasCallCrossingRegs(false)
 				{}
 				unsigned getMaxCallFrameSize() const { return MaxCallFrameSize; }
 				void setMaxCallFrameSize(unsigned S) { MaxCallFrameSize = S; }
+				int getVarArgsFrameIndex() const { return VarArgsFrameIndex; }
+				void setVarArgsFrameIndex(int Index) { VarArgsFrameIndex = Index; }
+				bool hasCallCrossingRegs() const { return HasCallCrossingRegs; }
+				const BitVector &getCallCrossingRegs() const { return CallCrossingRegs; }
+				void setCallCrossingRegs(const BitVector &Regs) {
+						CallCrossingRegs = Regs;
+						HasCallCrossingRegs = true;
+				}
 		};
 } // end of namespace llvm
 #endif // CPU0_MACHINE_FUNCTION_INFO_H
@@ -0,0 +1,344 @@
+//===-- LC3bPeephole.cpp - LC3b post-RA peephole optimizations ------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass cleans up what register allocation and frame lowering leave
+// behind, one basic block at a time:
+//
+//  - A chain AND Rx, Ry, #0; ADD/XOR/LSHF... Rx, Rx, #imm that builds a
+//    constant in a register already holding a nearby constant becomes a
+//    single ADD Rx, Rx, #delta.
+//  - LDW from an R6 slot whose value is still in a register (it was stored
+//    from or loaded into it) becomes ADD Rd, Rs, #0. Both set the flags from
+//    the same value, and the copy is 9 cycles against 15.
+//  - ADD Rx, Rx, #0 is deleted unless a BR reads the flags it sets.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "lc3b-peephole"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumMergedChains, "Number of constant chains merged");
+STATISTIC(NumForwarded,    "Number of stack loads forwarded");
+STATISTIC(NumSelfCopies,   "Number of self copies deleted");
+
+static cl::opt<bool> DisablePeephole(
+	"disable-lc3b-peephole",
+	cl::init(false),
+	cl::desc("LC3b: Disable the post-RA peephole pass."),
+	cl::Hidden);
+
+namespace {
+	typedef MachineBasicBlock::iterator Iter;
+
+	class LC3bPeephole : public MachineFunctionPass {
+	public:
+		static char ID;
+		LC3bPeephole(TargetMachine &tm)
+			: MachineFunctionPass(ID),
+			  TII(static_cast<const LC3bInstrInfo*>(tm.getInstrInfo())),
+			  TRI(tm.getRegisterInfo()) {}
+
+		virtual const char *getPassName() const {
+			return "LC3b Peephole";
+		}
+
+		bool runOnMachineFunction(MachineFunction &F);
+
+	private:
+		bool mergeConstantChains(MachineBasicBlock &MBB);
+		bool forwardStackLoads(MachineBasicBlock &MBB);
+		bool removeSelfCopies(MachineBasicBlock &MBB);
+
+		const LC3bInstrInfo *TII;
+		const TargetRegisterInfo *TRI;
+	};
+
+	char LC3bPeephole::ID = 0;
+} // end of anonymous namespace
+
+/// createLC3bPeepholePass - Returns a pass that runs the post-RA peephole
+/// optimizations.
+FunctionPass *llvm::createLC3bPeepholePass(LC3bTargetMachine &tm) {
+	return new LC3bPeephole(tm);
+}
+
+/// isImmOp - ADD/AND/XOR with an imm5 and the shifts.
+static bool isImmOp(unsigned Opc) {
+	switch (Opc) {
+	default: return false;
+	case LC3b::ADDI: case LC3b::ANDI: case LC3b::XORI:
+	case LC3b::LSHF: case LC3b::RSHFL: case LC3b::RSHFA:
+		return true;
+	}
+}
+
+/// evalImmOp - The 16-bit result of an isImmOp instruction applied to V.
+static uint16_t evalImmOp(unsigned Opc, uint16_t V, int64_t Imm) {
+	switch (Opc) {
+	default: llvm_unreachable("Not an immediate ALU op!");
+	case LC3b::ADDI:  return V + Imm;
+	case LC3b::ANDI:  return V & Imm;
+	case LC3b::XORI:  return V ^ Imm;
+	case LC3b::LSHF:  return V << Imm;
+	case LC3b::RSHFL: return V >> Imm;
+	case LC3b::RSHFA: return int16_t(V) >> Imm;
+	}
+}
+
+/// isChainStep - Op Rx, Rx, #imm.
+static bool isChainStep(const MachineInstr &MI, unsigned Reg) {
+	return isImmOp(MI.getOpcode()) && MI.getOperand(0).getReg() == Reg &&
+	       MI.getOperand(1).getReg() == Reg && MI.getOperand(2).isImm();
+}
+
+/// isClear - AND Rx, Ry, #0, the start of every constant sequence.
+static bool isClear(const MachineInstr &MI) {
+	return MI.getOpcode() == LC3b::ANDI && MI.getOperand(2).isImm() &&
+	       MI.getOperand(2).getImm() == 0;
+}
+
+/// isSelfCopy - ADD Rx, Rx, #0.
+static bool isSelfCopy(const MachineInstr &MI) {
+	return MI.getOpcode() == LC3b::ADDI && MI.getOperand(2).isImm() &&
+	       MI.getOperand(2).getImm() == 0 &&
+	       MI.getOperand(0).getReg() == MI.getOperand(1).getReg();
+}
+
+/// getStackOffset - Whether MI is an LDW/STW/LDB/STB off R6, and its offset.
+static bool getStackOffset(const MachineInstr &MI, int64_t &Offset) {
+	switch (MI.getOpcode()) {
+	default: return false;
+	case LC3b::LDW: case LC3b::STW: case LC3b::LDB: case LC3b::STB:
+		break;
+	}
+	if (!MI.getOperand(1).isReg() || MI.getOperand(1).getReg() != LC3b::R6 ||
+	    !MI.getOperand(2).isImm())
+		return false;
+	Offset = MI.getOperand(2).getImm();
+	return true;
+}
+
+/// clearKills - Reg is read again at I, so none of the uses since its
+/// definition kills it any more.
+static void clearKills(MachineBasicBlock &MBB, Iter I, unsigned Reg) {
+	while (I != MBB.begin()) {
+		--I;
+		for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i) {
+			MachineOperand &MO = I->getOperand(i);
+			if (MO.isReg() && MO.isUse() && MO.getReg() == Reg)
+				MO.setIsKill(false);
+		}
+		if (I->definesRegister(Reg))
+			return;
+	}
+}
+
+/// isNZPDeadAfter - Whether nothing reads the flags MI sets. The flags never
+/// live out of a block, BRcc is expanded with its test in the same block.
+static bool isNZPDeadAfter(MachineBasicBlock &MBB, Iter MI) {
+	for (Iter I = llvm::next(MI), E = MBB.end(); I != E; ++I) {
+		if (I->readsRegister(LC3b::NZP))
+			return false;
+		if (I->definesRegister(LC3b::NZP))
+			return true;
+	}
+	return true;
+}
+
+// Replace constant sequences by an ADD to the constant the register already
+// holds, when the difference fits in imm5.
+bool LC3bPeephole::mergeConstantChains(MachineBasicBlock &MBB) {
+	DenseMap<unsigned, uint16_t> Known;
+	bool Changed = false;
+
+	for (Iter I = MBB.begin(), E = MBB.end(); I != E; ) {
+		MachineInstr *MI = I;
+		if (MI->isDebugValue()) {
+			++I;
+			continue;
+		}
+
+		if (isClear(*MI)) {
+			unsigned Reg = MI->getOperand(0).getReg();
+			uint16_t V = 0;
+			unsigned Len = 1;
+			Iter End = llvm::next(I);
+			for (; End != E && (End->isDebugValue() || isChainStep(*End, Reg)); ++End)
+				if (!End->isDebugValue()) {
+					V = evalImmOp(End->getOpcode(), V, End->getOperand(2).getImm());
+					++Len;
+				}
+
+			DenseMap<unsigned, uint16_t>::iterator K = Known.find(Reg);
+			if (K != Known.end()) {
+				int64_t Delta = int16_t(V - K->second);
+				// A lone AND #0 is as cheap as the ADD, unless it is a no-op.
+				if (isInt<5>(Delta) && (Len > 1 || Delta == 0)) {
+					DEBUG(dbgs() << "LC3b: " << Len << " instruction constant "
+					             << int16_t(V) << " as ADD #" << Delta << "\n");
+					clearKills(MBB, I, Reg);
+					BuildMI(MBB, I, MI->getDebugLoc(), TII->get(LC3b::ADDI), Reg)
+						.addReg(Reg).addImm(Delta);
+					MBB.erase(I, End);
+					K->second = V;
+					I = End;
+					++NumMergedChains;
+					Changed = true;
+					continue;
+				}
+			}
+		}
+
+		// Track the registers holding a known constant.
+		if (MI->isCall()) {
+			Known.clear();
+		} else {
+			bool HasValue = false;
+			uint16_t V = 0;
+			if (isClear(*MI)) {
+				HasValue = true;
+			} else if (isImmOp(MI->getOpcode()) && MI->getOperand(2).isImm()) {
+				DenseMap<unsigned, uint16_t>::iterator K =
+					Known.find(MI->getOperand(1).getReg());
+				if (K != Known.end()) {
+					HasValue = true;
+					V = evalImmOp(MI->getOpcode(), K->second, MI->getOperand(2).getImm());
+				}
+			}
+			for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
+				const MachineOperand &MO = MI->getOperand(i);
+				if (MO.isReg() && MO.isDef())
+					Known.erase(MO.getReg());
+			}
+			if (HasValue)
+				Known[MI->getOperand(0).getReg()] = V;
+		}
+		++I;
+	}
+	return Changed;
+}
+
+// Turn reloads of an R6 slot whose value is still in a register into copies.
+bool LC3bPeephole::forwardStackLoads(MachineBasicBlock &MBB) {
+	// The register holding the word at each R6 offset.
+	DenseMap<int64_t, unsigned> Slots;
+	bool Changed = false;
+
+	for (Iter I = MBB.begin(), E = MBB.end(); I != E; ) {
+		MachineInstr *MI = I++;
+		if (MI->isDebugValue())
+			continue;
+
+		int64_t Offset;
+		bool IsStackAccess = getStackOffset(*MI, Offset);
+
+		if (IsStackAccess && MI->getOpcode() == LC3b::LDW &&
+		    !MI->hasOrderedMemoryRef()) {
+			DenseMap<int64_t, unsigned>::iterator S = Slots.find(Offset);
+			if (S != Slots.end()) {
+				unsigned Src = S->second;
+				unsigned Dst = MI->getOperand(0).getReg();
+				DEBUG(dbgs() << "LC3b: forwarding " << TRI->getName(Src)
+				             << " to " << *MI);
+
+				clearKills(MBB, MI, Src);
+				MachineInstr *Copy =
+					BuildMI(MBB, MI, MI->getDebugLoc(), TII->get(LC3b::ADDI), Dst)
+						.addReg(Src).addImm(0);
+				MI->eraseFromParent();
+				++NumForwarded;
+				Changed = true;
+				// The slot is still in Src.
+				if (Src == Dst)
+					continue;
+				MI = Copy;
+				IsStackAccess = false;
+			}
+		}
+
+		// Forget the slots whose register or memory MI changes.
+		if (MI->isCall() || MI->isInlineAsm() || MI->hasUnmodeledSideEffects() ||
+		    (MI->mayStore() && !IsStackAccess) || MI->modifiesRegister(LC3b::R6, TRI)) {
+			Slots.clear();
+			continue;
+		}
+		for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
+			const MachineOperand &MO = MI->getOperand(i);
+			if (!MO.isReg() || !MO.isDef())
+				continue;
+			SmallVector<int64_t, 4> Stale;
+			for (DenseMap<int64_t, unsigned>::iterator S = Slots.begin(),
+			     SE = Slots.end(); S != SE; ++S)
+				if (S->second == MO.getReg())
+					Stale.push_back(S->first);
+			for (unsigned j = 0, je = Stale.size(); j != je; ++j)
+				Slots.erase(Stale[j]);
+		}
+
+		if (!IsStackAccess)
+			continue;
+
+		// Remember what this access leaves in a register. LDB/STB only
+		// invalidate: forwarding a byte needs LSHF+RSHFA, slower than LDB.
+		unsigned Reg = MI->getOperand(0).getReg();
+		switch (MI->getOpcode()) {
+		case LC3b::LDW:
+			if (!MI->hasOrderedMemoryRef())
+				Slots[Offset] = Reg;
+			break;
+		case LC3b::STW:
+			if (MI->hasOrderedMemoryRef())
+				Slots.erase(Offset);
+			else
+				Slots[Offset] = Reg;
+			break;
+		case LC3b::STB:
+			Slots.erase(Offset & ~int64_t(1));
+			break;
+		}
+	}
+	return Changed;
+}
+
+// Delete ADD Rx, Rx, #0 whose flags nobody reads.
+bool LC3bPeephole::removeSelfCopies(MachineBasicBlock &MBB) {
+	bool Changed = false;
+
+	for (Iter I = MBB.begin(), E = MBB.end(); I != E; ) {
+		Iter MI = I++;
+		if (isSelfCopy(*MI) && isNZPDeadAfter(MBB, MI)) {
+			MI->eraseFromParent();
+			++NumSelfCopies;
+			Changed = true;
+		}
+	}
+	return Changed;
+}
+
+bool LC3bPeephole::runOnMachineFunction(MachineFunction &F) {
+	if (DisablePeephole)
+		return false;
+
+	bool Changed = false;
+	for (MachineFunction::iterator MBB = F.begin(), E = F.end(); MBB != E; ++MBB) {
+		Changed |= mergeConstantChains(*MBB);
+		Changed |= forwardStackLoads(*MBB);
+		Changed |= removeSelfCopies(*MBB);
+	}
+	return Changed;
+}
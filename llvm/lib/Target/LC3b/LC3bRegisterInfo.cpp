@@ -1,11 +1,12 @@
 //===----------------------------------------------------------------------===//
 //
-// This file contains the CPU0 implementation of the TargetRegisterInfo class.
+// This file contains the LC3b implementation of the TargetRegisterInfo class.
 //
 //===----------------------------------------------------------------------===//
-#define DEBUG_TYPE "cpu0-reg-info"
-#include "Cpu0RegisterInfo.h"
+#define DEBUG_TYPE "LC3b-reg-info"
+#include "LC3bRegisterInfo.h"
 #include "LC3b.h"
+#include "LC3bInstrInfo.h"
 #include "LC3bSubtarget.h"
 #include "LC3bMachineFunction.h"
 #include "llvm/IR/Constants.h"
@@ -16,6 +17,8 @@
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/VirtRegMap.h"
 #include "llvm/Target/TargetFrameLowering.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h" 
@@ -25,46 +28,210 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 
 #define GET_REGINFO_TARGET_DESC
-#include "Cpu0GenRegisterInfo.inc"
+#include "LC3bGenRegisterInfo.inc"
 using namespace llvm;
-LC3bRegisterInfo::Cpu0RegisterInfo(const Cpu0Subtarget &ST, const TargetInstrInfo &tii)
-							: Cpu0GenRegisterInfo(LC3b::LR), Subtarget(ST), TII(tii) {}
+LC3bRegisterInfo::LC3bRegisterInfo(const LC3bSubtarget &ST, const TargetInstrInfo &tii)
+							: LC3bGenRegisterInfo(LC3b::R7), Subtarget(ST), TII(tii) {}
 //===----------------------------------------------------------------------===//
 // Callee Saved Registers methods
 //===----------------------------------------------------------------------===//
 /// LC3b Callee Saved Registers
-// In Cpu0CallConv.td,
-// def CSR_O32 : CalleeSavedRegs<(add LR, FP, (sequence "S%u", 2, 0))>;
-// llc create CSR_O32_SaveList and CSR_O32_RegMask from above defined.
-const uint16_t* Cpu0RegisterInfo::getCalleeSavedRegs(const MachineFunction *MF) const {
-	return CSR_O32_SaveList;
+// In LC3bCallingConv.td,
+// def CSR_LC3b : CalleeSavedRegs<(add R7, R5, R4)>;
+// llc create CSR_LC3b_SaveList and CSR_LC3b_RegMask from above defined.
+const uint16_t* LC3bRegisterInfo::getCalleeSavedRegs(const MachineFunction *MF) const {
+	return CSR_LC3b_SaveList;
 }
 
 
-const uint32_t* Cpu0RegisterInfo::getCallPreservedMask(CallingConv::ID) const {
-	return CSR_O32_RegMask;
+const uint32_t* LC3bRegisterInfo::getCallPreservedMask(CallingConv::ID) const {
+	return CSR_LC3b_RegMask;
 }
 // pure virtual method
-BitVector Cpu0RegisterInfo::getReservedRegs(const MachineFunction &MF) const {
-	static const uint16_t ReservedCPURegs[] = {LC3b::ZERO, LC3b::AT, LC3b::SP, LC3b::LR, LC3b::PC};
+BitVector LC3bRegisterInfo::getReservedRegs(const MachineFunction &MF) const {
+	return getReservedRegs();
+}
+
+BitVector LC3bRegisterInfo::getReservedRegs() const {
+	// R6 is the stack pointer. R7, the link register written by JSR/JSRR, is
+	// allocatable: it is callee saved and only read by the RET that RetLR
+	// becomes after the epilogue has restored it.
+	// NZP never lives across a BRcc, it is set right before the branch.
+	static const uint16_t ReservedCPURegs[] = {LC3b::R6, LC3b::NZP};
 	BitVector Reserved(getNumRegs());
-	typedef TargetRegisterClass::iterator RegIter;
 	for (unsigned I = 0; I < array_lengthof(ReservedCPURegs); ++I)
 		Reserved.set(ReservedCPURegs[I]);
+	// R5 holds _SDA_BASE_ when there is a small data area.
+	if (Subtarget.useSmallData())
+		Reserved.set(LC3b::R5);
 	return Reserved;
 }
+
+/// computeCallCrossingRegs - Set the index of every virtual register live
+/// across a JSR/JSRR, judged from its operands in one pass over the function:
+/// a use after a call in its block with no definition in between, or a
+/// definition followed by a call in its block and a use elsewhere.
+static void computeCallCrossingRegs(const MachineFunction &MF, BitVector &Regs) {
+	const MachineRegisterInfo &MRI = MF.getRegInfo();
+	Regs.clear();
+	Regs.resize(MRI.getNumVirtRegs());
+
+	// The virtual registers defined before a call, with the block of the call.
+	SmallVector<std::pair<unsigned, const MachineBasicBlock *>, 16> DefsBeforeCall;
+	for (MachineFunction::const_iterator MBB = MF.begin(), E = MF.end();
+	     MBB != E; ++MBB) {
+		// Defined in MBB since its last call, and whether there was one.
+		DenseSet<unsigned> DefinedSinceCall;
+		bool SawCall = false;
+		for (MachineBasicBlock::const_iterator MI = MBB->begin(),
+		     ME = MBB->end(); MI != ME; ++MI) {
+			if (MI->isCall()) {
+				for (DenseSet<unsigned>::iterator R = DefinedSinceCall.begin(),
+				     RE = DefinedSinceCall.end(); R != RE; ++R)
+					DefsBeforeCall.push_back(std::make_pair(*R, &*MBB));
+				DefinedSinceCall.clear();
+				SawCall = true;
+			}
+			for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
+				const MachineOperand &MO = MI->getOperand(i);
+				if (!MO.isReg() || !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+					continue;
+				unsigned Reg = MO.getReg();
+				if (MO.isDef())
+					DefinedSinceCall.insert(Reg);
+				else if (SawCall && !DefinedSinceCall.count(Reg))
+					Regs.set(TargetRegisterInfo::virtReg2Index(Reg));
+			}
+		}
+	}
+
+	for (unsigned i = 0, e = DefsBeforeCall.size(); i != e; ++i) {
+		unsigned Reg = DefsBeforeCall[i].first;
+		if (Regs.test(TargetRegisterInfo::virtReg2Index(Reg)))
+			continue;
+		for (MachineRegisterInfo::use_nodbg_iterator U = MRI.use_nodbg_begin(Reg),
+		     UE = MRI.use_nodbg_end(); U != UE; ++U)
+			if (U->getParent() != DefsBeforeCall[i].second) {
+				Regs.set(TargetRegisterInfo::virtReg2Index(Reg));
+				break;
+			}
+	}
+}
+
+/// getRegAllocationHints - A value live across a call goes to a callee saved
+/// register straight away instead of being evicted from R0-R3 or split
+/// around the call. Copy hints come first. Which values cross a call is
+/// computed once per function; the registers split from them later take the
+/// answer of the register they descend from.
+void LC3bRegisterInfo::getRegAllocationHints(unsigned VirtReg,
+                                             ArrayRef<MCPhysReg> Order,
+                                             SmallVectorImpl<MCPhysReg> &Hints,
+                                             const MachineFunction &MF,
+                                             const VirtRegMap *VRM) const {
+	TargetRegisterInfo::getRegAllocationHints(VirtReg, Order, Hints, MF, VRM);
+
+	if (!MF.getFrameInfo()->hasCalls())
+		return;
+
+	LC3bFunctionInfo *FI =
+		const_cast<MachineFunction &>(MF).getInfo<LC3bFunctionInfo>();
+	if (!FI->hasCallCrossingRegs()) {
+		BitVector Regs;
+		computeCallCrossingRegs(MF, Regs);
+		FI->setCallCrossingRegs(Regs);
+	}
+	const BitVector &CallCrossing = FI->getCallCrossingRegs();
+	unsigned Index = TargetRegisterInfo::virtReg2Index(VirtReg);
+	if (Index >= CallCrossing.size() && VRM)
+		Index = TargetRegisterInfo::virtReg2Index(VRM->getOriginal(VirtReg));
+	if (Index >= CallCrossing.size() || !CallCrossing.test(Index))
+		return;
+
+	const uint32_t *Preserved = getCallPreservedMask(CallingConv::C);
+	for (unsigned i = 0, e = Order.size(); i != e; ++i) {
+		unsigned Reg = Order[i];
+		// R7 is preserved for the caller, not across the JSR that writes it.
+		if (Reg != LC3b::R7 && (Preserved[Reg / 32] & (1u << Reg % 32)) &&
+		    std::find(Hints.begin(), Hints.end(), Reg) == Hints.end())
+			Hints.push_back(Reg);
+	}
+}
+
+bool LC3bRegisterInfo::requiresRegisterScavenging(const MachineFunction &MF) const {
+	return true;
+}
+
+bool LC3bRegisterInfo::requiresFrameIndexScavenging(const MachineFunction &MF) const {
+	return true;
+}
+
+bool LC3bRegisterInfo::trackLivenessAfterRegAlloc(const MachineFunction &MF) const {
+	return true;
+}
+
+/// isFrameOffsetEncodable - Whether Offset (in bytes, from R6) can be encoded
+/// directly in the immediate field of MI.
+static bool isFrameOffsetEncodable(const MachineInstr &MI, int64_t Offset) {
+	switch (MI.getOpcode()) {
+	case LC3b::LDW:
+	case LC3b::STW:
+		// offset6 is scaled by two.
+		return (Offset & 1) == 0 && isInt<6>(Offset >> 1);
+	case LC3b::LDB:
+	case LC3b::STB:
+		return isInt<6>(Offset);
+	case LC3b::ADDI:
+		return isInt<5>(Offset);
+	default:
+		llvm_unreachable("Unexpected instruction with a frame index operand");
+	}
+}
+
 // pure virtual method
 // FrameIndex represent objects inside a abstract stack.
 // We must replace FrameIndex with an stack/frame pointer
 // direct reference.
-void Cpu0RegisterInfo::eliminateFrameIndex(MachineBasicBlock::iterator II, int SPAdj, unsigned FIOperandNum, RegScavenger *RS) const {}
-// pure virtual method
-unsigned Cpu0RegisterInfo::getFrameRegister(const MachineFunction &MF) const {
+void LC3bRegisterInfo::eliminateFrameIndex(MachineBasicBlock::iterator II, int SPAdj, unsigned FIOperandNum, RegScavenger *RS) const {
+	MachineInstr &MI = *II;
+	MachineBasicBlock &MBB = *MI.getParent();
+	MachineFunction &MF = *MBB.getParent();
 	const TargetFrameLowering *TFI = MF.getTarget().getFrameLowering();
-	return TFI->hasFP(MF) ? (LC3b::FP) : (LC3b::SP);
-}
+	DebugLoc DL = MI.getDebugLoc();
 
+	int FrameIndex = MI.getOperand(FIOperandNum).getIndex();
 
+	// The frame index operand is always followed by the immediate of the
+	// memory operand (LDW/STW/LDB/STB) or of the ADD computing its address.
+	int64_t Offset = TFI->getFrameIndexOffset(MF, FrameIndex) + SPAdj +
+	                 MI.getOperand(FIOperandNum + 1).getImm();
+
+	DEBUG(errs() << "\nFunction : " << MF.getName() << "\n"
+	             << "FrameIndex : " << FrameIndex << "\n"
+	             << "Offset : " << Offset << "\n");
+
+	if (isFrameOffsetEncodable(MI, Offset)) {
+		MI.getOperand(FIOperandNum).ChangeToRegister(LC3b::R6, false);
+		MI.getOperand(FIOperandNum + 1).ChangeToImmediate(Offset);
+		return;
+	}
+
+	// The offset does not fit, build R6 + Offset in a scratch register that
+	// the scavenger assigns after frame index elimination.
+	const LC3bInstrInfo &LII = static_cast<const LC3bInstrInfo&>(TII);
+	MachineRegisterInfo &RegInfo = MF.getRegInfo();
+	unsigned Reg = RegInfo.createVirtualRegister(&LC3b::LC3bRegsRegClass);
+	LII.loadImmediate(Offset, Reg, MBB, II, DL);
+	BuildMI(MBB, II, DL, TII.get(LC3b::ADD), Reg)
+		.addReg(Reg, RegState::Kill).addReg(LC3b::R6);
+
+	MI.getOperand(FIOperandNum).ChangeToRegister(Reg, false, false, true);
+	MI.getOperand(FIOperandNum + 1).ChangeToImmediate(0);
+}
+// pure virtual method
+unsigned LC3bRegisterInfo::getFrameRegister(const MachineFunction &MF) const {
+	return LC3b::R6;
+}
@@ -1,4 +1,4 @@
-//===-- Cpu0RegisterInfo.h - LC3b Register Information Impl -----*- C++ -*-===//
+//===-- LC3bRegisterInfo.h - LC3b Register Information Impl -----*- C++ -*-===//
 //
 //
 //					The LLVM Compiler Infrastructure
@@ -14,24 +14,37 @@
 #include "LC3b.h"
 #include "llvm/Target/TargetRegisterInfo.h"
 #define GET_REGINFO_HEADER
-#include "Cpu0GenRegisterInfo.inc"
+#include "LC3bGenRegisterInfo.inc"
 namespace llvm {
-class Cpu0Subtarget;
+class LC3bSubtarget;
 class TargetInstrInfo;
 class Type;
 
-struct Cpu0RegisterInfo : public Cpu0GenRegisterInfo {
-	const Cpu0Subtarget &Subtarget;
+struct LC3bRegisterInfo : public LC3bGenRegisterInfo {
+	const LC3bSubtarget &Subtarget;
 	const TargetInstrInfo &TII;
-	Cpu0RegisterInfo(const Cpu0Subtarget &Subtarget, const TargetInstrInfo &tii);
+	LC3bRegisterInfo(const LC3bSubtarget &Subtarget, const TargetInstrInfo &tii);
 	/// getRegisterNumbering - Given the enum value for some register, e.g.
-	/// LC3b::RA, return the number that it corresponds to (e.g. 31).
+	/// LC3b::R7, return the number that it corresponds to (e.g. 7).
 	static unsigned getRegisterNumbering(unsigned RegEnum);
 	/// Code Generation virtual methods...
 	const uint16_t *getCalleeSavedRegs(const MachineFunction* MF = 0) const;
 	const uint32_t *getCallPreservedMask(CallingConv::ID) const;
 	// pure virtual method
 	BitVector getReservedRegs(const MachineFunction &MF) const;
+	/// The reserved registers only depend on the subtarget, this is
+	/// getReservedRegs for callers without a function, like LC3bTTI.
+	BitVector getReservedRegs() const;
+	/// Values live across calls are hinted to R4/R5.
+	void getRegAllocationHints(unsigned VirtReg, ArrayRef<MCPhysReg> Order,
+	                           SmallVectorImpl<MCPhysReg> &Hints,
+	                           const MachineFunction &MF,
+	                           const VirtRegMap *VRM = 0) const;
+	/// Out of range frame offsets are rebuilt in a scavenged register.
+	bool requiresRegisterScavenging(const MachineFunction &MF) const;
+	bool requiresFrameIndexScavenging(const MachineFunction &MF) const;
+	/// Live-ins stay accurate for LC3bLongBranch to find a free register.
+	bool trackLivenessAfterRegAlloc(const MachineFunction &MF) const;
 	// pure virtual method
 	/// Stack Frame Processing Methods
 	void eliminateFrameIndex(MachineBasicBlock::iterator II,
@@ -44,4 +57,3 @@ struct Cpu0RegisterInfo : public Cpu0GenRegisterInfo {
 
 } // end namespace llvm
 #endif
-
@@ -7,11 +7,18 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file implements the Cpu0SelectionDAGInfo class.
+// This file implements the LC3bSelectionDAGInfo class.
+//
+// Copies and clears of known size up to MaxStoresPerMemcpy/Memset words are
+// unrolled into loads and stores by SelectionDAG itself. Larger ones reach
+// the hooks here and become a MEMCPY/MEMSET loop, one word per iteration
+// when the pointers are word aligned and one byte otherwise. Unknown sizes
+// stay calls to memcpy/memset.
 //
 //===----------------------------------------------------------------------===//
 #define DEBUG_TYPE "LC3b-selectiondag-info"
 #include "LC3bTargetMachine.h"
+#include "llvm/CodeGen/SelectionDAG.h"
 
 using namespace llvm;
 
@@ -20,3 +27,85 @@ LC3bSelectionDAGInfo::LC3bSelectionDAGInfo(const LC3bTargetMachine &TM) : Target
 LC3bSelectionDAGInfo::~LC3bSelectionDAGInfo() {
 }
 
+/// getLoopCount - The number of iterations of a MEMCPY/MEMSET loop over
+/// Size bytes in Unit byte steps, or 0 if Size is not a constant the loop
+/// counter (which must stay positive) can hold.
+static uint64_t getLoopCount(SDValue Size, unsigned Unit) {
+	ConstantSDNode *ConstantSize = dyn_cast<ConstantSDNode>(Size);
+	if (!ConstantSize)
+		return 0;
+	uint64_t Count = ConstantSize->getZExtValue() / Unit;
+	return Count <= 0x7fff ? Count : 0;
+}
+
+SDValue
+LC3bSelectionDAGInfo::EmitTargetCodeForMemcpy(SelectionDAG &DAG, DebugLoc dl,
+                                              SDValue Chain,
+                                              SDValue Dst, SDValue Src,
+                                              SDValue Size, unsigned Align,
+                                              bool isVolatile, bool AlwaysInline,
+                                              MachinePointerInfo DstPtrInfo,
+                                              MachinePointerInfo SrcPtrInfo) const {
+	unsigned Unit = Align >= 2 ? 2 : 1;
+	uint64_t Count = getLoopCount(Size, Unit);
+	if (Count == 0)
+		return SDValue();
+
+	SDValue Ops[] = { Chain, Dst, Src, DAG.getConstant(Count, MVT::i16),
+	                  DAG.getTargetConstant(Unit, MVT::i16) };
+	Chain = DAG.getNode(LC3bISD::MEMCPY, dl, MVT::Other, Ops, 5);
+
+	// The odd byte after the words.
+	uint64_t Done = Count * Unit;
+	if (cast<ConstantSDNode>(Size)->getZExtValue() == Done)
+		return Chain;
+	SDValue Offset = DAG.getConstant(Done, MVT::i16);
+	SDValue Byte = DAG.getExtLoad(ISD::EXTLOAD, dl, MVT::i16, Chain,
+	                              DAG.getNode(ISD::ADD, dl, MVT::i16, Src, Offset),
+	                              SrcPtrInfo.getWithOffset(Done), MVT::i8,
+	                              isVolatile, false, 1);
+	return DAG.getTruncStore(Byte.getValue(1), dl, Byte,
+	                         DAG.getNode(ISD::ADD, dl, MVT::i16, Dst, Offset),
+	                         DstPtrInfo.getWithOffset(Done), MVT::i8,
+	                         isVolatile, false, 1);
+}
+
+SDValue
+LC3bSelectionDAGInfo::EmitTargetCodeForMemset(SelectionDAG &DAG, DebugLoc dl,
+                                              SDValue Chain,
+                                              SDValue Dst, SDValue Src,
+                                              SDValue Size, unsigned Align,
+                                              bool isVolatile,
+                                              MachinePointerInfo DstPtrInfo) const {
+	unsigned Unit = Align >= 2 ? 2 : 1;
+	uint64_t Count = getLoopCount(Size, Unit);
+	if (Count == 0)
+		return SDValue();
+
+	// The byte in both halves of a word.
+	SDValue Value;
+	if (ConstantSDNode *C = dyn_cast<ConstantSDNode>(Src)) {
+		unsigned Byte = C->getZExtValue() & 0xff;
+		Value = DAG.getConstant(Byte | Byte << 8, MVT::i16);
+	} else {
+		Value = DAG.getNode(ISD::ZERO_EXTEND, dl, MVT::i16, Src);
+		if (Unit == 2)
+			Value = DAG.getNode(ISD::OR, dl, MVT::i16, Value,
+			                    DAG.getNode(ISD::SHL, dl, MVT::i16, Value,
+			                                DAG.getConstant(8, MVT::i16)));
+	}
+
+	SDValue Ops[] = { Chain, Dst, Value, DAG.getConstant(Count, MVT::i16),
+	                  DAG.getTargetConstant(Unit, MVT::i16) };
+	Chain = DAG.getNode(LC3bISD::MEMSET, dl, MVT::Other, Ops, 5);
+
+	// The odd byte after the words.
+	uint64_t Done = Count * Unit;
+	if (cast<ConstantSDNode>(Size)->getZExtValue() == Done)
+		return Chain;
+	return DAG.getTruncStore(Chain, dl, Value,
+	                         DAG.getNode(ISD::ADD, dl, MVT::i16, Dst,
+	                                     DAG.getConstant(Done, MVT::i16)),
+	                         DstPtrInfo.getWithOffset(Done), MVT::i8,
+	                         isVolatile, false, 1);
+}
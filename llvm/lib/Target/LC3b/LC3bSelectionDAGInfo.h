@@ -20,6 +20,26 @@ namespace llvm {
 				public:
 				explicit LC3bSelectionDAGInfo(const LC3bTargetMachine &TM);
 				~LC3bSelectionDAGInfo();
+
+				/// EmitTargetCodeForMemcpy - A MEMCPY loop for constant sizes
+				/// the generic load/store expansion gives up on.
+				virtual SDValue
+				EmitTargetCodeForMemcpy(SelectionDAG &DAG, DebugLoc dl,
+				                        SDValue Chain,
+				                        SDValue Dst, SDValue Src,
+				                        SDValue Size, unsigned Align,
+				                        bool isVolatile, bool AlwaysInline,
+				                        MachinePointerInfo DstPtrInfo,
+				                        MachinePointerInfo SrcPtrInfo) const;
+
+				/// EmitTargetCodeForMemset - A MEMSET loop, as for memcpy.
+				virtual SDValue
+				EmitTargetCodeForMemset(SelectionDAG &DAG, DebugLoc dl,
+				                        SDValue Chain,
+				                        SDValue Dst, SDValue Src,
+				                        SDValue Size, unsigned Align,
+				                        bool isVolatile,
+				                        MachinePointerInfo DstPtrInfo) const;
 		};
 }
 #endif
@@ -12,13 +12,21 @@
 //===----------------------------------------------------------------------===//
 #include "LC3bSubtarget.h"
 #include "LC3b.h"
+#include "LC3bRegisterInfo.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetRegistry.h"
 #define GET_SUBTARGETINFO_TARGET_DESC
 #define GET_SUBTARGETINFO_CTOR
 #include "LC3bGenSubtargetInfo.inc"
 using namespace llvm;
+
+static cl::opt<unsigned>
+SDataThreshold("lc3b-sdata-threshold", cl::Hidden, cl::init(0),
+               cl::desc("LC3b: Place globals of at most this many bytes in "
+                        "the small data area addressed from R5 (default=0, "
+                        "none)"));
 void LC3bSubtarget::anchor() { }
-LC3bSubtarget::LC3bSubtarget(const std::string &TT, const std::string &CPU, const std::string &FS, bool little) : LC3bGenSubtargetInfo(TT, CPU, FS), LC3bABI(UnknownABI), IsLittle(little) {
+LC3bSubtarget::LC3bSubtarget(const std::string &TT, const std::string &CPU, const std::string &FS, bool little) : LC3bGenSubtargetInfo(TT, CPU, FS), LC3bABI(UnknownABI), IsLittle(little), SmallDataThreshold(SDataThreshold) {
 		std::string CPUName = CPU;
 		if (CPUName.empty())
 		CPUName = "LC3b";
@@ -30,4 +38,3 @@ LC3bSubtarget::LC3bSubtarget(const std::string &TT, const std::string &CPU, cons
 		if (LC3bABI == UnknownABI)
 		LC3bABI = O32; //FIXME
 }
-
@@ -1,12 +1,78 @@
+//===-- LC3bSubtarget.h - Define Subtarget for the LC3b ---------*- C++ -*-===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the LC3b specific subclass of TargetSubtargetInfo.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LC3BSUBTARGET_H
+#define LC3BSUBTARGET_H
+
+#include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/Target/TargetSubtargetInfo.h"
+#include <string>
+
 #define GET_SUBTARGETINFO_HEADER
 #include "LC3bGenSubtargetInfo.inc"
-...
+
+namespace llvm {
+class StringRef;
+
 class LC3bSubtarget : public LC3bGenSubtargetInfo {
-...
-//- Vitual function, must have
-/// ParseSubtargetFeatures - Parses features string setting specified
-/// subtarget options. Definition of function is auto generated by tblgen.
-void ParseSubtargetFeatures(StringRef CPU, StringRef FS);
-...
-}
-//FIXME copy from existing llvm file
+	virtual void anchor();
+public:
+	enum LC3bABIEnum {
+		UnknownABI, O32
+	};
+
+protected:
+	enum LC3bArchEnum {
+		LC3b32
+	};
+
+	// LC3b architecture version, set by the cpu032 feature.
+	LC3bArchEnum LC3bArchVersion;
+
+	// LC3b supported ABIs
+	LC3bABIEnum LC3bABI;
+
+	// IsLittle - The target is Little Endian
+	bool IsLittle;
+
+	// SmallDataThreshold - Size in bytes of the largest global placed in
+	// the small data area, zero when there is none and R5 is allocatable.
+	unsigned SmallDataThreshold;
+
+	InstrItineraryData InstrItins;
+
+public:
+	/// This constructor initializes the data members to match that
+	/// of the specified triple.
+	LC3bSubtarget(const std::string &TT, const std::string &CPU,
+	              const std::string &FS, bool little);
+
+	//- Vitual function, must have
+	/// ParseSubtargetFeatures - Parses features string setting specified
+	/// subtarget options. Definition of function is auto generated by tblgen.
+	void ParseSubtargetFeatures(StringRef CPU, StringRef FS);
+
+	/// enableMachineScheduler - Schedule with LC3bModel before register
+	/// allocation. There is no post-RA scheduler: instructions hold the
+	/// single DATAPATH one after the other, so no order is faster than another.
+	virtual bool enableMachineScheduler() const { return true; }
+
+	bool isLittle() const { return IsLittle; }
+
+	unsigned getSmallDataThreshold() const { return SmallDataThreshold; }
+	/// useSmallData - R5 holds _SDA_BASE_, see LC3bTargetObjectFile.
+	bool useSmallData() const { return SmallDataThreshold != 0; }
+	const InstrItineraryData &getInstrItineraryData() const { return InstrItins; }
+};
+} // End llvm namespace
+
+#endif
@@ -7,8 +7,16 @@
 #include "LC3b.h"
 #include "llvm/PassManager.h"
 #include "llvm/CodeGen/Passes.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetRegistry.h"
 using namespace llvm;
+
+static cl::opt<bool> PrintCycleEstimate(
+	"lc3b-cycle-estimate",
+	cl::init(false),
+	cl::desc("LC3b: Print a static cycle estimate of every function."),
+	cl::Hidden);
+
 extern "C" void LLVMInitializeLC3bTarget() {
 	// Register the target.
 	//- Big endian Target Machine
@@ -16,8 +24,8 @@ extern "C" void LLVMInitializeLC3bTarget() {
 	//- Little endian Target Machine
 	RegisterTargetMachine<LC3belTargetMachine> Y(TheLC3belTarget); ///FIXME LITTLE Endian
 }
-// DataLayout --> Big-endian, 32-bit pointer/ABI/alignment
-// The stack is always 8 byte aligned
+// DataLayout --> Big-endian, 16-bit pointer/ABI/alignment
+// Words are the largest alignment, i32 and i64 are register pairs and quads.
 // On function prologue, the stack is created by decrementing
 // its pointer. Once decremented, all references are done with positive
 // offset from the stack/frame pointer, using StackGrowsUp enables
@@ -30,8 +38,8 @@ LC3bTargetMachine::LC3bTargetMachine(	const Target &T, StringRef TT, StringRef C
 	: 	LLVMTargetMachine(T, TT, CPU, FS, Options, RM, CM, OL), 
 		Subtarget(TT, CPU, FS, isLittle), 
 		DL(isLittle ?
-		("e-p:32:32:32-i8:8:32-i16:16:32-i64:64:64-n32") :
-		("E-p:32:32:32-i8:8:32-i16:16:32-i64:64:64-n32")),
+		("e-p:16:16:16-i8:8:8-i16:16:16-i32:16:16-i64:16:16-n16") :
+		("E-p:16:16:16-i8:8:8-i16:16:16-i32:16:16-i64:16:16-n16")),
 		InstrInfo(*this), 
 		FrameLowering(Subtarget), 
 		TLInfo(*this), 
@@ -61,11 +69,50 @@ public:
 	const LC3bSubtarget &getLC3bSubtarget() const {
 		return *getLC3bTargetMachine().getSubtargetImpl();
 	}
+	virtual bool addInstSelector();
+	virtual bool addPreRegAlloc();
+	virtual bool addPreEmitPass();
 };
 
 } // namespace
 
+// Install an instruction selector pass using
+// the ISelDag to gen LC3b code.
+bool LC3bPassConfig::addInstSelector() {
+	addPass(createLC3bISelDag(getLC3bTargetMachine(), getOptLevel()));
+	return false;
+}
+
+// Counted loops are rewritten while the function is still in SSA form.
+bool LC3bPassConfig::addPreRegAlloc() {
+	if (getOptLevel() == CodeGenOpt::None)
+		return false;
+	addPass(createLC3bCountedLoopsPass(getLC3bTargetMachine()));
+	return true;
+}
+
+// Implemented by targets that want to run passes immediately before
+// machine code is emitted. Long branches are expanded last, once the
+// code size is final; the cycle estimate only reads the result and is
+// added on request, as it needs block frequencies.
+bool LC3bPassConfig::addPreEmitPass() {
+	// Peephole first, long branches need the final block sizes.
+	if (getOptLevel() != CodeGenOpt::None)
+		addPass(createLC3bPeepholePass(getLC3bTargetMachine()));
+	addPass(createLC3bLongBranchPass(getLC3bTargetMachine()));
+	if (PrintCycleEstimate)
+		addPass(createLC3bCycleEstimatePass(getLC3bTargetMachine()));
+	return true;
+}
+
 TargetPassConfig *LC3bTargetMachine::createPassConfig(PassManagerBase &PM) {
 	return new LC3bPassConfig(this, PM);
 }
 
+void LC3bTargetMachine::addAnalysisPasses(PassManagerBase &PM) {
+	// Add first the target-independent BasicTTI pass, then our LC3b pass. This
+	// allows the LC3b pass to delegate to the target independent layer when
+	// appropriate.
+	PM.add(createBasicTargetTransformInfoPass(getTargetLowering()));
+	PM.add(createLC3bTargetTransformInfoPass(this));
+}
@@ -1,7 +1,7 @@
 //===-- LC3bTargetMachine.h - Define TargetMachine for LC3b -----*- C++ -*-===//
 //
 //
-The LLVM Compiler Infrastructure
+//                     The LLVM Compiler Infrastructure
 //
 // This file is distributed under the University of Illinois Open Source
 // License. See LICENSE.TXT for details.
@@ -43,16 +43,21 @@ public:
 						StringRef CPU, StringRef FS, const TargetOptions &Options,
 						Reloc::Model RM, CodeModel::Model CM,
 						CodeGenOpt::Level OL, bool isLittle);
-	virtual const LC3bInstrInfo const *getInstrInfo() { return &InstrInfo; }
-	virtual const TargetFrameLowering *getFrameLowering() { return &FrameLowering; }
+	virtual const LC3bInstrInfo *getInstrInfo() const { return &InstrInfo; }
+	virtual const TargetFrameLowering *getFrameLowering() const { return &FrameLowering; }
 	virtual const LC3bSubtarget	*getSubtargetImpl() const { return &Subtarget; }
 	virtual const DataLayout *getDataLayout() const { return &DL;}
 	virtual const LC3bRegisterInfo *getRegisterInfo() const { return &InstrInfo.getRegisterInfo();}
 
 	virtual const LC3bTargetLowering *getTargetLowering() const { return &TLInfo; }
 	virtual const LC3bSelectionDAGInfo* getSelectionDAGInfo() const { return &TSInfo; }
+	virtual const InstrItineraryData *getInstrItineraryData() const {
+		return &Subtarget.getInstrItineraryData();
+	}
 	// Pass Pipeline Configuration
 	virtual TargetPassConfig *createPassConfig(PassManagerBase &PM);
+	/// addAnalysisPasses - Register the LC3b TargetTransformInfo.
+	virtual void addAnalysisPasses(PassManagerBase &PM);
 };
 /// LC3bTargetMachine - LC3b little endian target machine.
 /// Little Endian Check!	FIXME
@@ -0,0 +1,84 @@
+//===-- LC3bTargetObjectFile.cpp - LC3b Object Files ----------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The small data area holds the globals no larger than -lc3b-sdata-threshold
+// bytes. R5 is reserved to hold _SDA_BASE_, which the startup code loads and
+// the linker places so that the whole area is within offset6 of it: 32 bytes
+// either way for LDB/STB, 32 words for LDW/STW.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3bTargetObjectFile.h"
+#include "LC3bSubtarget.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCSectionELF.h"
+#include "llvm/Support/ELF.h"
+#include "llvm/Target/TargetMachine.h"
+using namespace llvm;
+
+void LC3bTargetObjectFile::Initialize(MCContext &Ctx, const TargetMachine &TM) {
+	TargetLoweringObjectFileELF::Initialize(Ctx, TM);
+	InitializeELF(TM.Options.UseInitArray);
+
+	SmallDataSection =
+		getContext().getELFSection(".sdata", ELF::SHT_PROGBITS,
+		                           ELF::SHF_WRITE | ELF::SHF_ALLOC,
+		                           SectionKind::getDataRel());
+
+	SmallBSSSection =
+		getContext().getELFSection(".sbss", ELF::SHT_NOBITS,
+		                           ELF::SHF_WRITE | ELF::SHF_ALLOC,
+		                           SectionKind::getBSS());
+}
+
+bool LC3bTargetObjectFile::IsGlobalInSmallSection(const GlobalValue *GV,
+                                                  const TargetMachine &TM) const {
+	// Where a declaration lives is decided by the module defining it.
+	if (GV->isDeclaration() || GV->hasAvailableExternallyLinkage())
+		return false;
+
+	return IsGlobalInSmallSection(GV, TM, getKindForGlobal(GV, TM));
+}
+
+bool LC3bTargetObjectFile::
+IsGlobalInSmallSection(const GlobalValue *GV, const TargetMachine &TM,
+                       SectionKind Kind) const {
+	unsigned Threshold = TM.getSubtarget<LC3bSubtarget>().getSmallDataThreshold();
+	if (!Threshold)
+		return false;
+
+	// Only writable variables, not functions or constants.
+	const GlobalVariable *GVA = dyn_cast<GlobalVariable>(GV);
+	if (!GVA || GVA->hasSection())
+		return false;
+	if (!Kind.isBSS() && !Kind.isDataRel())
+		return false;
+
+	Type *Ty = GV->getType()->getElementType();
+	uint64_t Size = TM.getDataLayout()->getTypeAllocSize(Ty);
+	return Size > 0 && Size <= Threshold;
+}
+
+const MCSection *LC3bTargetObjectFile::
+SelectSectionForGlobal(const GlobalValue *GV, SectionKind Kind,
+                       Mangler *Mang, const TargetMachine &TM) const {
+	if (Kind.isBSS() && IsGlobalInSmallSection(GV, TM, Kind))
+		return SmallBSSSection;
+	if (Kind.isDataRel() && IsGlobalInSmallSection(GV, TM, Kind))
+		return SmallDataSection;
+
+	return TargetLoweringObjectFileELF::SelectSectionForGlobal(GV, Kind, Mang, TM);
+}
+
+const MCSection *
+LC3bTargetObjectFile::getSectionForConstant(SectionKind Kind) const {
+	return getTextSection();
+}
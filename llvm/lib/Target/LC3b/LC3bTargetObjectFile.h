@@ -0,0 +1,41 @@
+//===-- LC3bTargetObjectFile.h - LC3b Object Info ---------------*- C++ -*-===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_TARGET_LC3B_TARGETOBJECTFILE_H
+#define LLVM_TARGET_LC3B_TARGETOBJECTFILE_H
+#include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
+namespace llvm {
+	/// LC3bTargetObjectFile - ELF sections, plus the small data area
+	/// (.sdata/.sbss) addressed from R5 with -lc3b-sdata-threshold.
+	class LC3bTargetObjectFile : public TargetLoweringObjectFileELF {
+		const MCSection *SmallDataSection;
+		const MCSection *SmallBSSSection;
+	public:
+		void Initialize(MCContext &Ctx, const TargetMachine &TM);
+
+		/// IsGlobalInSmallSection - Return true if this global is placed in
+		/// the small data area and addressed as sym@SDAREL from R5.
+		bool IsGlobalInSmallSection(const GlobalValue *GV,
+		                            const TargetMachine &TM) const;
+		bool IsGlobalInSmallSection(const GlobalValue *GV,
+		                            const TargetMachine &TM,
+		                            SectionKind Kind) const;
+
+		const MCSection *SelectSectionForGlobal(const GlobalValue *GV,
+		                                        SectionKind Kind,
+		                                        Mangler *Mang,
+		                                        const TargetMachine &TM) const;
+
+		/// getSectionForConstant - The constant pool and jump tables are read
+		/// with LEA, which only reaches 256 words either way, so they stay in
+		/// .text next to the function. LC3bAsmPrinter emits the pool after
+		/// the function body, the jump tables follow it.
+		const MCSection *getSectionForConstant(SectionKind Kind) const;
+	};
+} // end namespace llvm
+#endif
@@ -0,0 +1,305 @@
+//===-- LC3bTargetTransformInfo.cpp - LC3b specific TTI pass --------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a TargetTransformInfo analysis pass specific to the
+// LC3b. Costs are counted in ALU instructions, from the latencies of
+// LC3bGenericItineraries: the LC-3b runs one instruction at a time, so
+// cycles are what matters. There is no multiplier or divider, immediates
+// outside simm5 take several instructions, and there are at most seven
+// allocatable registers of sixteen bits. Legality of immediates and
+// addressing modes comes from LC3bTargetLowering through BasicTTI.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "lc3btti"
+#include "LC3b.h"
+#include "LC3bTargetMachine.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Target/TargetLowering.h"
+using namespace llvm;
+
+// Declare the pass initialization routine locally as target-specific passes
+// don't have a target-wide initialization entry point, and so we rely on the
+// pass constructor initialization.
+namespace llvm {
+void initializeLC3bTTIPass(PassRegistry &);
+}
+
+namespace {
+
+class LC3bTTI : public ImmutablePass, public TargetTransformInfo {
+	const LC3bTargetMachine *TM;
+	const LC3bTargetLowering *TLI;
+	const LC3bInstrInfo *TII;
+
+	/// getCost - Cycles in units of ALU instructions, rounded up.
+	unsigned getCost(unsigned Cycles) const {
+		unsigned AluLat = TLI->getInstrLatency(LC3b::ADD);
+		return (Cycles + AluLat - 1) / AluLat;
+	}
+
+	/// getInstrCost - Opcode in units of ALU instructions.
+	unsigned getInstrCost(unsigned Opcode) const {
+		return getCost(TLI->getInstrLatency(Opcode));
+	}
+
+public:
+	LC3bTTI() : ImmutablePass(ID), TM(0), TLI(0), TII(0) {
+		llvm_unreachable("This pass cannot be directly constructed");
+	}
+
+	LC3bTTI(const LC3bTargetMachine *TM)
+		: ImmutablePass(ID), TM(TM), TLI(TM->getTargetLowering()),
+		  TII(TM->getInstrInfo()) {
+		initializeLC3bTTIPass(*PassRegistry::getPassRegistry());
+	}
+
+	virtual void initializePass() {
+		pushTTIStack(this);
+	}
+
+	virtual void finalizePass() {
+		popTTIStack();
+	}
+
+	virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+		TargetTransformInfo::getAnalysisUsage(AU);
+	}
+
+	/// Pass identification.
+	static char ID;
+
+	/// Provide necessary pointer adjustments for the two base classes.
+	virtual void *getAdjustedAnalysisPointer(const void *ID) {
+		if (ID == &TargetTransformInfo::ID)
+			return (TargetTransformInfo*)this;
+		return this;
+	}
+
+	/// \name Scalar TTI Implementations
+	/// @{
+	virtual unsigned getOperationCost(unsigned Opcode, Type *Ty,
+	                                  Type *OpTy) const;
+	virtual PopcntSupportKind getPopcntSupport(unsigned TyWidth) const;
+	virtual unsigned getIntImmCost(const APInt &Imm, Type *Ty) const;
+
+	/// @}
+
+	/// \name Vector TTI Implementations
+	/// @{
+	virtual unsigned getNumberOfRegisters(bool Vector) const;
+	virtual unsigned getRegisterBitWidth(bool Vector) const;
+	virtual unsigned getMaximumUnrollFactor() const;
+	virtual unsigned getArithmeticInstrCost(unsigned Opcode, Type *Ty,
+	                                        OperandValueKind Opd1Info,
+	                                        OperandValueKind Opd2Info) const;
+	virtual unsigned getCastInstrCost(unsigned Opcode, Type *Dst,
+	                                  Type *Src) const;
+	virtual unsigned getCFInstrCost(unsigned Opcode) const;
+	virtual unsigned getCmpSelInstrCost(unsigned Opcode, Type *ValTy,
+	                                    Type *CondTy) const;
+	virtual unsigned getMemoryOpCost(unsigned Opcode, Type *Src,
+	                                 unsigned Alignment,
+	                                 unsigned AddressSpace) const;
+
+	/// @}
+};
+
+} // end anonymous namespace
+
+INITIALIZE_AG_PASS(LC3bTTI, TargetTransformInfo, "lc3btti",
+                   "LC3b Target Transform Info", true, true, false)
+char LC3bTTI::ID = 0;
+
+ImmutablePass *
+llvm::createLC3bTargetTransformInfoPass(const LC3bTargetMachine *TM) {
+	return new LC3bTTI(TM);
+}
+
+//===----------------------------------------------------------------------===//
+//
+// LC3b cost model.
+//
+//===----------------------------------------------------------------------===//
+
+/// getOperationCost - Multiplies and divides are calls to Runtime/, which
+/// is what the size estimates of the loop unroller and unswitcher have to
+/// know. Everything else is the default.
+unsigned LC3bTTI::getOperationCost(unsigned Opcode, Type *Ty,
+                                   Type *OpTy) const {
+	switch (Opcode) {
+	case Instruction::Mul:
+	case Instruction::UDiv:
+	case Instruction::SDiv:
+	case Instruction::URem:
+	case Instruction::SRem:
+		if (Ty->isIntegerTy())
+			return TCC_Expensive;
+		break;
+	}
+	return TargetTransformInfo::getOperationCost(Opcode, Ty, OpTy);
+}
+
+LC3bTTI::PopcntSupportKind LC3bTTI::getPopcntSupport(unsigned TyWidth) const {
+	assert(isPowerOf2_32(TyWidth) && "Ty width must be power of 2");
+	return PSK_Software;
+}
+
+/// getIntImmCost - A simm5 is an operand of ADD/AND/XOR, anything else is
+/// the AND/ADD/XOR/LSHF sequence or the LEA+LDW that SelectConstant picks
+/// when the constant pool is in range.
+unsigned LC3bTTI::getIntImmCost(const APInt &Imm, Type *Ty) const {
+	assert(Ty->isIntegerTy());
+	unsigned Parts = std::max(1U, (Ty->getPrimitiveSizeInBits() + 15) / 16);
+	if (Imm.getBitWidth() > 64)
+		return Parts * TCC_Expensive;
+
+	unsigned Cost = 0;
+	for (unsigned i = 0; i != Parts; ++i) {
+		int64_t Word = SignExtend64<16>(Imm.getSExtValue() >> (16 * i));
+		if (isInt<5>(Word))
+			continue;
+
+		LC3bInstrInfo::ImmSequence Seq;
+		if (!TII->getImmSequence(Word, Seq) ||
+		    TII->isConstantPoolCheaper(Seq, false, false))
+			Cost += getInstrCost(LC3b::LEA) + getInstrCost(LC3b::LDW);
+		else
+			Cost += Seq.size();
+	}
+	return Cost;
+}
+
+/// getNumberOfRegisters - The allocatable registers: R0-R7 less the stack
+/// pointer R6, and less R5 when it holds _SDA_BASE_.
+unsigned LC3bTTI::getNumberOfRegisters(bool Vector) const {
+	if (Vector)
+		return 0;
+	BitVector Reserved = TM->getRegisterInfo()->getReservedRegs();
+	unsigned NumRegs = 0;
+	for (TargetRegisterClass::iterator I = LC3b::LC3bRegsRegClass.begin(),
+	     E = LC3b::LC3bRegsRegClass.end(); I != E; ++I)
+		if (!Reserved.test(*I))
+			++NumRegs;
+	return NumRegs;
+}
+
+unsigned LC3bTTI::getRegisterBitWidth(bool Vector) const {
+	if (Vector)
+		return 0;
+	return 16;
+}
+
+/// getMaximumUnrollFactor - One instruction at a time, interleaving buys
+/// nothing but register pressure.
+unsigned LC3bTTI::getMaximumUnrollFactor() const {
+	return 1;
+}
+
+unsigned LC3bTTI::getArithmeticInstrCost(unsigned Opcode, Type *Ty,
+                                         OperandValueKind Opd1Info,
+                                         OperandValueKind Opd2Info) const {
+	if (!Ty->isIntegerTy())
+		return TargetTransformInfo::getArithmeticInstrCost(Opcode, Ty, Opd1Info,
+		                                                   Opd2Info);
+
+	std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(Ty);
+	unsigned Alu = getInstrCost(LC3b::ADD);
+	unsigned Cost;
+	switch (Opcode) {
+	default:
+		return TargetTransformInfo::getArithmeticInstrCost(Opcode, Ty, Opd1Info,
+		                                                   Opd2Info);
+	case Instruction::Add:
+	case Instruction::And:
+	case Instruction::Xor:
+		Cost = Alu;
+		break;
+	case Instruction::Sub:
+		// a + (~b + 1).
+		Cost = 3 * Alu;
+		break;
+	case Instruction::Or:
+		// ~(~a & ~b).
+		Cost = 4 * Alu;
+		break;
+	case Instruction::Shl:
+	case Instruction::LShr:
+	case Instruction::AShr:
+		Cost = getInstrCost(LC3b::LSHF);
+		break;
+	case Instruction::Mul:
+		// A constant multiplier is a short LSHF/ADD sequence, see LowerMUL.
+		// Its value is not known here, assume four instructions.
+		if (Opd2Info == OK_UniformConstantValue)
+			Cost = 4 * Alu;
+		else
+			Cost = getCost(TLI->getMulCallLatency());
+		break;
+	case Instruction::UDiv:
+	case Instruction::SDiv:
+	case Instruction::URem:
+	case Instruction::SRem:
+		Cost = getCost(TLI->getDivCallLatency());
+		break;
+	}
+	return LT.first * Cost;
+}
+
+/// getCastInstrCost - Truncation is free. Zero and sign extension of a byte
+/// are an LSHF and an RSHFL or RSHFA, of a word into a pair one instruction
+/// for the high word.
+unsigned LC3bTTI::getCastInstrCost(unsigned Opcode, Type *Dst,
+                                   Type *Src) const {
+	if (!Dst->isIntegerTy() || !Src->isIntegerTy())
+		return TargetTransformInfo::getCastInstrCost(Opcode, Dst, Src);
+
+	switch (Opcode) {
+	case Instruction::Trunc:
+		return 0;
+	case Instruction::ZExt:
+	case Instruction::SExt:
+		if (Src->getPrimitiveSizeInBits() < 16)
+			return 2 * getInstrCost(LC3b::LSHF);
+		return getInstrCost(LC3b::ADD);
+	}
+	return TargetTransformInfo::getCastInstrCost(Opcode, Dst, Src);
+}
+
+unsigned LC3bTTI::getCFInstrCost(unsigned Opcode) const {
+	if (Opcode == Instruction::Br || Opcode == Instruction::Ret)
+		return getInstrCost(LC3b::BRnzp);
+	return TargetTransformInfo::getCFInstrCost(Opcode);
+}
+
+/// getCmpSelInstrCost - A compare is a subtraction (or the value itself
+/// against zero) for the flags, a select a BRcc diamond.
+unsigned LC3bTTI::getCmpSelInstrCost(unsigned Opcode, Type *ValTy,
+                                     Type *CondTy) const {
+	if (!ValTy->isIntegerTy())
+		return TargetTransformInfo::getCmpSelInstrCost(Opcode, ValTy, CondTy);
+
+	std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(ValTy);
+	if (Opcode == Instruction::ICmp)
+		return LT.first * 3 * getInstrCost(LC3b::ADD);
+	return LT.first * (getInstrCost(LC3b::BRnzp) + getInstrCost(LC3b::ADD));
+}
+
+unsigned LC3bTTI::getMemoryOpCost(unsigned Opcode, Type *Src,
+                                  unsigned Alignment,
+                                  unsigned AddressSpace) const {
+	if (Src->isVectorTy())
+		return TargetTransformInfo::getMemoryOpCost(Opcode, Src, Alignment,
+		                                            AddressSpace);
+
+	std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(Src);
+	unsigned Op = Opcode == Instruction::Store ? LC3b::STW : LC3b::LDW;
+	return LT.first * getInstrCost(Op);
+}
@@ -0,0 +1,175 @@
+//===-- LC3bAsmBackend.cpp - LC3b Asm Backend -----------------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the LC3bAsmBackend class, which resolves the fixups
+// left by LC3bMCCodeEmitter and creates the ELF object writer.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3bFixupKinds.h"
+#include "LC3bMCTargetDesc.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAssembler.h"
+#include "llvm/MC/MCDirectives.h"
+#include "llvm/MC/MCELFObjectWriter.h"
+#include "llvm/MC/MCFixupKindInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+/// adjustFixupValue - Turn the resolved fixup Value into the contents of the
+/// field. For PC relative fixups Value is the distance from the instruction,
+/// PCoffset9/PCoffset11 count words from the next one.
+static uint64_t adjustFixupValue(unsigned Kind, uint64_t Value) {
+	switch (Kind) {
+	default:
+		llvm_unreachable("Unknown fixup kind!");
+	case FK_Data_1:
+	case FK_Data_2:
+	case FK_Data_4:
+	case FK_PCRel_4:
+	case LC3b::fixup_LC3b_16:
+		return Value;
+	case LC3b::fixup_LC3b_PC9:
+	case LC3b::fixup_LC3b_PC11: {
+		int64_t Offset = (int64_t)Value - 2;
+		if (Offset & 1)
+			report_fatal_error("LC3b: PC relative target is not word aligned");
+		Offset >>= 1;
+		if (Kind == LC3b::fixup_LC3b_PC9 ? !isInt<9>(Offset) : !isInt<11>(Offset))
+			report_fatal_error("LC3b: PC relative target out of range");
+		return Offset;
+	}
+	case LC3b::fixup_LC3b_SDA6:
+	case LC3b::fixup_LC3b_SDA6W: {
+		int64_t Offset = (int64_t)Value;
+		if (Kind == LC3b::fixup_LC3b_SDA6W) {
+			if (Offset & 1)
+				report_fatal_error("LC3b: small data word is not word aligned");
+			Offset >>= 1;
+		}
+		if (!isInt<6>(Offset))
+			report_fatal_error("LC3b: small data object out of range of _SDA_BASE_");
+		return Offset;
+	}
+	}
+}
+
+namespace {
+class LC3bAsmBackend : public MCAsmBackend {
+	Triple::OSType OSType;
+	bool IsLittle;	// Big or little endian
+
+public:
+	LC3bAsmBackend(const Target &T, Triple::OSType _OSType, bool _isLittle)
+		: MCAsmBackend(), OSType(_OSType), IsLittle(_isLittle) {}
+
+	MCObjectWriter *createObjectWriter(raw_ostream &OS) const {
+		return createLC3bELFObjectWriter(OS,
+			MCELFObjectTargetWriter::getOSABI(OSType), IsLittle);
+	}
+
+	/// applyFixup - Apply the Value for given Fixup into the provided data
+	/// fragment, at the offset specified by the fixup.
+	void applyFixup(const MCFixup &Fixup, char *Data, unsigned DataSize,
+	                uint64_t Value) const {
+		MCFixupKind Kind = Fixup.getKind();
+		Value = adjustFixupValue((unsigned)Kind, Value);
+
+		const MCFixupKindInfo &Info = getFixupKindInfo(Kind);
+		unsigned Offset = Fixup.getOffset();
+
+		// Instructions and .2byte data are 16-bit words, FK_Data_1 is a byte
+		// and the 4-byte kinds are DWARF data.
+		unsigned FullSize = Kind < FirstTargetFixupKind ?
+		                    (Info.TargetSize + 7) / 8 : 2;
+		assert(Offset + FullSize <= DataSize && "Invalid fixup offset!");
+
+		// Big endian fixup offsets count from the most significant bit.
+		unsigned Shift = IsLittle ? Info.TargetOffset :
+		                 FullSize * 8 - Info.TargetOffset - Info.TargetSize;
+		uint64_t Mask = ((uint64_t)(-1) >> (64 - Info.TargetSize));
+		Value = (Value & Mask) << Shift;
+
+		for (unsigned i = 0; i != FullSize; ++i) {
+			unsigned Idx = IsLittle ? i : (FullSize - 1 - i);
+			Data[Offset + Idx] |= (uint8_t)((Value >> (i * 8)) & 0xff);
+		}
+	}
+
+	unsigned getNumFixupKinds() const { return LC3b::NumTargetFixupKinds; }
+
+	const MCFixupKindInfo &getFixupKindInfo(MCFixupKind Kind) const {
+		const static MCFixupKindInfo InfosLE[LC3b::NumTargetFixupKinds] = {
+			// This table *must* be in same the order of fixup_* kinds in
+			// LC3bFixupKinds.h.
+			//
+			// name                 offset  bits  flags
+			{ "fixup_LC3b_16",      0,      16,   0 },
+			{ "fixup_LC3b_PC9",     0,      9,    MCFixupKindInfo::FKF_IsPCRel },
+			{ "fixup_LC3b_PC11",    0,      11,   MCFixupKindInfo::FKF_IsPCRel },
+			{ "fixup_LC3b_SDA6",    0,      6,    0 },
+			{ "fixup_LC3b_SDA6W",   0,      6,    0 }
+		};
+		// The same fields, counted from the most significant bit of the word.
+		const static MCFixupKindInfo InfosBE[LC3b::NumTargetFixupKinds] = {
+			// name                 offset  bits  flags
+			{ "fixup_LC3b_16",      0,      16,   0 },
+			{ "fixup_LC3b_PC9",     7,      9,    MCFixupKindInfo::FKF_IsPCRel },
+			{ "fixup_LC3b_PC11",    5,      11,   MCFixupKindInfo::FKF_IsPCRel },
+			{ "fixup_LC3b_SDA6",    10,     6,    0 },
+			{ "fixup_LC3b_SDA6W",   10,     6,    0 }
+		};
+
+		if (Kind < FirstTargetFixupKind)
+			return MCAsmBackend::getFixupKindInfo(Kind);
+
+		assert(unsigned(Kind - FirstTargetFixupKind) < getNumFixupKinds() &&
+		       "Invalid kind!");
+		return (IsLittle ? InfosLE : InfosBE)[Kind - FirstTargetFixupKind];
+	}
+
+	/// mayNeedRelaxation - Out of range branches are rewritten before
+	/// emission, the assembler never relaxes.
+	bool mayNeedRelaxation(const MCInst &Inst) const {
+		return false;
+	}
+
+	bool fixupNeedsRelaxation(const MCFixup &Fixup, uint64_t Value,
+	                          const MCRelaxableFragment *DF,
+	                          const MCAsmLayout &Layout) const {
+		llvm_unreachable("LC3b does not relax instructions");
+	}
+
+	void relaxInstruction(const MCInst &Inst, MCInst &Res) const {
+		llvm_unreachable("LC3b does not relax instructions");
+	}
+
+	/// writeNopData - BR with no condition bits set (0x0000) is the nop.
+	bool writeNopData(uint64_t Count, MCObjectWriter *OW) const {
+		if (Count % 2)
+			return false;
+		for (uint64_t i = 0; i != Count / 2; ++i)
+			OW->Write16(0);
+		return true;
+	}
+}; // class LC3bAsmBackend
+} // end anonymous namespace
+
+MCAsmBackend *llvm::createLC3bAsmBackendEB(const Target &T, StringRef TT,
+                                           StringRef CPU) {
+	return new LC3bAsmBackend(T, Triple(TT).getOS(), /*IsLittle*/false);
+}
+
+MCAsmBackend *llvm::createLC3bAsmBackendEL(const Target &T, StringRef TT,
+                                           StringRef CPU) {
+	return new LC3bAsmBackend(T, Triple(TT).getOS(), /*IsLittle*/true);
+}
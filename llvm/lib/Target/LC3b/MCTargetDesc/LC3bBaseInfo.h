@@ -8,25 +8,37 @@
 //===----------------------------------------------------------------------===//
 //
 // This file contains small standalone helper functions and enum definitions for
-// the Cpu0 target useful for the compiler back-end and the MC libraries.
+// the LC3b target useful for the compiler back-end and the MC libraries.
 //
 //===----------------------------------------------------------------------===//
 #ifndef LC3bBASEINFO_H
 #define LC3bBASEINFO_H
 
-#include "Cpu0FixupKinds.h"
-#include "Cpu0MCTargetDesc.h"
+#include "LC3bFixupKinds.h"
+#include "LC3bMCTargetDesc.h"
 #include "llvm/MC/MCExpr.h"
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/ErrorHandling.h"
 
 
 namespace llvm {
-/// Cpu0II - This namespace holds all of the target specific flags that
+/// LC3bII - This namespace holds all of the target specific flags that
 /// instruction info tracks.
 ///
 		namespace LC3bII {
-		/// Target Operand Flag enum.
+				/// Target Operand Flag enum.
+				enum TOF {
+					//===------------------------------------------------------------------===//
+					// LC3b Specific MachineOperand flags.
+
+					MO_NO_FLAG,
+
+					/// MO_SDAREL - Offset of a small data object from _SDA_BASE_,
+					/// the address R5 holds, printed as sym@SDAREL. Only in the
+					/// offset6 of LDB/LDW/STB/STW.
+					MO_SDAREL
+				};
+
 				enum {
 					//===------------------------------------------------------------------===//
 					// Instruction encodings. These are the standard/most common forms for
@@ -43,12 +55,13 @@ namespace llvm {
 					FrmL = 2,
 					/// FrmJ - This form is for
 					 FrmJ = 3,
-					FrmRTI=4;
-					FrmSHF=5;
-					FrmMEM=6;
-					FrmJSR=7;
-					FrmLEA=8;
-					FrmTRAP=9;
+					FrmRTI=4,
+					FrmSHF=5,
+					FrmMEM=6,
+					FrmJSR=7,
+					FrmLEA=8,
+					FrmTRAP=9,
+					FrmBR=10,
 					/// FrmOther - This form is for instructions that have no specific format.
 				//FIXME
 					FormMask = 15 
@@ -76,12 +89,6 @@ namespace llvm {
 				return 6;
 				case LC3b::R7:
 				return 7;
-				case LC3b::PSR:
-				return 8;
-				case LC3b::PC:
-				return 9;
-				case LC3b::IR:
-				return 10;
 				default: llvm_unreachable("Unknown register number!");
 				}
 		}
@@ -0,0 +1,76 @@
+//===-- LC3bELFObjectWriter.cpp - LC3b ELF Writer -------------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file maps the LC3b fixups left unresolved by the assembler to ELF
+// relocations.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3bFixupKinds.h"
+#include "LC3bMCTargetDesc.h"
+#include "llvm/MC/MCELFObjectWriter.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCValue.h"
+#include "llvm/Support/ELF.h"
+#include "llvm/Support/ErrorHandling.h"
+using namespace llvm;
+
+namespace {
+	class LC3bELFObjectWriter : public MCELFObjectTargetWriter {
+	public:
+		LC3bELFObjectWriter(uint8_t OSABI);
+
+		virtual ~LC3bELFObjectWriter();
+
+		virtual unsigned GetRelocType(const MCValue &Target, const MCFixup &Fixup,
+		                              bool IsPCRel, bool IsRelocWithSymbol,
+		                              int64_t Addend) const;
+	};
+}
+
+LC3bELFObjectWriter::LC3bELFObjectWriter(uint8_t OSABI)
+	: MCELFObjectTargetWriter(/*Is64Bit*/false, OSABI, ELF::EM_LC3B,
+	                          /*HasRelocationAddend*/true) {}
+
+LC3bELFObjectWriter::~LC3bELFObjectWriter() {}
+
+unsigned LC3bELFObjectWriter::GetRelocType(const MCValue &Target,
+                                           const MCFixup &Fixup,
+                                           bool IsPCRel,
+                                           bool IsRelocWithSymbol,
+                                           int64_t Addend) const {
+	switch ((unsigned)Fixup.getKind()) {
+	default:
+		llvm_unreachable("invalid fixup kind!");
+	case FK_Data_1:
+		return ELF::R_LC3B_8;
+	// Only .eh_frame and the DWARF sections have 32-bit fields.
+	case FK_Data_4:
+		return IsPCRel ? ELF::R_LC3B_PC32 : ELF::R_LC3B_32;
+	case FK_PCRel_4:
+		return ELF::R_LC3B_PC32;
+	case FK_Data_2:
+	case LC3b::fixup_LC3b_16:
+		return ELF::R_LC3B_16;
+	case LC3b::fixup_LC3b_PC9:
+		return ELF::R_LC3B_PC9;
+	case LC3b::fixup_LC3b_PC11:
+		return ELF::R_LC3B_PC11;
+	case LC3b::fixup_LC3b_SDA6:
+		return ELF::R_LC3B_SDA6;
+	case LC3b::fixup_LC3b_SDA6W:
+		return ELF::R_LC3B_SDA6W;
+	}
+}
+
+MCObjectWriter *llvm::createLC3bELFObjectWriter(raw_ostream &OS,
+                                                uint8_t OSABI,
+                                                bool IsLittleEndian) {
+	MCELFObjectTargetWriter *MOTW = new LC3bELFObjectWriter(OSABI);
+	return createELFObjectWriter(MOTW, OS, IsLittleEndian);
+}
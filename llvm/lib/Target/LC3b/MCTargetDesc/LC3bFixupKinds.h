@@ -16,12 +16,24 @@ namespace llvm {
 		// to be uniquely named.
 		//
 		// This table *must* be in the save order of
-		// MCFixupKindInfo Infos[Cpu0::NumTargetFixupKinds]
-		// in Cpu0AsmBackend.cpp.
+		// MCFixupKindInfo Infos[LC3b::NumTargetFixupKinds]
+		// in LC3bAsmBackend.cpp.
 		//
 				enum Fixups {
-				// Branch fixups resulting in R_CPU0_16.
+				// Absolute 16-bit address, resulting in R_LC3B_16.
 				fixup_LC3b_16 = FirstTargetFixupKind,
+				// PCoffset9 of BR and LEA, in words from the next instruction,
+				// resulting in R_LC3B_PC9.
+				fixup_LC3b_PC9,
+				// PCoffset11 of JSR, in words from the next instruction,
+				// resulting in R_LC3B_PC11.
+				fixup_LC3b_PC11,
+				// offset6 of LDB/STB from _SDA_BASE_ in bytes, resulting in
+				// R_LC3B_SDA6.
+				fixup_LC3b_SDA6,
+				// offset6 of LDW/STW from _SDA_BASE_ in words, resulting in
+				// R_LC3B_SDA6W.
+				fixup_LC3b_SDA6W,
 				// Marker
 				LastTargetFixupKind,
 				NumTargetFixupKinds = LastTargetFixupKind - FirstTargetFixupKind
@@ -29,4 +41,3 @@ namespace llvm {
 		} // namespace LC3b
 } // namespace llvm
 #endif // LLVM_LC3b_LC3bFIXUPKINDS_H
-
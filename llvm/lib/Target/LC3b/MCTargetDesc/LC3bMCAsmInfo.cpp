@@ -7,7 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file contains the declarations of the Cpu0MCAsmInfo properties.
+// This file contains the declarations of the LC3bMCAsmInfo properties.
 //
 //===----------------------------------------------------------------------===//
 #include "LC3bMCAsmInfo.h"
@@ -18,15 +18,14 @@ using namespace llvm;
 void LC3bMCAsmInfo::anchor() { }
 LC3bMCAsmInfo::LC3bMCAsmInfo(const Target &T, StringRef TT) {
 		Triple TheTriple(TT);
-		if ((TheTriple.getArch() == Triple::LC3b)) //FIXME : LC3b or lc3b
-		// FIXME: everything below this line
-		IsLittleEndian = false;
+		IsLittleEndian = TheTriple.getArch() == Triple::lc3bel;
 		AlignmentIsInBytes = false;
 		Data16bitsDirective = "\t.2byte\t";
 		Data32bitsDirective = "\t.4byte\t";
 		Data64bitsDirective = "\t.8byte\t";
 		PrivateGlobalPrefix = "$";
-		CommentString	=	"#";
+		// '#' starts a decimal immediate in LC-3b assembly.
+		CommentString	=	";";
 		ZeroDirective   =	"\t.space\t";
 		GPRel32Directive = "\t.gpword\t";
 		GPRel64Directive = "\t.gpdword\t";
@@ -7,7 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file contains the declaration of the Cpu0MCAsmInfo class.
+// This file contains the declaration of the LC3bMCAsmInfo class.
 //
 //===----------------------------------------------------------------------===//
 #ifndef LC3bTARGETASMINFO_H
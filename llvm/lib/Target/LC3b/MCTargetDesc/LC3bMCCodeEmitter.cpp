@@ -0,0 +1,182 @@
+//===-- LC3bMCCodeEmitter.cpp - Convert LC3b Code to Machine Code ---------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the LC3bMCCodeEmitter class. The Inst{15-0} encodings
+// come from LC3bInstrFormats.td, PC relative operands become fixups that
+// LC3bAsmBackend resolves.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "mccodeemitter"
+#include "LC3bBaseInfo.h"
+#include "LC3bFixupKinds.h"
+#include "LC3bMCTargetDesc.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(MCNumEmitted, "Number of MC instructions emitted");
+
+namespace {
+class LC3bMCCodeEmitter : public MCCodeEmitter {
+	LC3bMCCodeEmitter(const LC3bMCCodeEmitter &) LLVM_DELETED_FUNCTION;
+	void operator=(const LC3bMCCodeEmitter &) LLVM_DELETED_FUNCTION;
+	const MCInstrInfo &MCII;
+	MCContext &Ctx;
+	bool IsLittleEndian;
+
+public:
+	LC3bMCCodeEmitter(const MCInstrInfo &mcii, MCContext &Ctx_, bool IsLittle)
+		: MCII(mcii), Ctx(Ctx_), IsLittleEndian(IsLittle) {}
+
+	~LC3bMCCodeEmitter() {}
+
+	void EncodeInstruction(const MCInst &MI, raw_ostream &OS,
+	                       SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getBinaryCodeForInstr - TableGen'erated function for getting the
+	// binary encoding for an instruction.
+	uint64_t getBinaryCodeForInstr(const MCInst &MI,
+	                               SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getMachineOpValue - Return binary encoding of a register or immediate
+	// operand.
+	unsigned getMachineOpValue(const MCInst &MI, const MCOperand &MO,
+	                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getMemEncoding - Return {base, offset6} of a mem operand.
+	unsigned getMemEncoding(const MCInst &MI, unsigned OpNo,
+	                        SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getJumpTargetOpValue - Return PCoffset11 of JSR, or zero and a
+	// fixup_LC3b_PC11 if the target is a symbol.
+	unsigned getJumpTargetOpValue(const MCInst &MI, unsigned OpNo,
+	                              SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getBranchTargetOpValue - Return PCoffset9 of BR, or zero and a
+	// fixup_LC3b_PC9 if the target is a symbol.
+	unsigned getBranchTargetOpValue(const MCInst &MI, unsigned OpNo,
+	                                SmallVectorImpl<MCFixup> &Fixups) const;
+
+	// getPCRel9OpValue - Return PCoffset9 of LEA, or zero and a
+	// fixup_LC3b_PC9 if the target is a symbol.
+	unsigned getPCRel9OpValue(const MCInst &MI, unsigned OpNo,
+	                          SmallVectorImpl<MCFixup> &Fixups) const;
+
+private:
+	unsigned getPCRelOpValue(const MCOperand &MO, LC3b::Fixups Kind,
+	                         SmallVectorImpl<MCFixup> &Fixups) const;
+};
+} // end anonymous namespace
+
+MCCodeEmitter *llvm::createLC3bMCCodeEmitterEB(const MCInstrInfo &MCII,
+                                               const MCRegisterInfo &MRI,
+                                               const MCSubtargetInfo &STI,
+                                               MCContext &Ctx) {
+	return new LC3bMCCodeEmitter(MCII, Ctx, false);
+}
+
+MCCodeEmitter *llvm::createLC3bMCCodeEmitterEL(const MCInstrInfo &MCII,
+                                               const MCRegisterInfo &MRI,
+                                               const MCSubtargetInfo &STI,
+                                               MCContext &Ctx) {
+	return new LC3bMCCodeEmitter(MCII, Ctx, true);
+}
+
+/// EncodeInstruction - Emit the 16-bit instruction word.
+void LC3bMCCodeEmitter::
+EncodeInstruction(const MCInst &MI, raw_ostream &OS,
+                  SmallVectorImpl<MCFixup> &Fixups) const {
+	const MCInstrDesc &Desc = MCII.get(MI.getOpcode());
+	if ((Desc.TSFlags & LC3bII::FormMask) == LC3bII::Pseudo)
+		llvm_unreachable("Pseudo opcode found in EncodeInstruction()");
+
+	uint16_t Binary = getBinaryCodeForInstr(MI, Fixups);
+	if (IsLittleEndian) {
+		OS << (char)(Binary & 0xff);
+		OS << (char)(Binary >> 8);
+	} else {
+		OS << (char)(Binary >> 8);
+		OS << (char)(Binary & 0xff);
+	}
+	++MCNumEmitted;
+}
+
+unsigned LC3bMCCodeEmitter::
+getMachineOpValue(const MCInst &MI, const MCOperand &MO,
+                  SmallVectorImpl<MCFixup> &Fixups) const {
+	if (MO.isReg())
+		return getLC3bRegisterNumbering(MO.getReg());
+	if (MO.isImm())
+		return static_cast<unsigned>(MO.getImm());
+	llvm_unreachable("Unexpected operand, symbols only appear in PC relative "
+	                 "and mem operands");
+}
+
+unsigned LC3bMCCodeEmitter::
+getMemEncoding(const MCInst &MI, unsigned OpNo,
+               SmallVectorImpl<MCFixup> &Fixups) const {
+	unsigned Base = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+	const MCOperand &MO = MI.getOperand(OpNo + 1);
+	bool IsWord = MI.getOpcode() == LC3b::LDW || MI.getOpcode() == LC3b::STW;
+
+	// A small data object, sym@SDAREL off the R5 base.
+	if (MO.isExpr()) {
+		LC3b::Fixups Kind = IsWord ? LC3b::fixup_LC3b_SDA6W : LC3b::fixup_LC3b_SDA6;
+		Fixups.push_back(MCFixup::Create(0, MO.getExpr(), MCFixupKind(Kind)));
+		return Base << 6;
+	}
+
+	// The offset is in bytes, LDW/STW scale offset6 by two.
+	int64_t Offset = MO.getImm();
+	if (IsWord) {
+		assert((Offset & 1) == 0 && "Unaligned word offset");
+		Offset >>= 1;
+	}
+	assert(isInt<6>(Offset) && "offset6 out of range");
+	return (Base << 6) | (Offset & 0x3f);
+}
+
+unsigned LC3bMCCodeEmitter::
+getPCRelOpValue(const MCOperand &MO, LC3b::Fixups Kind,
+                SmallVectorImpl<MCFixup> &Fixups) const {
+	// An immediate is already a word offset from the next instruction.
+	if (MO.isImm())
+		return static_cast<unsigned>(MO.getImm());
+
+	assert(MO.isExpr() && "PC relative operand is not an expression");
+	Fixups.push_back(MCFixup::Create(0, MO.getExpr(), MCFixupKind(Kind)));
+	return 0;
+}
+
+unsigned LC3bMCCodeEmitter::
+getJumpTargetOpValue(const MCInst &MI, unsigned OpNo,
+                     SmallVectorImpl<MCFixup> &Fixups) const {
+	return getPCRelOpValue(MI.getOperand(OpNo), LC3b::fixup_LC3b_PC11, Fixups);
+}
+
+unsigned LC3bMCCodeEmitter::
+getBranchTargetOpValue(const MCInst &MI, unsigned OpNo,
+                       SmallVectorImpl<MCFixup> &Fixups) const {
+	return getPCRelOpValue(MI.getOperand(OpNo), LC3b::fixup_LC3b_PC9, Fixups);
+}
+
+unsigned LC3bMCCodeEmitter::
+getPCRel9OpValue(const MCInst &MI, unsigned OpNo,
+                 SmallVectorImpl<MCFixup> &Fixups) const {
+	return getPCRelOpValue(MI.getOperand(OpNo), LC3b::fixup_LC3b_PC9, Fixups);
+}
+
+#include "LC3bGenMCCodeEmitter.inc"
@@ -4,8 +4,12 @@
 //
 //===----------------------------------------------------------------------===//
 #include "LC3bMCTargetDesc.h"
+#include "LC3bMCAsmInfo.h"
+#include "InstPrinter/LC3bInstPrinter.h"
 #include "llvm/MC/MachineLocation.h"
 #include "llvm/MC/MCCodeGenInfo.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrAnalysis.h"
 #include "llvm/MC/MCInstrInfo.h"
 #include "llvm/MC/MCRegisterInfo.h"
 #include "llvm/MC/MCStreamer.h"
@@ -24,19 +28,12 @@
 
 using namespace llvm;
 
-extern "C" void LLVMInitializeLC3bTargetMC () {
-
-	
-}
-
-
-
 static std::string ParseLC3bTriple(StringRef TT, StringRef CPU) {
 		std::string LC3bArchFeature;
 		size_t DashPosition = 0;
 		StringRef TheTriple;
-		// Let’s see if there is a dash, like cpu0-unknown-linux.
-		DashPosition = TT.find(’-’);
+		// Let's see if there is a dash, like lc3b-unknown-linux.
+		DashPosition = TT.find('-');
 		if (DashPosition == StringRef::npos) {
 				// No dash, we check the string size.
 				TheTriple = TT.substr(0);
@@ -44,8 +41,8 @@ static std::string ParseLC3bTriple(StringRef TT, StringRef CPU) {
 				// We are only interested in substring before dash.
 				TheTriple = TT.substr(0,DashPosition);
 		}
-		if (TheTriple == "LC3b" || TheTriple == "LC3bel") {
-				if (CPU.empty() || CPU == "cpu032") {  //FIXME : cpu0 name
+		if (TheTriple == "lc3b" || TheTriple == "lc3bel") {
+				if (CPU.empty() || CPU == "LC3b" || CPU == "cpu032") {
 						LC3bArchFeature = "+cpu032";
 				}
 		}
@@ -58,7 +55,7 @@ static MCInstrInfo *createLC3bMCInstrInfo() {
 }
 static MCRegisterInfo *createLC3bMCRegisterInfo(StringRef TT) {
 		MCRegisterInfo *X = new MCRegisterInfo();
-		InitLC3bMCRegisterInfo(X, LC3b::LR); // defined in LC3bGenRegisterInfo.inc   //FIXME what is LC3b::LR
+		InitLC3bMCRegisterInfo(X, LC3b::R7); // defined in LC3bGenRegisterInfo.inc, R7 holds the return address
 		return X;
 }
 static MCSubtargetInfo *createLC3bMCSubtargetInfo(StringRef TT, StringRef CPU,
@@ -77,19 +74,49 @@ StringRef FS) {
 static MCAsmInfo *createLC3bMCAsmInfo(const Target &T, StringRef TT) {
 		MCAsmInfo *MAI = new LC3bMCAsmInfo(T, TT);
 		MachineLocation Dst(MachineLocation::VirtualFP);
-		MachineLocation Src(LC3b::SP, 0);
+		MachineLocation Src(LC3b::R6, 0);
 		MAI->addInitialFrameState(0, Dst, Src);
 		return MAI;
 }
 static MCCodeGenInfo *createLC3bMCCodeGenInfo(StringRef TT, Reloc::Model RM,CodeModel::Model CM, CodeGenOpt::Level OL) {
 		MCCodeGenInfo *X = new MCCodeGenInfo();
-		if (CM == CodeModel::JITDefault)
+		// LC3b code is not position independent: there is no GOT, and jump
+		// tables and long branches hold absolute addresses.
 		RM = Reloc::Static;
-		else if (RM == Reloc::Default)
-		RM = Reloc::PIC_;
 		X->InitMCCodeGenInfo(RM, CM, OL); // defined in lib/MC/MCCodeGenInfo.cpp
 		return X;
 }
+namespace {
+		class LC3bMCInstrAnalysis : public MCInstrAnalysis {
+		public:
+				LC3bMCInstrAnalysis(const MCInstrInfo *Info) : MCInstrAnalysis(Info) {}
+
+				/// evaluateBranch - BR and JSR offsets count words from the next
+				/// instruction. JMP, JSRR and RET go through a register, TRAP
+				/// through the vector table.
+				virtual uint64_t evaluateBranch(const MCInst &Inst, uint64_t Addr,
+				                                uint64_t Size) const {
+						if ((!isBranch(Inst) && !isCall(Inst)) ||
+						    Inst.getOpcode() == LC3b::TRAP ||
+						    Inst.getNumOperands() == 0 || !Inst.getOperand(0).isImm())
+								return -1ULL;
+						return Addr + Size + Inst.getOperand(0).getImm() * 2;
+				}
+		};
+}
+
+static MCInstrAnalysis *createLC3bMCInstrAnalysis(const MCInstrInfo *Info) {
+		return new LC3bMCInstrAnalysis(Info);
+}
+
+static MCStreamer *createMCStreamer(const Target &T, StringRef TT,
+                                    MCContext &Ctx, MCAsmBackend &MAB,
+                                    raw_ostream &_OS,
+                                    MCCodeEmitter *_Emitter,
+                                    bool RelaxAll,
+                                    bool NoExecStack) {
+		return createELFStreamer(Ctx, MAB, _OS, _Emitter, RelaxAll, NoExecStack);
+}
 static MCInstPrinter *createLC3bMCInstPrinter(const Target &T,
 unsigned SyntaxVariant,
 const MCAsmInfo &MAI,
@@ -111,6 +138,12 @@ extern "C" void LLVMInitializeLC3bTargetMC() {
 		// Register the MC instruction info.
 		TargetRegistry::RegisterMCInstrInfo(TheLC3bTarget, createLC3bMCInstrInfo);
 		TargetRegistry::RegisterMCInstrInfo(TheLC3belTarget, createLC3bMCInstrInfo);
+		// Register the MC instruction analyzer, llvm-objdump resolves BR/JSR
+		// targets with it.
+		TargetRegistry::RegisterMCInstrAnalysis(TheLC3bTarget,
+		createLC3bMCInstrAnalysis);
+		TargetRegistry::RegisterMCInstrAnalysis(TheLC3belTarget,
+		createLC3bMCInstrAnalysis);
 		// Register the MC register info.
 		TargetRegistry::RegisterMCRegInfo(TheLC3bTarget, createLC3bMCRegisterInfo);
 		TargetRegistry::RegisterMCRegInfo(TheLC3belTarget, createLC3bMCRegisterInfo);
@@ -124,5 +157,18 @@ extern "C" void LLVMInitializeLC3bTargetMC() {
 		createLC3bMCInstPrinter);
 		TargetRegistry::RegisterMCInstPrinter(TheLC3belTarget,
 		createLC3bMCInstPrinter);
-}
 
+		// Register the MC code emitter.
+		TargetRegistry::RegisterMCCodeEmitter(TheLC3bTarget,
+		createLC3bMCCodeEmitterEB);
+		TargetRegistry::RegisterMCCodeEmitter(TheLC3belTarget,
+		createLC3bMCCodeEmitterEL);
+		// Register the object streamer, llc -filetype=obj writes ELF directly.
+		TargetRegistry::RegisterMCObjectStreamer(TheLC3bTarget, createMCStreamer);
+		TargetRegistry::RegisterMCObjectStreamer(TheLC3belTarget, createMCStreamer);
+		// Register the asm backend.
+		TargetRegistry::RegisterMCAsmBackend(TheLC3bTarget,
+		createLC3bAsmBackendEB);
+		TargetRegistry::RegisterMCAsmBackend(TheLC3belTarget,
+		createLC3bAsmBackendEL);
+}
@@ -0,0 +1,50 @@
+#ifndef LC3bMCTARGETDESC_H
+#define LC3bMCTARGETDESC_H
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+		class MCAsmBackend;
+		class MCCodeEmitter;
+		class MCContext;
+		class MCInstrInfo;
+		class MCObjectWriter;
+		class MCRegisterInfo;
+		class MCSubtargetInfo;
+		class StringRef;
+		class Target;
+		class raw_ostream;
+
+		extern Target TheLC3bTarget;
+		extern Target TheLC3belTarget;
+
+		MCCodeEmitter *createLC3bMCCodeEmitterEB(const MCInstrInfo &MCII,
+		                                         const MCRegisterInfo &MRI,
+		                                         const MCSubtargetInfo &STI,
+		                                         MCContext &Ctx);
+		MCCodeEmitter *createLC3bMCCodeEmitterEL(const MCInstrInfo &MCII,
+		                                         const MCRegisterInfo &MRI,
+		                                         const MCSubtargetInfo &STI,
+		                                         MCContext &Ctx);
+
+		MCAsmBackend *createLC3bAsmBackendEB(const Target &T, StringRef TT,
+		                                     StringRef CPU);
+		MCAsmBackend *createLC3bAsmBackendEL(const Target &T, StringRef TT,
+		                                     StringRef CPU);
+
+		MCObjectWriter *createLC3bELFObjectWriter(raw_ostream &OS,
+		                                          uint8_t OSABI,
+		                                          bool IsLittleEndian);
+} // End llvm namespace
+
+
+// Defines symbolic names for LC3bregisters. This defines a mapping from
+// register name to register number.
+#define GET_REGINFO_ENUM
+#include "LC3bGenRegisterInfo.inc"
+// Defines symbolic names for the LC3binstructions.
+#define GET_INSTRINFO_ENUM
+#include "LC3bGenInstrInfo.inc"
+#define GET_SUBTARGETINFO_ENUM
+#include "LC3bGenSubtargetInfo.inc"
+#endif
+
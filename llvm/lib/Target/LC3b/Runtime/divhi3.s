@@ -0,0 +1,66 @@
+;===-- divhi3.s - 16-bit signed divide and modulo for LC3b ---------------===;
+;
+; The LLVM Compiler Infrastructure
+;
+; This file is distributed under the University of Illinois Open Source
+; License. See LICENSE.TXT for details.
+;
+;===----------------------------------------------------------------------===;
+;
+; int16_t __divhi3(int16_t n, int16_t d)
+; int16_t __modhi3(int16_t n, int16_t d)
+;
+; Divide the magnitudes with __udivhi3 and fix up the signs: the quotient
+; is negative when the operand signs differ, the remainder takes the sign
+; of the dividend (C semantics, truncating division).
+;
+;===----------------------------------------------------------------------===;
+
+	.text
+	.globl	__divhi3
+__divhi3:
+	ADD	R6, R6, #-4
+	STW	R7, R6, #0
+	XOR	R2, R0, R1		; sign of the quotient
+	STW	R2, R6, #1
+	JSR	sdiv_magnitudes
+	JSR	__udivhi3
+	LDW	R2, R6, #1
+	BRzp	div_done
+	XOR	R0, R0, #-1
+	ADD	R0, R0, #1
+div_done:
+	LDW	R7, R6, #0
+	ADD	R6, R6, #4
+	RET
+
+	.globl	__modhi3
+__modhi3:
+	ADD	R6, R6, #-4
+	STW	R7, R6, #0
+	STW	R0, R6, #1		; sign of the remainder
+	JSR	sdiv_magnitudes
+	JSR	__udivhi3
+	ADD	R0, R1, #0
+	LDW	R2, R6, #1
+	BRzp	mod_done
+	XOR	R0, R0, #-1
+	ADD	R0, R0, #1
+mod_done:
+	LDW	R7, R6, #0
+	ADD	R6, R6, #4
+	RET
+
+; Replace n and d with their magnitudes.
+sdiv_magnitudes:
+	ADD	R0, R0, #0
+	BRzp	sdiv_npos
+	XOR	R0, R0, #-1
+	ADD	R0, R0, #1
+sdiv_npos:
+	ADD	R1, R1, #0
+	BRzp	sdiv_dpos
+	XOR	R1, R1, #-1
+	ADD	R1, R1, #1
+sdiv_dpos:
+	RET
@@ -0,0 +1,46 @@
+;===-- mulhi3.s - 16-bit multiply for LC3b -------------------------------===;
+;
+; The LLVM Compiler Infrastructure
+;
+; This file is distributed under the University of Illinois Open Source
+; License. See LICENSE.TXT for details.
+;
+;===----------------------------------------------------------------------===;
+;
+; int16_t __mulhi3(int16_t a, int16_t b)
+;
+; Called by code generated for a multiply that LC3bTargetLowering::LowerMUL
+; could not turn into a short LSHF/ADD sequence. Follows CC_LC3b: a in R0,
+; b in R1, result in R0; only R0-R3 are clobbered.
+;
+; The low bits of the product do not depend on signedness, so this is a
+; plain shift-and-add over the bits of b. The loop is unrolled twice and
+; leaves as soon as the remaining multiplier is zero, so small multipliers
+; cost only a few iterations.
+;
+;===----------------------------------------------------------------------===;
+
+	.text
+	.globl	__mulhi3
+__mulhi3:
+	AND	R2, R2, #0		; R2 = product
+	ADD	R1, R1, #0
+	BRz	mul_done
+mul_loop:
+	AND	R3, R1, #1
+	BRz	mul_skip0
+	ADD	R2, R2, R0
+mul_skip0:
+	LSHF	R0, R0, #1
+	RSHFL	R1, R1, #1
+	BRz	mul_done
+	AND	R3, R1, #1
+	BRz	mul_skip1
+	ADD	R2, R2, R0
+mul_skip1:
+	LSHF	R0, R0, #1
+	RSHFL	R1, R1, #1
+	BRp	mul_loop
+mul_done:
+	ADD	R0, R2, #0
+	RET
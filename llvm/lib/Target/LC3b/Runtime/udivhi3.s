@@ -0,0 +1,75 @@
+;===-- udivhi3.s - 16-bit unsigned divide and modulo for LC3b ------------===;
+;
+; The LLVM Compiler Infrastructure
+;
+; This file is distributed under the University of Illinois Open Source
+; License. See LICENSE.TXT for details.
+;
+;===----------------------------------------------------------------------===;
+;
+; uint16_t __udivhi3(uint16_t n, uint16_t d)
+; uint16_t __umodhi3(uint16_t n, uint16_t d)
+;
+; Both entry points share one restoring division that leaves the quotient
+; in R0 and the remainder in R1. n is passed in R0 and d in R1 (CC_LC3b).
+; R4 is callee saved and is preserved on the stack. Division by zero
+; returns a quotient of 0xFFFF and the dividend as remainder.
+;
+;===----------------------------------------------------------------------===;
+
+	.text
+	.globl	__umodhi3
+__umodhi3:
+	ADD	R6, R6, #-2
+	STW	R7, R6, #0
+	JSR	__udivhi3
+	ADD	R0, R1, #0		; return the remainder
+	LDW	R7, R6, #0
+	ADD	R6, R6, #2
+	RET
+
+	.globl	__udivhi3
+__udivhi3:
+	ADD	R6, R6, #-2
+	STW	R4, R6, #0
+	XOR	R4, R1, #-1
+	ADD	R4, R4, #1		; R4 = -d
+	ADD	R1, R1, #0
+	BRn	udiv_big		; d >= 0x8000, quotient is 0 or 1
+
+	AND	R2, R2, #0		; R2 = partial remainder
+	AND	R3, R3, #0
+	ADD	R3, R3, #8
+	ADD	R3, R3, #8		; R3 = 16 iterations
+udiv_loop:
+	LSHF	R2, R2, #1
+	ADD	R0, R0, #0		; shift the top bit of n into r
+	BRzp	udiv_nobit
+	ADD	R2, R2, #1
+udiv_nobit:
+	LSHF	R0, R0, #1
+	ADD	R2, R2, R4		; r -= d, r < 2d keeps this exact
+	BRn	udiv_restore
+	ADD	R0, R0, #1		; set the quotient bit
+	BR	udiv_next
+udiv_restore:
+	ADD	R2, R2, R1
+udiv_next:
+	ADD	R3, R3, #-1
+	BRp	udiv_loop
+	ADD	R1, R2, #0
+	BR	udiv_done
+
+udiv_big:
+	ADD	R1, R0, #0		; remainder = n, quotient = 0
+	AND	R0, R0, #0
+	ADD	R1, R1, #0
+	BRzp	udiv_done		; n < 0x8000 <= d
+	ADD	R2, R1, R4		; both have the top bit set, n - d fits
+	BRn	udiv_done
+	ADD	R1, R2, #0
+	ADD	R0, R0, #1
+udiv_done:
+	LDW	R4, R6, #0
+	ADD	R6, R6, #2
+	RET
@@ -0,0 +1,309 @@
+//===-- LC3bSimulator.cpp - Cycle counting LC3b simulator -----------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the LC3b instruction set simulator.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3bSimulator.h"
+#include "MCTargetDesc/LC3bMCTargetDesc.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+const char *LC3bSim::getOpcodeName(unsigned Op) {
+	switch (Op) {
+		case BR:	return "br";
+		case ADD:	return "add";
+		case LDB:	return "ldb";
+		case STB:	return "stb";
+		case JSR:	return "jsr";
+		case AND:	return "and";
+		case LDW:	return "ldw";
+		case STW:	return "stw";
+		case RTI:	return "rti";
+		case XOR:	return "xor";
+		case JMP:	return "jmp";
+		case SHF:	return "shf";
+		case LEA:	return "lea";
+		case TRAP:	return "trap";
+		default:	return 0;
+	}
+}
+
+LC3bCycleModel::LC3bCycleModel(const MCInstrInfo &MII,
+                               const InstrItineraryData &Itins) {
+	// The instruction whose itinerary class prices each opcode. RTI and the
+	// reserved encodings stop the simulator and are never charged.
+	static const unsigned OpcodeInstr[LC3bSim::NumOpcodes] = {
+		LC3b::BRnzp, LC3b::ADD, LC3b::LDB, LC3b::STB,
+		LC3b::JSR, LC3b::AND, LC3b::LDW, LC3b::STW,
+		0, LC3b::XOR, 0, 0,
+		LC3b::JMP, LC3b::LSHF, LC3b::LEA, LC3b::TRAP
+	};
+	for (unsigned Op = 0; Op != LC3bSim::NumOpcodes; ++Op)
+		Latency[Op] = OpcodeInstr[Op] ?
+			Itins.getStageLatency(MII.get(OpcodeInstr[Op]).getSchedClass()) : 0;
+}
+
+//===----------------------------------------------------------------------===//
+// LC3bSimStats
+//===----------------------------------------------------------------------===//
+
+void LC3bSimStats::clear() {
+	Cycles = Instructions = TakenBranches = 0;
+	Loads = Stores = BytesRead = BytesWritten = 0;
+	for (unsigned i = 0; i != LC3bSim::NumOpcodes; ++i)
+		OpcodeCount[i] = OpcodeCycles[i] = 0;
+}
+
+void LC3bSimStats::print(raw_ostream &OS) const {
+	OS << "Total cycles:        " << Cycles << '\n';
+	OS << "Instructions:        " << Instructions << '\n';
+	if (Instructions)
+		OS << "CPI:                 "
+		   << format("%.2f", double(Cycles) / double(Instructions)) << '\n';
+	OS << "Taken branches:      " << TakenBranches << '\n';
+	OS << "Loads:               " << Loads << " (" << BytesRead << " bytes)\n";
+	OS << "Stores:              " << Stores << " (" << BytesWritten << " bytes)\n";
+	OS << "\nOpcode     Count      Cycles\n";
+	for (unsigned i = 0; i != LC3bSim::NumOpcodes; ++i) {
+		if (!OpcodeCount[i])
+			continue;
+		OS << format("%-8s %7llu %11llu\n", LC3bSim::getOpcodeName(i),
+		             (unsigned long long)OpcodeCount[i],
+		             (unsigned long long)OpcodeCycles[i]);
+	}
+}
+
+//===----------------------------------------------------------------------===//
+// LC3bSimulator
+//===----------------------------------------------------------------------===//
+
+LC3bSimulator::LC3bSimulator(const LC3bCycleModel &CM)
+	: CycleModel(CM), Memory(MemorySize, 0) {
+	reset();
+}
+
+void LC3bSimulator::reset() {
+	for (unsigned i = 0; i != 8; ++i)
+		Regs[i] = 0;
+	PC = 0;
+	// Z is set out of reset.
+	CC = 0x2;
+	Stats.clear();
+}
+
+uint16_t LC3bSimulator::readWord(uint16_t Addr) const {
+	Addr &= ~1;
+	return Memory[Addr] | (Memory[Addr + 1] << 8);
+}
+
+void LC3bSimulator::writeWord(uint16_t Addr, uint16_t V) {
+	Addr &= ~1;
+	Memory[Addr] = V & 0xff;
+	Memory[Addr + 1] = V >> 8;
+}
+
+bool LC3bSimulator::loadObject(StringRef Buffer, std::string &Err) {
+	SmallVector<StringRef, 64> Lines;
+	Buffer.split(Lines, "\n", -1, false);
+
+	bool HaveOrigin = false;
+	uint16_t Addr = 0;
+	for (unsigned i = 0, e = Lines.size(); i != e; ++i) {
+		StringRef Line = Lines[i];
+		// Allow ';' comments so hand written test programs can be annotated.
+		Line = Line.substr(0, Line.find(';')).trim();
+		if (Line.empty())
+			continue;
+		if (Line.startswith("0x") || Line.startswith("0X"))
+			Line = Line.drop_front(2);
+		else if (Line.startswith("x") || Line.startswith("X"))
+			Line = Line.drop_front(1);
+
+		unsigned Word;
+		if (Line.getAsInteger(16, Word) || Word > 0xffff) {
+			Err = "line " + utostr(i + 1) + ": expected a 16-bit hex word";
+			return true;
+		}
+		if (!HaveOrigin) {
+			if (Word & 1) {
+				Err = "origin must be word aligned";
+				return true;
+			}
+			Addr = Word;
+			PC = Word;
+			HaveOrigin = true;
+			continue;
+		}
+		writeWord(Addr, Word);
+		Addr += 2;
+	}
+
+	if (!HaveOrigin) {
+		Err = "empty object file";
+		return true;
+	}
+	return false;
+}
+
+void LC3bSimulator::setCC(uint16_t Value) {
+	if (Value & 0x8000)
+		CC = 0x4;
+	else if (Value == 0)
+		CC = 0x2;
+	else
+		CC = 0x1;
+}
+
+uint16_t LC3bSimulator::load(uint16_t Addr, bool Byte) {
+	++Stats.Loads;
+	if (Byte) {
+		++Stats.BytesRead;
+		return (uint16_t)SignExtend32<8>(Memory[Addr]);
+	}
+	Stats.BytesRead += 2;
+	return readWord(Addr);
+}
+
+void LC3bSimulator::store(uint16_t Addr, uint16_t Value, bool Byte) {
+	++Stats.Stores;
+	if (Byte) {
+		++Stats.BytesWritten;
+		Memory[Addr] = Value & 0xff;
+		return;
+	}
+	Stats.BytesWritten += 2;
+	writeWord(Addr, Value);
+}
+
+LC3bSimulator::StopReason LC3bSimulator::step() {
+	uint16_t Inst = readWord(PC);
+	unsigned Op = Inst >> 12;
+	unsigned DR = (Inst >> 9) & 7;
+	unsigned SR1 = (Inst >> 6) & 7;
+	uint16_t NextPC = PC + 2;
+	// PCoffset9 and PCoffset11 are word offsets from the incremented PC.
+	uint16_t Off9 = NextPC + (SignExtend32<9>(Inst & 0x1ff) << 1);
+	uint16_t Off11 = NextPC + (SignExtend32<11>(Inst & 0x7ff) << 1);
+	// offset6 is a byte offset for LDB/STB and a word offset for LDW/STW.
+	int32_t Off6 = SignExtend32<6>(Inst & 0x3f);
+	// Inst{5} selects between a register and an imm5 second operand.
+	uint16_t Src2 = (Inst & 0x20) ? (uint16_t)SignExtend32<5>(Inst & 0x1f)
+	                              : Regs[Inst & 7];
+
+	switch (Op) {
+		case LC3bSim::BR:
+			if ((Inst >> 9) & CC) {
+				NextPC = Off9;
+				++Stats.TakenBranches;
+			}
+			break;
+		case LC3bSim::ADD:
+			Regs[DR] = Regs[SR1] + Src2;
+			setCC(Regs[DR]);
+			break;
+		case LC3bSim::AND:
+			Regs[DR] = Regs[SR1] & Src2;
+			setCC(Regs[DR]);
+			break;
+		case LC3bSim::XOR:
+			Regs[DR] = Regs[SR1] ^ Src2;
+			setCC(Regs[DR]);
+			break;
+		case LC3bSim::SHF: {
+			unsigned Amount = Inst & 0xf;
+			uint16_t Src = Regs[SR1];
+			if (!(Inst & 0x10))
+				Regs[DR] = Src << Amount;
+			else if (!(Inst & 0x20))
+				Regs[DR] = Src >> Amount;
+			else
+				Regs[DR] = (uint16_t)((int16_t)Src >> Amount);
+			setCC(Regs[DR]);
+			break;
+		}
+		case LC3bSim::LEA:
+			// LEA does not set the condition codes on the LC3b.
+			Regs[DR] = Off9;
+			break;
+		case LC3bSim::LDB:
+			Regs[DR] = load(Regs[SR1] + Off6, true);
+			setCC(Regs[DR]);
+			break;
+		case LC3bSim::LDW:
+			Regs[DR] = load(Regs[SR1] + (Off6 << 1), false);
+			setCC(Regs[DR]);
+			break;
+		case LC3bSim::STB:
+			store(Regs[SR1] + Off6, Regs[DR], true);
+			break;
+		case LC3bSim::STW:
+			store(Regs[SR1] + (Off6 << 1), Regs[DR], false);
+			break;
+		case LC3bSim::JMP:
+			// RET is JMP R7.
+			NextPC = Regs[SR1];
+			++Stats.TakenBranches;
+			break;
+		case LC3bSim::JSR: {
+			// Read the base register before R7 is overwritten (JSRR R7).
+			uint16_t Target = (Inst & 0x800) ? Off11 : Regs[SR1];
+			Regs[7] = NextPC;
+			NextPC = Target;
+			++Stats.TakenBranches;
+			break;
+		}
+		case LC3bSim::TRAP:
+			if ((Inst & 0xff) == HaltVector) {
+				++Stats.Instructions;
+				++Stats.OpcodeCount[Op];
+				Stats.OpcodeCycles[Op] += CycleModel.getLatency(Op);
+				Stats.Cycles += CycleModel.getLatency(Op);
+				return Halted;
+			}
+			Regs[7] = NextPC;
+			NextPC = readWord((Inst & 0xff) << 1);
+			break;
+		default:
+			return IllegalOpcode;
+	}
+
+	unsigned Latency = CycleModel.getLatency(Op);
+	++Stats.Instructions;
+	++Stats.OpcodeCount[Op];
+	Stats.OpcodeCycles[Op] += Latency;
+	Stats.Cycles += Latency;
+
+	PC = NextPC;
+	return PC == 0 ? ReachedPCZero : Running;
+}
+
+LC3bSimulator::StopReason LC3bSimulator::run(uint64_t MaxSteps) {
+	for (uint64_t Steps = 0; !MaxSteps || Steps != MaxSteps; ++Steps) {
+		StopReason R = step();
+		if (R != Running)
+			return R;
+	}
+	return StepLimit;
+}
+
+void LC3bSimulator::printRegisters(raw_ostream &OS) const {
+	OS << "PC = " << format("x%04X", PC) << "  CC = "
+	   << ((CC & 0x4) ? 'N' : '-') << ((CC & 0x2) ? 'Z' : '-')
+	   << ((CC & 0x1) ? 'P' : '-') << '\n';
+	for (unsigned i = 0; i != 8; ++i)
+		OS << "R" << i << " = " << format("x%04X", Regs[i])
+		   << (i % 4 == 3 ? "\n" : "  ");
+}
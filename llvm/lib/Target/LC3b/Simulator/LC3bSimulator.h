@@ -0,0 +1,151 @@
+//===-- LC3bSimulator.h - Cycle counting LC3b simulator ---------*- C++ -*-===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an instruction set simulator for the LC3b. It decodes
+// the 16-bit encodings described in LC3bInstrFormats.td and charges every
+// executed instruction the latency of its itinerary class, read from
+// LC3bGenericItineraries through the MC layer, so code emitted by llc can be
+// timed without real hardware.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LC3BSIMULATOR_H
+#define LC3BSIMULATOR_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+#include <vector>
+
+namespace llvm {
+class InstrItineraryData;
+class MCInstrInfo;
+class raw_ostream;
+
+namespace LC3bSim {
+	/// Opcode - The 4-bit opcode field, Inst{15-12}.
+	enum Opcode {
+		BR   = 0x0,
+		ADD  = 0x1,
+		LDB  = 0x2,
+		STB  = 0x3,
+		JSR  = 0x4,
+		AND  = 0x5,
+		LDW  = 0x6,
+		STW  = 0x7,
+		RTI  = 0x8,
+		XOR  = 0x9,
+		JMP  = 0xc,
+		SHF  = 0xd,
+		LEA  = 0xe,
+		TRAP = 0xf,
+		NumOpcodes = 16
+	};
+
+	/// getOpcodeName - Return the mnemonic of the given 4-bit opcode, or 0 if
+	/// the encoding is reserved.
+	const char *getOpcodeName(unsigned Op);
+}
+
+/// LC3bCycleModel - Latency in cycles charged for each opcode. It is the
+/// latency of the itinerary class LC3bSchedule.td gives the matching
+/// instruction, so the simulator and the scheduler agree on the costs.
+struct LC3bCycleModel {
+	unsigned Latency[LC3bSim::NumOpcodes];
+
+	/// LC3bCycleModel - Read the latencies from the itineraries of the LC3b
+	/// MC subtarget, MII and Itins being its MCInstrInfo and itinerary data.
+	LC3bCycleModel(const MCInstrInfo &MII, const InstrItineraryData &Itins);
+
+	/// getLatency - Cycles charged for an instruction with opcode Op.
+	unsigned getLatency(unsigned Op) const { return Latency[Op]; }
+};
+
+/// LC3bSimStats - Counters collected while running a program.
+struct LC3bSimStats {
+	uint64_t Cycles;
+	uint64_t Instructions;
+	uint64_t OpcodeCount[LC3bSim::NumOpcodes];
+	uint64_t OpcodeCycles[LC3bSim::NumOpcodes];
+	uint64_t TakenBranches;
+	uint64_t Loads;
+	uint64_t Stores;
+	uint64_t BytesRead;
+	uint64_t BytesWritten;
+
+	LC3bSimStats() { clear(); }
+	void clear();
+	void print(raw_ostream &OS) const;
+};
+
+/// LC3bSimulator - Functional model of the LC3b with a per-instruction cycle
+/// cost. Memory is the full 64KB byte-addressed, little-endian space.
+class LC3bSimulator {
+public:
+	enum StopReason {
+		Running,		// Still executing.
+		Halted,			// Executed TRAP x25 (HALT).
+		ReachedPCZero,	// Control transferred to x0000.
+		StepLimit,		// Executed the maximum number of instructions.
+		IllegalOpcode	// Decoded RTI or a reserved opcode.
+	};
+
+	static const unsigned MemorySize = 1 << 16;
+	static const unsigned HaltVector = 0x25;
+
+	explicit LC3bSimulator(const LC3bCycleModel &CM);
+
+	/// loadObject - Load a program in the textual object format of the LC-3b
+	/// course tools: one 16-bit hex word per line, the first line being the
+	/// byte address the remaining words are loaded at. The entry point is set
+	/// to that origin. Returns true and sets Err on malformed input. ELF
+	/// objects written by llc are linked and loaded by lc3b-sim instead.
+	bool loadObject(StringRef Buffer, std::string &Err);
+
+	/// run - Execute until the program stops or MaxSteps instructions have
+	/// been executed (0 means no limit).
+	StopReason run(uint64_t MaxSteps = 0);
+
+	/// step - Execute a single instruction.
+	StopReason step();
+
+	void reset();
+
+	uint16_t getPC() const { return PC; }
+	void setPC(uint16_t Addr) { PC = Addr; }
+	uint16_t getReg(unsigned R) const { return Regs[R & 7]; }
+	void setReg(unsigned R, uint16_t V) { Regs[R & 7] = V; }
+	uint8_t readByte(uint16_t Addr) const { return Memory[Addr]; }
+	void writeByte(uint16_t Addr, uint8_t V) { Memory[Addr] = V; }
+	uint16_t readWord(uint16_t Addr) const;
+	void writeWord(uint16_t Addr, uint16_t V);
+
+	/// getCC - Return the condition codes as the three-bit N/Z/P mask used by
+	/// the BR encoding.
+	unsigned getCC() const { return CC; }
+
+	const LC3bSimStats &getStats() const { return Stats; }
+	const LC3bCycleModel &getCycleModel() const { return CycleModel; }
+
+	void printRegisters(raw_ostream &OS) const;
+
+private:
+	LC3bCycleModel CycleModel;
+	LC3bSimStats Stats;
+	std::vector<uint8_t> Memory;
+	uint16_t Regs[8];
+	uint16_t PC;
+	unsigned CC;
+
+	void setCC(uint16_t Value);
+	uint16_t load(uint16_t Addr, bool Byte);
+	void store(uint16_t Addr, uint16_t Value, bool Byte);
+};
+
+} // end namespace llvm
+#endif
@@ -0,0 +1,22 @@
+//===-- LC3bTargetInfo.cpp - LC3b Target Implementation -------------------===//
+//
+// The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include "LC3b.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/TargetRegistry.h"
+using namespace llvm;
+
+Target llvm::TheLC3bTarget, llvm::TheLC3belTarget;
+
+extern "C" void LLVMInitializeLC3bTargetInfo() {
+	RegisterTarget<Triple::lc3b,
+	      /*HasJIT=*/false> X(TheLC3bTarget, "lc3b", "LC-3b (big endian)");
+
+	RegisterTarget<Triple::lc3bel,
+	      /*HasJIT=*/false> Y(TheLC3belTarget, "lc3bel", "LC-3b (little endian)");
+}
@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# Times this pass against -sccp, and its interprocedural mode against
+# -ipsccp (lib/Transforms/Scalar/SCCP.cpp), on one large module built from
+# llvm-stress functions, and checks that both leave the same number of
+# instructions behind.
+#
+#   bench.sh [functions] [instructions per function]
+
+functions=${1:-500}
+size=${2:-1000}
+bin=../../../Release+Asserts/bin
+lib=../../../Release+Asserts/lib
+tmp=${TMPDIR:-/tmp}/ccp-bench.$$
+mkdir -p $tmp
+trap "rm -rf $tmp" EXIT
+
+for i in $(seq 1 $functions); do
+  $bin/llvm-stress -seed=$i -size=$size -o $tmp/f$i.ll || exit 1
+  # Every function is called autogen_SD<seed>, give them distinct names.
+  sed -i "s/@autogen_SD[0-9]*/@f$i/" $tmp/f$i.ll
+done
+$bin/llvm-link $tmp/f*.ll -o $tmp/module.bc || exit 1
+echo "module: $functions functions, $($bin/llvm-dis < $tmp/module.bc | grep -c '^  ') instructions"
+
+run() {
+  local name=$1; shift
+  local start=$(date +%s.%N)
+  $bin/opt "$@" < $tmp/module.bc > $tmp/$name.bc || exit 1
+  local end=$(date +%s.%N)
+  printf "%-8s %6.3fs  %d instructions left\n" $name \
+    $(echo "$end - $start" | bc) \
+    $($bin/llvm-dis < $tmp/$name.bc | grep -c '^  ')
+}
+
+run none -verify
+run sccp -sccp
+run ccp -load $lib/ConditionalConstantPropagation.so \
+  -conditional-constant-propagation
+run ipsccp -ipsccp
+run ipccp -load $lib/ConditionalConstantPropagation.so \
+  -ip-conditional-constant-propagation
@@ -1,4 +1,4 @@
-//===- DFALiveness.cpp - Example code from "Writing an LLVM Pass" ---------------===//
+//===- DFALiveness.cpp - Live SSA values of every block -------------------===//
 //
 //                     The LLVM Compiler Infrastructure
 //
@@ -7,666 +7,150 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file implements two versions of the LLVM "DFALiveness World" pass described
-// in docs/WritingAnLLVMPass.html
+// This file implements the DFALiveness analysis: one Gen/Kill pass over the
+// instructions, then dataflow::GenKillSolver to the fixed point. The cost is
+// linear in the size of the function per iteration, and blocks are only
+// revisited when a successor's live-in set changed.
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "dfaliveness"
+#include "DFALiveness.h"
 #include "llvm/ADT/Statistic.h"
-#include "llvm/ADT/StringMap.h"
+#include "llvm/Assembly/Writer.h"
 #include "llvm/IR/Function.h"
-#include "llvm/Pass.h"
-#include "llvm/Support/raw_ostream.h"
-#include "llvm/Support/FormattedStream.h"
-#include "llvm/ADT/DepthFirstIterator.h"
-#include "llvm/ADT/GraphTraits.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/Support/CFG.h"
-#include <map>
-#include <set>
-#include <stdlib.h>
-#include <iostream>
-#include <fstream>
-#include <time.h>
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+STATISTIC(NumBlockVisits, "Number of block evaluations to reach liveness");
 
-namespace {
-class DFANode;
-class MKVector;
-
-
-  // DFALiveness - The first implementation, without getAnalysisUsage.
-  struct DFALiveness : public FunctionPass {
-    static char ID; // Pass identification, replacement for typeid
-
-
-    DFALiveness() : FunctionPass(ID) {}
-
-	void ExampleCode ( raw_ostream& O, Function & F);
-
-	void LivenessAnalysis(raw_ostream &O, Function & F);
-	void PrintLivenessInfoToDot( raw_ostream &O, Function & F);
-
-    virtual bool runOnFunction(Function &F) {
-      errs() << "DFALiveness: ";
-      errs().write_escaped(F.getName()) << '\n';
-	  //ExampleCode(errs(), F);
-	  LivenessAnalysis(errs(), F);
-	  PrintLivenessInfoToDot(errs(), F);
-      return false;
-    }
-  };
-
-  class MKVector
-  	{
-  	public:
-  		std::vector<int> bitVector;
-
-  	MKVector()
-  		{
-  		bitVector.push_back(0);
-  		}
-
-  	MKVector(int size)
-  		{
-  		for(int i = 0; i < (size/32)+1; i++)
-  			{
-  			bitVector.push_back(0);
-  			}
-  		}
-
-  	void set(int x)
-  		{
-  		//llvm::errs()<<"Sett*ot)ing var bit "<<x<<"\n";
-  		while(bitVector.size() < (x/32)+1)
-  			{
-  			bitVector.push_back(0);
-  			}
-  		//llvm::errs()<<"Setting var bit "<<x<<"\n";
-  		bitVector.at(x/32) = bitVector.at(x/32) | (1<<((x)%32));
-  		}
-
-  	bool bitUnion(MKVector *op)
-  		{
-  		bool ret = false;
-
-  		while(op->bitVector.size() < bitVector.size())
-  			{
-  			op->bitVector.push_back(0);
-  			}
-
-  		while(op->bitVector.size() > bitVector.size())
-  			{
-  			bitVector.push_back(0);
-  			}
-
-  		int temp;
-  		std::vector<int>::iterator it = bitVector.begin();
-  		std::vector<int>::iterator et = bitVector.end();
-  		std::vector<int>::iterator ot = op->bitVector.begin();
-
-
-  		while(it != et)
-  			{
-  			temp = *it | *ot;
-  			ret = (temp != *it) | ret;
-  			*it = temp;
-  			it++;
-  			ot++;
-  			}
-
-  		return ret;
-  		}
-
-  	bool bitIntersect(MKVector *op)
-  		{
-  		bool ret = false;
-
-  		while(op->bitVector.size() < bitVector.size())
-  			{
-  			op->bitVector.push_back(0);
-  			}
-
-  		while(op->bitVector.size() > bitVector.size())
-  			{
-  			bitVector.push_back(0);
-  			}
-
-  		int temp;
-  		std::vector<int>::iterator it = bitVector.begin();
-  		std::vector<int>::iterator et = bitVector.end();
-  		std::vector<int>::iterator ot = op->bitVector.begin();
-
-
-  		while(it != et)
-  			{
-  			temp = *it & *ot;
-  			ret = (temp != *it) | ret;
-  			*it = temp;
-  			it++;
-  			ot++;
-  			}
-  		return ret;
-  		}
-
-  	bool bitExclude(MKVector *op)
-  		{
-  		bool ret = false;
-
-  		while(op->bitVector.size() < bitVector.size())
-  			{
-  			op->bitVector.push_back(0);
-  			}
-
-  		while(op->bitVector.size() > bitVector.size())
-  			{
-  			bitVector.push_back(0);
-  			}
-
-  		int temp;
-  		std::vector<int>::iterator it = bitVector.begin();
-  		std::vector<int>::iterator et = bitVector.end();
-  		std::vector<int>::iterator ot = op->bitVector.begin();
-
-
-  		while(it != et)
-  			{
-  			temp =*ot;
-  			temp = *it & ~temp;
-  			ret = (temp != *it) | ret;
-  			*it = temp;
-  			it++;
-  			ot++;
-  			}
-  		return ret;
-  		}
-
-  	bool vectorCompareAndSet(MKVector *op)
-  		{
-  		bool ret = false;
-
-  		while(op->bitVector.size() > bitVector.size())
-  			{
-  		  	bitVector.push_back(0);
-  		  	}
-
-  		while(op->bitVector.size() < bitVector.size())
-  		  	{
-  		  	op->bitVector.push_back(0);
-  		  	}
-
-  		std::vector<int>::iterator it = bitVector.begin();
-  		std::vector<int>::iterator et = bitVector.end();
-  		std::vector<int>::iterator ot = op->bitVector.begin();
-  		int index = 1;
-
-  		while(it != et)
-  			{
-  			//if(!ret && (*ot != *it))
-  				//{
-  			  	//llvm::errs()<<"Compare and Set: Size of bitvector: "<<bitVector.size();
-  			  	//llvm::errs()<<" Index:"<<index<<" "<<*ot<<" "<<*it<<"\n";
-  			  	//}
-  		  	ret = (*ot != *it) | ret;
-  		  	*it = *ot;
-  		  	it++;
-  		  	ot++;
-  		  	index++;
-  			}
-
-  		return ret;
-  		}
-
-  	bool vectorCompare(MKVector *op)
-  		{
-  	  	bool ret = false;
-
-  	  	while(op->bitVector.size() > bitVector.size())
-  	  		{
-  	  	  	bitVector.push_back(0);
-  	  	  	}
-
-  	  while(op->bitVector.size() < bitVector.size())
-  	    	{
-  		    op->bitVector.push_back(0);
-  	    	}
-
-  	  	std::vector<int>::iterator it = bitVector.begin();
-  	  	std::vector<int>::iterator et = bitVector.end();
-  	  	std::vector<int>::iterator ot = op->bitVector.begin();
-  	  	int index = 1;
-
-  	  	while(it != et)
-  	  		{
-  	  		//if(!ret && (*ot != *it))
-  	  	  		//{
-  	  	  		//llvm::errs()<<"Compare        : Size of bitvector: "<<bitVector.size();
-  	  	  		//llvm::errs()<<" Index:"<<index<<" "<<*ot<<" "<<*it<<"\n";
-  	  	  		//}
-  	  		ret = (*ot != *it) | ret;
-  	  		it++;
-  	  		ot++;
-  	  		index++;
-  	  		}
-  	  	return ret;
-  	  	}
-
-  	std::vector<int> getVectorRepresentation()
-  		{
-  		std::vector<int> *ret = new std::vector<int>();
-  		int temp;
-  		for(int i = 0; i < bitVector.size(); i++)
-  			{
-  			temp = bitVector.at(i);
-  			for(int j = 0; j < 32; j++)
-  				{
-  				if(temp & 1<<j)
-  					{
-  					ret->push_back(i*32+j);
-  					}
-  				}
-  			}
-
-  		return *ret;
-  		}
-
-  	void printMKVectorVars(raw_ostream& O, std::map<int, StringRef> varMap)
-  		{
-  		int temp;
-  		for(int i = 0; i < bitVector.size(); i++)
-  			{
-  			temp = bitVector.at(i);
-  			for(int j = 0; j < 32; j++)
-  				{
-  		  		if(temp & 1<<j)
-  		  			{
-  		  			O<<" "<<varMap[i*32+j];
-  		  			}
-  		  		}
-  		  	}
-  		}
-
-  	};
-
-class DFANode{
-public:
-	  BasicBlock *block;
-	  MKVector inVars;
-	  MKVector outVars;
-	  MKVector defVars;
-	  MKVector useVars;
-	  int nodeID;
-
-	  DFANode(BasicBlock *BB)
-	  	  {
-		  block = BB;
-	  	  }
-
-  void addVarToUse(int x)
-  	  {
-	  useVars.set(x);
-  	  }
-
-  void addVarToDef(int x)
-  	  {
-	  defVars.set(x);
-  	  }
-
-  void unionInAndUse()
-  	  {
-	  inVars.bitUnion(&useVars);
-  	  }
-
-  void excludeInAndDef()
-  	  {
-	  inVars.bitExclude(&defVars);
-  	  }
-
-  bool getInVars(std::map<StringRef, DFANode*> node_map, int visited[])
-  	  {
-	  bool ret = false;
-
-	  //llvm::errs()<<"Node: "<<block->getName()<<" with id "<<nodeID<<" visited "<<visited[nodeID]<<"\n";
-
-	  if(!visited[nodeID])
-	  	  {
-		  MKVector *tempV = new MKVector();
-		  visited[nodeID] = 1;
-
-		  //llvm::errs()<<"Checking in for "<<block->getName()<<"\n";
-
-		  ret = ret | calcOutVars(node_map, visited);
-		  tempV->bitUnion(&outVars);
-		  tempV->bitUnion(&useVars);
-		  tempV->bitExclude(&defVars);
-
-		  //if(inVars.vectorCompare(tempV))
-		  	  //{
-			  //llvm::errs()<<"Block: "<<block->getName()<<" In vector changed\n";
-			  //MKVector *tempex = new MKVector();
-			  //MKVector *tempVP = new MKVector();
-			  //tempex->vectorCompareAndSet(&inVars);
-			  //tempVP->vectorCompareAndSet(tempV);
-			  //tempex->bitExclude(tempV);
-			  //llvm::errs()<<"Pre exclude compare\n";
-			  //tempVP->vectorCompare(tempV);
-			  //llvm::errs()<<"Post exclude compare "<<inVars.vectorCompare(tempV)<<"\n";
-			  //std::vector<int> tempx = tempV->getVectorRepresentation();
-			  // for(std::vector<int>::iterator it = tempx.begin(); it != tempx.end(); ++it)
-			  // 	  {
-			  //llvm::errs()<<tempx.size()<<"\n";
-			  // 	  }
-			  //llvm::errs()<<"\n";
-			  //delete tempex;
-			  //delete tempVP;
-		  	  //}
-
-		  ret = ret | inVars.vectorCompareAndSet(tempV);
-
-		  delete tempV;
-	  	  }
-	  return ret;
-  	  }
-
-  bool calcOutVars(std::map<StringRef, DFANode*> node_map, int visited[])
-  	  {
-	  bool ret = false;
-
-	  //llvm::errs()<<"Checking out for "<<block->getName()<<"\n";
-
-	  succ_iterator SI = succ_begin(block), E = succ_end(block);
-	  MKVector *tempV = new MKVector();
-	  DFANode *succ_node;
-	  for ( ; SI != E; SI ++)
-	  	  {
-	  	  BasicBlock * succ_bb = *SI;
-	  	  succ_node = node_map[succ_bb->getName()];
-	  	  ret = ret | succ_node->getInVars(node_map, visited);
-	  	  tempV->bitUnion(&(succ_node->inVars));
-	  	  }
-
-	  //if(outVars.vectorCompare(tempV))
-	  	  //{
-		  //llvm::errs()<<"Block: "<<block->getName()<<" Out vector changed\n";
-		  //MKVector *tempex = new MKVector();
-		  //tempex->vectorCompareAndSet(&outVars);
-		  //tempex->bitExclude(tempV);
-		  //std::vector<int> tempx = tempex->getVectorRepresentation();
-		  //for(std::vector<int>::iterator it = tempx.begin(); it != tempx.end(); ++it)
-		  //	  {
-			  //llvm::errs()<<tempx.size()<<"\n";
-		  //	  }
-		 // llvm::errs()<<"\n";
-
-	  	  //}
-
-	  ret = ret | outVars.vectorCompareAndSet(tempV);
-	  delete tempV;
-	  return ret;
-  	  }
-
-  };
+static cl::opt<std::string>
+DotFile("dfaliveness-dot", cl::value_desc("filename"),
+        cl::desc("Write the CFG annotated with live sets to a dot file"));
 
 char DFALiveness::ID = 0;
-static RegisterPass<DFALiveness> X("dfaliveness", "Data-flow analysis: liveness analysis pass");
-static std::map<StringRef,int> var_id_map;
-static std::map<int, StringRef> var_name_map;
-static std::map<StringRef, DFANode*> node_map;
-
-void DFALiveness::ExampleCode(raw_ostream& O, Function& F)
-	{
-	time_t begin;
-	time_t end;
-
-	time(&begin);
-
-	int currentID = 0;
-	int currentNodeID = 0;
-
-	//O << "All Variables Defined in Function " << F.getName() <<   "\n";
-	for (Function::iterator FI = F.begin(), FE = F.end(); FI != FE; ++FI)
-		{
-		BasicBlock* BB = dyn_cast<BasicBlock>(&*FI);
-		DFANode *tempN = new DFANode(BB);
-		tempN->nodeID = currentNodeID;
-		currentNodeID++;
-		node_map[BB->getName()] = tempN;
-		//O<<"Block "<<BB->getName()<<"\n";
-		for (BasicBlock::iterator BI = BB->begin(), BE = BB->end(); BI != BE; ++BI)
-			{
-			if ( BI->hasName() )
-				{
-				StringRef var_name = BI->getValueName()->first();
-				//O << "VARIABLE:\t" << var_name; //<< "\tdefined in ";
-				//BI->print(O);
-				//O << "\n";
-				var_id_map[var_name] = currentID;
-				var_name_map[currentID] = var_name;
-				tempN->addVarToDef(currentID);
-				currentID++;
-				}
-			}
-
-		}
-
-	for (Function::iterator FI = F.begin(), FE = F.end(); FI != FE; ++FI)
-		{
-		BasicBlock* BB = dyn_cast<BasicBlock>(&*FI);
-		DFANode *tempN = node_map[BB->getName()];
-		//O << "----------------------------------------------------\n";
-		//O << "BB: " << BB ->getName() << '\n';
-		//O << "\t All instructions in this bb:\n";
-		for (BasicBlock::iterator BI = BB->begin(), BE = BB->end(); BI != BE; ++BI)
-			{
-			//O << "\t";
-			//BI->print(O);
-			//O << "\n";
-			//O << "\t\tAll operands in this instruction: \n";
-			int operand_size = BI->getNumOperands();
-			for ( int i = 0; i < operand_size; i ++ )
-				{
-				//O << "\t\t\t" << i << ": ";
-				Value * operand = BI->getOperand(i);
-				if ( operand->hasName() )
-					{
-					StringRef op_name = operand->getValueName()->first();
-					if ( var_id_map.find(op_name) != var_id_map.end() )
-						{
-						//O << "\tVar: " << op_name<< " with id: "<<var_id_map[op_name];
-						tempN->addVarToUse(var_id_map[op_name]);
-						}
-					else
-						{
-						//O << "\tNot a Var: " << op_name;
-						}
-					}
-				else
-					{
-					//O << "\tNot a Var: no name";
-					}
-				//O << "\n";
-				}
+static RegisterPass<DFALiveness>
+X("dfaliveness", "Data-flow analysis: liveness analysis pass", false, true);
 
-			}
-		tempN->unionInAndUse();
-		tempN->excludeInAndDef();
-		}
-
-
-
-	int* visited = new int[currentNodeID];
-	for(int i = 0; i < currentNodeID; i++)
-		{
-		visited[i] = 0;
-		}
-	int x = 0;
-	while(node_map["entry"]->getInVars(node_map, visited))
-		{
-		for(int i = 0; i < currentNodeID; i++)
-			{
-			visited[i] = 0;
-			}
-		x++;
-		//if(x%100 == 0)
-			//{
-			O<<"Loop iteration "<<x<<"\n";
-			//}
-		}
-
-	time(&end);
-
-	O<<"nodes: "<<currentNodeID<<" vars: "<<currentID<<" compeleted in "<<difftime(end, begin)<<"\n";
+DFALiveness::DFALiveness() : FunctionPass(ID) {}
 
+void DFALiveness::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesAll();
 }
 
-
-void DFALiveness::LivenessAnalysis(raw_ostream& O, Function& F) {
-	time_t begin;
-	time_t end;
-
-	time(&begin);
-
-	//std::map<StringRef,int> var_id_map;
-	//std::map<int, StringRef> var_name_map;
-	//std::map<StringRef, DFANode*> node_map;
-	int currentID = 0;
-	int currentNodeID = 0;
-
-	//O << "All Variables Defined in Function " << F.getName() <<   "\n";
-	for (Function::iterator FI = F.begin(), FE = F.end(); FI != FE; ++FI)
-		{
-		BasicBlock* BB = dyn_cast<BasicBlock>(&*FI);
-		DFANode *tempN = new DFANode(BB);
-		tempN->nodeID = currentNodeID;
-		currentNodeID++;
-		node_map[BB->getName()] = tempN;
-		//O<<"Block "<<BB->getName()<<"\n";
-		for (BasicBlock::iterator BI = BB->begin(), BE = BB->end(); BI != BE; ++BI)
-			{
-			if ( BI->hasName() )
-				{
-				StringRef var_name = BI->getValueName()->first();
-				//O << "VARIABLE:\t" << var_name; //<< "\tdefined in ";
-				//BI->print(O);
-				//O << "\n";
-				var_id_map[var_name] = currentID;
-				var_name_map[currentID] = var_name;
-				tempN->addVarToDef(currentID);
-				currentID++;
-				}
-			}
-
-		}
-
-	for (Function::iterator FI = F.begin(), FE = F.end(); FI != FE; ++FI)
-		{
-		BasicBlock* BB = dyn_cast<BasicBlock>(&*FI);
-		DFANode *tempN = node_map[BB->getName()];
-		O << "----------------------------------------------------\n";
-		O << "BB: " << BB ->getName() << '\n';
-		O << "\t All instructions in this bb:\n";
-		for (BasicBlock::iterator BI = BB->begin(), BE = BB->end(); BI != BE; ++BI)
-			{
-			O << "\t";
-			BI->print(O);
-			O << "\n";
-			O << "\t\tAll operands in this instruction: \n";
-			int operand_size = BI->getNumOperands();
-			for ( int i = 0; i < operand_size; i ++ )
-				{
-				O << "\t\t\t" << i << ": ";
-				Value * operand = BI->getOperand(i);
-				if ( operand->hasName() )
-					{
-					StringRef op_name = operand->getValueName()->first();
-					if ( var_id_map.find(op_name) != var_id_map.end() )
-						{
-						O << "\tVar: " << op_name<< " with id: "<<var_id_map[op_name];
-						tempN->addVarToUse(var_id_map[op_name]);
-						}
-					else
-						{
-						O << "\tNot a Var: " << op_name;
-						}
-					}
-				else
-					{
-					O << "\tNot a Var: no name";
-					}
-				O << "\n";
-				}
-
-			}
-		tempN->unionInAndUse();
-		tempN->excludeInAndDef();
-		}
-
-
-
-	int* visited = new int[currentNodeID];
-	for(int i = 0; i < currentNodeID; i++)
-		{
-		visited[i] = 0;
-		}
-	int x = 0;
-	while(node_map["entry"]->getInVars(node_map, visited))
-		{
-		for(int i = 0; i < currentNodeID; i++)
-			{
-			visited[i] = 0;
-			}
-		x++;
-		//if(x%100 == 0)
-			//{
-			O<<"Loop iteration "<<x<<"\n";
-			//}
-		}
-
-	time(&end);
-
-	//O<<"nodes: "<<currentNodeID<<" vars: "<<currentID<<" compeleted in "<<difftime(end, begin)<<"\n";
+void DFALiveness::releaseMemory() {
+  releaseState();
+  Vars.clear();
+  VarIDs.clear();
 }
 
-void DFALiveness::PrintLivenessInfoToDot(raw_ostream &O, Function & F)
-{
-	std::string error_info;
-	llvm::raw_fd_ostream myfile("liveness.dot", error_info);
-	//llvm::errs()<<"Printing dot file\n";
-	myfile<<"digraph \"liveness info for 'main' function\" {\n";
-	myfile<<"label=\"liveness info for 'main' function\";\n";
-	for (Function::iterator FI = F.begin(), FE = F.end(); FI != FE; ++FI)
-			{
-			BasicBlock* BB = dyn_cast<BasicBlock>(&*FI);
-			myfile<<"\t\"Node"<<BB->getName()<<"\" [shape=record, label=\"{" << "Node " << BB->getName();
-			myfile<<"\\n\tIn Vars: ";
-			node_map[BB->getName()]->inVars.printMKVectorVars(myfile, var_name_map);
-			myfile<<"\\n\tOut Vars: ";
-			node_map[BB->getName()]->outVars.printMKVectorVars(myfile, var_name_map);
-			myfile<<"}\"];\n";
-			//myfile<<BB->getName()<<" with children: ";
-			succ_iterator SI = succ_begin(BB), E = succ_end(BB);
-			for ( ; SI != E; SI ++)
-				{
-				BasicBlock * succ_bb = *SI;
-				myfile<<"\t\"Node"<<BB->getName()<<"\" -> "<<"\"Node"<<succ_bb->getName()<<"\";\n";
-				}
+bool DFALiveness::runOnFunction(Function &F) {
+  releaseMemory();
+
+  for (Function::arg_iterator AI = F.arg_begin(), AE = F.arg_end();
+       AI != AE; ++AI) {
+    VarIDs[AI] = Vars.size();
+    Vars.push_back(AI);
+  }
+  for (Function::iterator BB = F.begin(), BE = F.end(); BB != BE; ++BB)
+    for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I)
+      if (!I->getType()->isVoidTy()) {
+        VarIDs[I] = Vars.size();
+        Vars.push_back(I);
+      }
+
+  initialize(F, Vars.size());
+
+  // Kill is what the block defines, Gen what it reads before (or without)
+  // defining it. In SSA form a use in the defining block always follows the
+  // definition, except for PHIs, whose operands belong to the incoming
+  // edges and are added by transferEdge.
+  for (Function::iterator BB = F.begin(), BE = F.end(); BB != BE; ++BB) {
+    unsigned ID = getBlockID(BB);
+    BitVector &Gen = getGen(ID), &Kill = getKill(ID);
+    for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I) {
+      int Def = getVarIndex(I);
+      if (Def >= 0)
+        Kill.set(Def);
+      if (isa<PHINode>(I))
+        continue;
+      for (User::op_iterator OI = I->op_begin(), OE = I->op_end();
+           OI != OE; ++OI) {
+        int Use = getVarIndex(*OI);
+        if (Use < 0)
+          continue;
+        if (Instruction *OpI = dyn_cast<Instruction>(*OI))
+          if (OpI->getParent() == BB)
+            continue;
+        Gen.set(Use);
+      }
+    }
+  }
 
-			//myfile<<"\nIn Vars: ";
-			//myfile<<"\nDef Vars: ";
-			//node_map[BB->getName()]->defVars.printMKVectorVars(myfile, var_name_map);
-			//myfile<<"\nUse Vars: ";
-			//node_map[BB->getName()]->useVars.printMKVectorVars(myfile, var_name_map);
-			//myfile<<"\n\n";
+  solve();
+  NumBlockVisits += getNumIterations();
 
-			}
-	myfile<<"\n}";
+  if (!DotFile.empty())
+    writeDot(F, DotFile);
+  return false;
 }
 
+bool DFALiveness::transferEdge(const BasicBlock *Pred, const BasicBlock *Succ,
+                               BitVector &Val) const {
+  for (BasicBlock::const_iterator I = Succ->begin(); isa<PHINode>(I); ++I) {
+    int Use = getVarIndex(cast<PHINode>(I)->getIncomingValueForBlock(Pred));
+    if (Use >= 0)
+      Val.set(Use);
+  }
+  return true;
+}
 
-
-
-
+void DFALiveness::printVars(raw_ostream &O, const BitVector &Set) const {
+  for (int Idx = Set.find_first(); Idx >= 0; Idx = Set.find_next(Idx)) {
+    O << ' ';
+    WriteAsOperand(O, Vars[Idx], false);
+  }
 }
 
+void DFALiveness::print(raw_ostream &O, const Module *M) const {
+  for (unsigned i = 0, e = getNumBlocks(); i != e; ++i) {
+    const BasicBlock *BB = getBlock(i);
+    O << "Block ";
+    WriteAsOperand(O, BB, false);
+    O << ":\n  In:";
+    printVars(O, getLiveIn(BB));
+    O << "\n  Out:";
+    printVars(O, getLiveOut(BB));
+    O << '\n';
+  }
+}
 
+void DFALiveness::writeDot(const Function &F, StringRef Filename) const {
+  std::string ErrorInfo;
+  raw_fd_ostream File(Filename.str().c_str(), ErrorInfo);
+  if (!ErrorInfo.empty()) {
+    errs() << "Error opening '" << Filename << "': " << ErrorInfo << '\n';
+    return;
+  }
+
+  File << "digraph \"liveness info for '" << F.getName() << "' function\" {\n";
+  File << "label=\"liveness info for '" << F.getName() << "' function\";\n";
+  for (unsigned i = 0, e = getNumBlocks(); i != e; ++i) {
+    const BasicBlock *BB = getBlock(i);
+    File << "\tNode" << i << " [shape=record, label=\"{Node ";
+    WriteAsOperand(File, BB, false);
+    File << "\\n\tIn Vars:";
+    printVars(File, getLiveIn(BB));
+    File << "\\n\tOut Vars:";
+    printVars(File, getLiveOut(BB));
+    File << "}\"];\n";
+    for (succ_const_iterator SI = succ_begin(BB), SE = succ_end(BB);
+         SI != SE; ++SI)
+      File << "\tNode" << i << " -> Node" << getBlockID(*SI) << ";\n";
+  }
+  File << "}\n";
+}
@@ -0,0 +1,91 @@
+//===- DFALiveness.h - Live SSA values of every block -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// DFALiveness computes which arguments and instruction results are live on
+// entry to and exit from every basic block, as a backward union problem on
+// dataflow::GenKillSolver. PHI operands are live out of the predecessor they
+// come from, not into the PHI's block.
+//
+// Other passes use it through getAnalysis<DFALiveness>() and the queries
+// below; `opt -analyze -dfaliveness` prints the sets.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_DFALIVENESS_DFALIVENESS_H
+#define LLVM_TRANSFORMS_DFALIVENESS_DFALIVENESS_H
+
+#include "llvm/Analysis/DataflowFramework.h"
+#include "llvm/Pass.h"
+
+namespace llvm {
+
+class Value;
+
+class DFALiveness
+  : public FunctionPass,
+    private dataflow::GenKillSolver<DFALiveness, dataflow::Backward,
+                                    dataflow::Union> {
+  friend class dataflow::BlockSolver<DFALiveness, BitVector,
+                                     dataflow::Backward>;
+
+public:
+  static char ID; // Pass identification, replacement for typeid
+
+  DFALiveness();
+
+  virtual bool runOnFunction(Function &F);
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const;
+  virtual void releaseMemory();
+  virtual void print(raw_ostream &O, const Module *M) const;
+
+  /// getNumVars - Number of values tracked: the arguments, then every
+  /// instruction with a result.
+  unsigned getNumVars() const { return Vars.size(); }
+  const Value *getVar(unsigned Idx) const { return Vars[Idx]; }
+
+  /// getVarIndex - The bit of V in the live sets, or -1 if V is not
+  /// tracked (constants, globals, void instructions).
+  int getVarIndex(const Value *V) const {
+    DenseMap<const Value*, unsigned>::const_iterator I = VarIDs.find(V);
+    return I == VarIDs.end() ? -1 : int(I->second);
+  }
+
+  /// getLiveIn/getLiveOut - The live sets of BB, indexed by getVarIndex.
+  const BitVector &getLiveIn(const BasicBlock *BB) const { return getIn(BB); }
+  const BitVector &getLiveOut(const BasicBlock *BB) const {
+    return getOut(BB);
+  }
+
+  bool isLiveIn(const Value *V, const BasicBlock *BB) const {
+    int Idx = getVarIndex(V);
+    return Idx >= 0 && getLiveIn(BB).test(Idx);
+  }
+  bool isLiveOut(const Value *V, const BasicBlock *BB) const {
+    int Idx = getVarIndex(V);
+    return Idx >= 0 && getLiveOut(BB).test(Idx);
+  }
+
+private:
+  /// transferEdge - Add the PHI operands of Succ coming from Pred.
+  bool transferEdge(const BasicBlock *Pred, const BasicBlock *Succ,
+                    BitVector &Val) const;
+
+  /// printVars - The names of the values in Set.
+  void printVars(raw_ostream &O, const BitVector &Set) const;
+
+  /// writeDot - The CFG of F annotated with the live sets, to Filename.
+  void writeDot(const Function &F, StringRef Filename) const;
+
+  std::vector<const Value*> Vars;
+  DenseMap<const Value*, unsigned> VarIDs;
+};
+
+} // end namespace llvm
+
+#endif
@@ -1 +1 @@
-../../../Release+Asserts/bin/opt -load ../../../Release+Asserts/lib/DFALiveness.so -dfaliveness < $1
+../../../Release+Asserts/bin/opt -load ../../../Release+Asserts/lib/DFALiveness.so -analyze -dfaliveness -dfaliveness-dot=liveness.dot < $1
@@ -0,0 +1,70 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; The ADD already set the flags from the sum, no ADD Rx, Rx, #0 before BR.
+define i16 @sum_sign(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: sum_sign:
+; CHECK: add [[S:R[0-7]]], R0, R1
+; CHECK-NOT: #0
+; CHECK-NEXT: br{{n|zp}}
+  %s = add i16 %a, %b
+  %c = icmp slt i16 %s, 0
+  br i1 %c, label %neg, label %pos
+
+neg:
+  ret i16 -1
+
+pos:
+  ret i16 %s
+}
+
+; Same for a load.
+define i16 @load_zero(i16* %p) nounwind {
+entry:
+; CHECK: load_zero:
+; CHECK: ldw [[V:R[0-7]]], R0, #0
+; CHECK-NEXT: br{{z|np}}
+  %v = load i16* %p
+  %c = icmp eq i16 %v, 0
+  br i1 %c, label %zero, label %nonzero
+
+zero:
+  ret i16 1
+
+nonzero:
+  ret i16 %v
+}
+
+; An argument has no flags yet, it is tested first.
+define i16 @arg_pos(i16 %a) nounwind {
+entry:
+; CHECK: arg_pos:
+; CHECK: add R0, R0, #0
+; CHECK-NEXT: br{{p|nz}}
+  %c = icmp sgt i16 %a, 0
+  br i1 %c, label %yes, label %no
+
+yes:
+  ret i16 1
+
+no:
+  ret i16 0
+}
+
+; Equality against a register is tested on the difference.
+define i16 @eq(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: eq:
+; CHECK: xor [[N:R[0-7]]], R1, #-1
+; CHECK: add [[N]], [[N]], #1
+; CHECK: add [[D:R[0-7]]], R0, [[N]]
+; CHECK-NEXT: br{{z|np}}
+  %c = icmp eq i16 %a, %b
+  br i1 %c, label %yes, label %no
+
+yes:
+  ret i16 1
+
+no:
+  ret i16 0
+}
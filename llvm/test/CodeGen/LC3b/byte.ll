@@ -0,0 +1,112 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; i8 loads are LDB, which sign extends, and truncating stores are STB.
+
+define i16 @load_sext(i8* %p) nounwind {
+entry:
+; CHECK: load_sext:
+; CHECK: ldb R0, R0, #3
+; CHECK-NEXT: ret
+  %a = getelementptr i8* %p, i16 3
+  %v = load i8* %a
+  %r = sext i8 %v to i16
+  ret i16 %r
+}
+
+; Zero extension masks the high byte off with two shifts.
+define i16 @load_zext(i8* %p) nounwind {
+entry:
+; CHECK: load_zext:
+; CHECK: ldb [[V:R[0-7]]], R0, #0
+; CHECK-NEXT: lshf [[S:R[0-7]]], [[V]], #8
+; CHECK-NEXT: rshfl R0, [[S]], #8
+  %v = load i8* %p
+  %r = zext i8 %v to i16
+  ret i16 %r
+}
+
+define void @store(i8* %p, i16 %v) nounwind {
+entry:
+; CHECK: store:
+; CHECK: stb R1, R0, #-1
+  %a = getelementptr i8* %p, i16 -1
+  %t = trunc i16 %v to i8
+  store i8 %t, i8* %a
+  ret void
+}
+
+; Copying a byte needs no extension at all.
+define void @copy(i8* %d, i8* %s) nounwind {
+entry:
+; CHECK: copy:
+; CHECK: ldb [[V:R[0-7]]], R1, #0
+; CHECK-NEXT: stb [[V]], R0, #0
+; CHECK-NOT: shf
+  %v = load i8* %s
+  store i8 %v, i8* %d
+  ret void
+}
+
+; Replacing one byte of a word of packed characters is a single STB. lc3b
+; is big endian, the low byte is at the odd address.
+define void @packed_lo(i16* %p, i8 %c) nounwind {
+entry:
+; CHECK: packed_lo:
+; CHECK-NOT: ldw
+; CHECK: stb R1, R0, #1
+  %w = load i16* %p
+  %m = and i16 %w, -256
+  %z = zext i8 %c to i16
+  %o = or i16 %m, %z
+  store i16 %o, i16* %p
+  ret void
+}
+
+define void @packed_hi(i16* %p, i8 %c) nounwind {
+entry:
+; CHECK: packed_hi:
+; CHECK-NOT: ldw
+; CHECK: stb R1, R0, #0
+  %w = load i16* %p
+  %m = and i16 %w, 255
+  %z = zext i8 %c to i16
+  %s = shl i16 %z, 8
+  %o = or i16 %m, %s
+  store i16 %o, i16* %p
+  ret void
+}
+
+; A byte or bit already in a register is sign extended by shifting it up
+; and back down.
+define i16 @sext_inreg8(i16 %a) nounwind {
+entry:
+; CHECK: sext_inreg8:
+; CHECK: lshf R0, R0, #8
+; CHECK-NEXT: rshfa R0, R0, #8
+  %t = trunc i16 %a to i8
+  %r = sext i8 %t to i16
+  ret i16 %r
+}
+
+define i16 @sext_inreg1(i16 %a) nounwind {
+entry:
+; CHECK: sext_inreg1:
+; CHECK: lshf R0, R0, #15
+; CHECK-NEXT: rshfa R0, R0, #15
+  %t = trunc i16 %a to i1
+  %r = sext i1 %t to i16
+  ret i16 %r
+}
+
+; There is no rotate, the halves are shifted and added.
+define i16 @rotl(i16 %a) nounwind {
+entry:
+; CHECK: rotl:
+; CHECK-DAG: lshf {{R[0-7]}}, R0, #3
+; CHECK-DAG: rshfl {{R[0-7]}}, R0, #13
+; CHECK: add
+  %h = shl i16 %a, 3
+  %l = lshr i16 %a, 13
+  %r = or i16 %h, %l
+  ret i16 %r
+}
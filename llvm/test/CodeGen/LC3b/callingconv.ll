@@ -0,0 +1,51 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; The first four arguments are passed in R0-R3 and the result in R0, so a
+; call between register-only functions touches no memory.
+
+define i16 @add4(i16 %a, i16 %b, i16 %c, i16 %d) nounwind {
+entry:
+; CHECK: add4:
+; CHECK-NOT: ldw
+; CHECK: add
+; CHECK: ret
+  %ab = add i16 %a, %b
+  %cd = add i16 %c, %d
+  %r = add i16 %ab, %cd
+  ret i16 %r
+}
+
+; The fifth argument is read from the caller's outgoing area off R6.
+define i16 @fifth(i16 %a, i16 %b, i16 %c, i16 %d, i16 %e) nounwind {
+entry:
+; CHECK: fifth:
+; CHECK: ldw R0, R6
+; CHECK: ret
+  ret i16 %e
+}
+
+define i16 @caller(i16 %x) nounwind {
+entry:
+; CHECK: caller:
+; CHECK: stw {{R[0-7]}}, R6, #0
+; CHECK: jsr fifth
+  %r = call i16 @fifth(i16 %x, i16 %x, i16 %x, i16 %x, i16 %x)
+  ret i16 %r
+}
+
+; i8 arguments are promoted and still travel in registers.
+define i8 @narrow(i8 %a) nounwind {
+entry:
+; CHECK: narrow:
+; CHECK-NOT: stw
+; CHECK: ret
+  ret i8 %a
+}
+
+define i16 @indirect(i16 (i16)* %fp, i16 %v) nounwind {
+entry:
+; CHECK: indirect:
+; CHECK: jsrr
+  %r = call i16 %fp(i16 %v)
+  ret i16 %r
+}
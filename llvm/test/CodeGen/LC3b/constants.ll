@@ -0,0 +1,356 @@
+; RUN: llc < %s -march=lc3b -o %t
+; RUN: FileCheck %s < %t
+; RUN: FileCheck -check-prefix=SEQ %s < %t
+
+; simm5 constants are a cleared register plus an ADD.
+define i16 @small() nounwind {
+entry:
+; CHECK: small:
+; CHECK: and [[R:R[0-7]]], {{R[0-7]}}, #0
+; CHECK-NEXT: add [[R]], [[R]], #-7
+; CHECK: ret
+  ret i16 -7
+}
+
+; 1000 takes four ALU instructions, 36 cycles. LEA+LDW of a constant pool
+; in reach takes 24. Both uses share one constant pool entry.
+define i16 @pool(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: pool:
+; CHECK: lea [[A:R[0-7]]], {{\$CPI[0-9_]+}}
+; CHECK-NEXT: ldw [[A]], [[A]], #0
+; CHECK-NOT: lea
+; CHECK: ret
+  %x = add i16 %a, 1000
+  %y = xor i16 %b, 1000
+  %r = and i16 %x, %y
+  ret i16 %r
+}
+
+; CHECK: .2byte 1000
+
+; Out of LEA range of the pool, LONG_LEA+LDW takes 49 cycles: 1000 is built
+; in four ALU instructions. 12345 takes six and is loaded through a literal
+; address inline in the code.
+define void @far(i16* %p) nounwind {
+entry:
+; SEQ: far:
+; SEQ: and [[S:R[0-7]]], {{R[0-7]}}, #0
+; SEQ-NEXT: add [[S]], [[S]], #-12
+; SEQ-NEXT: lshf [[S]], [[S]], #7
+; SEQ: rshfl [[S]], [[S]], #6
+; SEQ: stw [[S]], R0, #0
+; CHECK: far:
+; CHECK: lea [[F:R[0-7]]], #1
+; CHECK-NEXT: brnzp #1
+; CHECK-NEXT: .2byte ([[CPI:\$CPI[0-9_]+]])
+; CHECK-NEXT: ldw [[F]], [[F]], #0
+; CHECK: ldw {{R[0-7]}}, [[F]], #0
+; CHECK: ret
+; CHECK: [[CPI]]:
+; CHECK-NEXT: .2byte 12345
+; CHECK-NOT: .2byte 1000
+  store volatile i16 1000, i16* %p
+  store volatile i16 12345, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  store volatile i16 0, i16* %p
+  ret void
+}
@@ -0,0 +1,54 @@
+; RUN: llc < %s -march=lc3b -disable-lsr | FileCheck %s
+; RUN: llc < %s -march=lc3b -disable-lsr -disable-lc3b-counted-loops | FileCheck %s -check-prefix=NOCOUNT
+
+; LSR is off, it would count these loops down on its own.
+
+; i only counts the iterations, the loop counts 12 - i down to zero and the
+; decrement sets the flags of the back edge.
+define i16 @sum12(i16* nocapture %a) nounwind readonly {
+entry:
+; CHECK: sum12:
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: ldw
+; CHECK: add [[C:R[0-7]]], [[C]], #-1
+; CHECK-NEXT: brnp [[LOOP]]
+; NOCOUNT: sum12:
+; NOCOUNT: add {{R[0-7]}}, {{R[0-7]}}, #1
+; NOCOUNT: add {{R[0-7]}}, {{R[0-7]}}, #-11
+; NOCOUNT-NEXT: brnp
+  br label %loop
+
+loop:
+  %i = phi i16 [ %inc, %loop ], [ 0, %entry ]
+  %p = phi i16* [ %p.next, %loop ], [ %a, %entry ]
+  %s = phi i16 [ %add, %loop ], [ 0, %entry ]
+  %v = load i16* %p, align 2
+  %add = add i16 %v, %s
+  %p.next = getelementptr inbounds i16* %p, i16 1
+  %inc = add i16 %i, 1
+  %done = icmp eq i16 %inc, 12
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret i16 %add
+}
+
+; The body reads i, it is not replaced.
+define void @fill(i16* nocapture %a) nounwind {
+entry:
+; CHECK: fill:
+; CHECK-NOT: #-1{{$}}
+; CHECK: ret
+  br label %loop
+
+loop:
+  %i = phi i16 [ %inc, %loop ], [ 0, %entry ]
+  %p = getelementptr inbounds i16* %a, i16 %i
+  store i16 %i, i16* %p, align 2
+  %inc = add i16 %i, 1
+  %done = icmp eq i16 %inc, 12
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
@@ -0,0 +1,53 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; A leaf function without stack objects gets no prologue or epilogue and
+; leaves R7 alone.
+define i16 @leaf(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: leaf:
+; CHECK-NOT: R6
+; CHECK-NOT: R7
+; CHECK: ret
+  %r = xor i16 %a, %b
+  ret i16 %r
+}
+
+declare i16 @callee(i16)
+
+; Making a call clobbers R7, so it is saved in the frame.
+define i16 @nonleaf(i16 %a) nounwind {
+entry:
+; CHECK: nonleaf:
+; CHECK: add R6, R6, #-2
+; CHECK: stw R7, R6, #0
+; CHECK: .2byte callee
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+; CHECK: ldw R7, R6, #0
+; CHECK: add R6, R6, #2
+; CHECK: ret
+  %r = call i16 @callee(i16 %a)
+  ret i16 %r
+}
+
+; Slots past the offset6 range of LDW/STW are addressed through a scratch
+; register holding R6 + offset. The 202 byte frame is allocated and freed
+; with one ADD of a register loaded with the size, not a chain of ADD
+; immediates, and the epilogue keeps its hands off the return value in R0.
+define i16 @bigframe(i16 %i) nounwind {
+entry:
+; CHECK: bigframe:
+; CHECK: lea [[SIZE:R[1-5]]], {{\$CPI[0-9_]+}}
+; CHECK-NEXT: ldw [[SIZE]], [[SIZE]], #0
+; CHECK-NEXT: add R6, R6, [[SIZE]]
+; CHECK: stw R0, [[P:R[0-5]]], #0
+; CHECK: ldw R0, [[P]], #0
+; CHECK: ldw [[FREE:R[1-5]]], {{R[1-5]}}, #0
+; CHECK-NEXT: add R6, R6, [[FREE]]
+; CHECK-NEXT: ret
+  %buf = alloca [100 x i16], align 2
+  %p = getelementptr inbounds [100 x i16]* %buf, i16 0, i16 90
+  store volatile i16 %i, i16* %p, align 2
+  %v = load volatile i16* %p, align 2
+  ret i16 %v
+}
@@ -0,0 +1,64 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s -check-prefix=FAR
+; RUN: llc < %s -march=lc3b -code-model=small | FileCheck %s -check-prefix=NEAR
+; RUN: llc < %s -march=lc3b -lc3b-sdata-threshold=2 | FileCheck %s -check-prefix=SDA
+
+@counter = global i16 0
+@table = global [8 x i16] zeroinitializer
+
+; By default the address of a global is a literal in the function's
+; constant pool, which follows the code. With -code-model=small it is in LEA
+; range, and a small data object is a single LDW off R5.
+define i16 @get() nounwind {
+entry:
+; FAR: get:
+; FAR: lea [[P:R[0-7]]], $CPI0_0
+; FAR-NEXT: ldw [[P]], [[P]], #0
+; FAR-NEXT: ldw {{R[0-7]}}, [[P]], #0
+; FAR: ret
+; FAR: $CPI0_0:
+; FAR-NEXT: .2byte counter
+; NEAR: get:
+; NEAR-NOT: CPI
+; NEAR: lea [[P:R[0-7]]], counter
+; NEAR-NEXT: ldw {{R[0-7]}}, [[P]], #0
+; SDA: get:
+; SDA-NOT: lea
+; SDA: ldw R0, R5, counter@SDAREL
+; SDA: ret
+  %v = load i16* @counter
+  ret i16 %v
+}
+
+define void @bump() nounwind {
+entry:
+; SDA: bump:
+; SDA-NOT: lea
+; SDA: ldw [[V:R[0-7]]], R5, counter@SDAREL
+; SDA: stw {{R[0-7]}}, R5, counter@SDAREL
+; SDA: ret
+  %v = load i16* @counter
+  %n = add i16 %v, 1
+  store i16 %n, i16* @counter
+  ret void
+}
+
+; The offset of an element is folded into the literal. table is larger than
+; the small data threshold and is still reached through the constant pool.
+define i16 @third() nounwind {
+entry:
+; FAR: third:
+; FAR: lea {{R[0-7]}}, $CPI2_0
+; FAR: ret
+; FAR: $CPI2_0:
+; FAR-NEXT: .2byte table+6
+; NEAR: third:
+; NEAR: lea {{R[0-7]}}, table+6
+; SDA: third:
+; SDA: lea {{R[0-7]}}, $CPI2_0
+  %p = getelementptr [8 x i16]* @table, i16 0, i16 3
+  %v = load i16* %p
+  ret i16 %v
+}
+
+; SDA: .sbss
+; SDA: counter:
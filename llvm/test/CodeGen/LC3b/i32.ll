@@ -0,0 +1,93 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; i32 values live in register pairs. lc3b is big endian, an i32 argument
+; has its high word in the first register.
+
+; The carry is the sign of (a & b) ^ ((a ^ b) & ~sum), no compare or branch.
+define i32 @add(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: add:
+; CHECK-NOT: br
+; CHECK: rshfl {{R[0-7]}}, {{R[0-7]}}, #15
+; CHECK-NOT: br
+; CHECK: ret
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+
+define i32 @sub(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: sub:
+; CHECK-NOT: br
+; CHECK: rshfl {{R[0-7]}}, {{R[0-7]}}, #15
+; CHECK-NOT: br
+; CHECK: ret
+  %r = sub i32 %a, %b
+  ret i32 %r
+}
+
+; Counting up by one only needs the sign bits of the old and new low word.
+define i32 @inc(i32 %a) nounwind {
+entry:
+; CHECK: inc:
+; CHECK: add {{R[0-7]}}, {{R[0-7]}}, #1
+; CHECK: rshfl
+; CHECK: ret
+  %r = add i32 %a, 1
+  ret i32 %r
+}
+
+; The halves of a shift are disjoint and combined with an ADD, not an OR.
+define i32 @shl(i32 %a) nounwind {
+entry:
+; CHECK: shl:
+; CHECK-DAG: lshf {{R[0-7]}}, R0, #3
+; CHECK-DAG: rshfl {{R[0-7]}}, R1, #13
+; CHECK-NOT: xor
+; CHECK: ret
+  %r = shl i32 %a, 3
+  ret i32 %r
+}
+
+; A signed compare branches on the high words and only looks at the low
+; words when those are equal.
+define i16 @lt(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: lt:
+; CHECK: brn
+; CHECK: brnp
+; CHECK: brn
+  %c = icmp slt i32 %a, %b
+  br i1 %c, label %t, label %f
+t:
+  ret i16 1
+f:
+  ret i16 0
+}
+
+define i16 @eq(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: eq:
+; CHECK: brnp
+; CHECK: brz
+  %c = icmp eq i32 %a, %b
+  br i1 %c, label %t, label %f
+t:
+  ret i16 1
+f:
+  ret i16 0
+}
+
+; The sign of an i32 is the sign of its high word.
+define i16 @neg(i32 %a) nounwind {
+entry:
+; CHECK: neg:
+; CHECK: add R0, R0, #0
+; CHECK-NEXT: brn
+  %c = icmp slt i32 %a, 0
+  br i1 %c, label %t, label %f
+t:
+  ret i16 1
+f:
+  ret i16 0
+}
@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=lc3b -force-lc3b-long-branch | FileCheck %s
+; RUN: llc < %s -march=lc3b | FileCheck %s -check-prefix=CALL
+; RUN: llc < %s -march=lc3b -filetype=obj -o /dev/null
+
+; A branch out of PCoffset9 range loads its target from a literal that
+; follows the JMP.
+define void @spin(i16* %p) nounwind {
+entry:
+  br label %loop
+
+; CHECK: spin:
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: stw
+; CHECK: lea [[R:R[0-7]]], #2
+; CHECK-NEXT: ldw [[R]], [[R]], #0
+; CHECK-NEXT: jmp [[R]]
+; CHECK-NEXT: .2byte ([[LOOP]])
+loop:
+  store volatile i16 0, i16* %p
+  br label %loop
+}
+
+; A call to a function laid out before the caller and in JSR range stays a
+; JSR. A callee more than 1024 words back, or one not laid out yet, is
+; called through R7 loaded from a literal.
+define i16 @far(i16 %a) nounwind {
+entry:
+  ret i16 %a
+}
+
+; @big is about 2.6 KB of stores.
+define void @big([200 x i16]* %p) nounwind {
+entry:
+  store volatile [200 x i16] zeroinitializer, [200 x i16]* %p
+  ret void
+}
+
+declare i16 @ext(i16)
+
+define i16 @caller(i16 %a) nounwind {
+entry:
+; CALL: caller:
+; CALL: lea R7, #1
+; CALL-NEXT: brnzp #1
+; CALL-NEXT: .2byte far
+; CALL-NEXT: ldw R7, R7, #0
+; CALL-NEXT: jsrr R7
+; CALL: .2byte ext
+; CALL-NEXT: ldw R7, R7, #0
+; CALL-NEXT: jsrr R7
+; CALL: .2byte later
+; CALL-NEXT: ldw R7, R7, #0
+; CALL-NEXT: jsrr R7
+; CALL: ret
+  %b = call i16 @far(i16 %a)
+  %c = call i16 @ext(i16 %b)
+  %d = call i16 @later(i16 %c)
+  ret i16 %d
+}
+
+define i16 @later(i16 %a) nounwind {
+entry:
+; CALL: later:
+; CALL: jsr caller
+; CALL: ret
+  %b = call i16 @caller(i16 %a)
+  ret i16 %b
+}
@@ -0,0 +1,40 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; There is no scaled index, LSR strength-reduces a[i] into a pointer
+; stepped by the element size and folds nothing but offset6 into the LDW.
+define i16 @sum(i16* nocapture %a, i16 %n) nounwind readonly {
+entry:
+; CHECK: sum:
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: ldw {{R[0-7]}}, [[P:R[0-7]]], #0
+; CHECK: add [[P]], [[P]], #2
+; CHECK-NOT: lshf
+; CHECK: br{{[nzp]+}} [[LOOP]]
+  %cmp4 = icmp sgt i16 %n, 0
+  br i1 %cmp4, label %loop, label %exit
+
+loop:
+  %i = phi i16 [ %inc, %loop ], [ 0, %entry ]
+  %s = phi i16 [ %add, %loop ], [ 0, %entry ]
+  %arrayidx = getelementptr inbounds i16* %a, i16 %i
+  %v = load i16* %arrayidx, align 2
+  %add = add nsw i16 %v, %s
+  %inc = add nsw i16 %i, 1
+  %cmp = icmp slt i16 %inc, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  %r = phi i16 [ 0, %entry ], [ %add, %loop ]
+  ret i16 %r
+}
+
+; An aggregate larger than the offset6 range is still addressed by a bare
+; base register, each word then gets its own address.
+define void @clear([40 x i16]* %p) nounwind {
+entry:
+; CHECK: clear:
+; CHECK: stw {{R[0-7]}}, R0, #0
+; CHECK: ret
+  store volatile [40 x i16] zeroinitializer, [40 x i16]* %p
+  ret void
+}
@@ -0,0 +1,93 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; memcpy and memset of a known size are inlined: unrolled up to eight stores,
+; a loop over words (or bytes, when unaligned) beyond that.
+
+declare void @llvm.memcpy.p0i8.p0i8.i16(i8*, i8*, i16, i32, i1) nounwind
+declare void @llvm.memset.p0i8.i16(i8*, i8, i16, i32, i1) nounwind
+
+define void @copy_small(i8* %d, i8* %s) nounwind {
+entry:
+; CHECK: copy_small:
+; CHECK-NOT: jsr
+; CHECK: ldw {{R[0-7]}}, R1, #3
+; CHECK: stw {{R[0-7]}}, R0, #3
+; CHECK-NOT: jsr
+; CHECK: ret
+  call void @llvm.memcpy.p0i8.p0i8.i16(i8* %d, i8* %s, i16 8, i32 2, i1 false)
+  ret void
+}
+
+define void @copy_words(i8* %d, i8* %s) nounwind {
+entry:
+; CHECK: copy_words:
+; CHECK-NOT: jsr
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: ldw [[T:R[0-7]]], [[S:R[0-7]]], #0
+; CHECK: stw [[T]], [[D:R[0-7]]], #0
+; CHECK-DAG: add [[S]], [[S]], #2
+; CHECK-DAG: add [[D]], [[D]], #2
+; CHECK: add [[C:R[0-7]]], [[C]], #-1
+; CHECK-NEXT: brp [[LOOP]]
+; CHECK-NOT: jsr
+; CHECK: ret
+  call void @llvm.memcpy.p0i8.p0i8.i16(i8* %d, i8* %s, i16 64, i32 2, i1 false)
+  ret void
+}
+
+; The odd byte after the loop is an LDB/STB.
+define void @copy_odd(i8* %d, i8* %s) nounwind {
+entry:
+; CHECK: copy_odd:
+; CHECK: ldw
+; CHECK: brp
+; CHECK: ldb
+; CHECK: stb
+; CHECK: ret
+  call void @llvm.memcpy.p0i8.p0i8.i16(i8* %d, i8* %s, i16 41, i32 2, i1 false)
+  ret void
+}
+
+define void @copy_bytes(i8* %d, i8* %s) nounwind {
+entry:
+; CHECK: copy_bytes:
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: ldb [[T:R[0-7]]], {{R[0-7]}}, #0
+; CHECK: stb [[T]], {{R[0-7]}}, #0
+; CHECK: brp [[LOOP]]
+  call void @llvm.memcpy.p0i8.p0i8.i16(i8* %d, i8* %s, i16 32, i32 1, i1 false)
+  ret void
+}
+
+define void @copy_unknown(i8* %d, i8* %s, i16 %n) nounwind {
+entry:
+; CHECK: copy_unknown:
+; CHECK: .2byte memcpy
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  call void @llvm.memcpy.p0i8.p0i8.i16(i8* %d, i8* %s, i16 %n, i32 2, i1 false)
+  ret void
+}
+
+define void @clear_words(i8* %d) nounwind {
+entry:
+; CHECK: clear_words:
+; CHECK-NOT: jsr
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: stw [[V:R[0-7]]], [[D:R[0-7]]], #0
+; CHECK: add [[D]], [[D]], #2
+; CHECK: brp [[LOOP]]
+  call void @llvm.memset.p0i8.i16(i8* %d, i8 0, i16 40, i32 2, i1 false)
+  ret void
+}
+
+; The byte is repeated in both halves of the word, here at run time.
+define void @fill_words(i8* %d, i8 %c) nounwind {
+entry:
+; CHECK: fill_words:
+; CHECK: lshf {{R[0-7]}}, {{R[0-7]}}, #8
+; CHECK: stw
+; CHECK: brp
+  call void @llvm.memset.p0i8.i16(i8* %d, i8 %c, i16 40, i32 2, i1 false)
+  ret void
+}
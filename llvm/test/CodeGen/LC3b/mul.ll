@@ -0,0 +1,76 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; Small constant multiplies are expanded into shifts and adds.
+define i16 @mul10(i16 %a) nounwind {
+entry:
+; CHECK: mul10:
+; CHECK-NOT: jsr
+; CHECK: lshf
+; CHECK: add
+; CHECK: ret
+  %r = mul i16 %a, 10
+  ret i16 %r
+}
+
+; 15 = 16 - 1, the subtraction is a negate (xor/add) and an add.
+define i16 @mul15(i16 %a) nounwind {
+entry:
+; CHECK: mul15:
+; CHECK-NOT: jsr
+; CHECK: lshf {{R[0-7]}}, {{R[0-7]}}, #4
+; CHECK: xor {{R[0-7]}}, {{R[0-7]}}, #-1
+; CHECK: ret
+  %r = mul i16 %a, 15
+  ret i16 %r
+}
+
+; Variable multiplies, divides and remainders call the runtime helpers.
+define i16 @mulvar(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: mulvar:
+; CHECK: .2byte __mulhi3
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  %r = mul i16 %a, %b
+  ret i16 %r
+}
+
+define i16 @sdiv(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: sdiv:
+; CHECK: .2byte __divhi3
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  %r = sdiv i16 %a, %b
+  ret i16 %r
+}
+
+define i16 @udiv(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: udiv:
+; CHECK: .2byte __udivhi3
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  %r = udiv i16 %a, %b
+  ret i16 %r
+}
+
+define i16 @srem(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: srem:
+; CHECK: .2byte __modhi3
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  %r = srem i16 %a, %b
+  ret i16 %r
+}
+
+define i16 @urem(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: urem:
+; CHECK: .2byte __umodhi3
+; CHECK-NEXT: ldw R7, R7, #0
+; CHECK-NEXT: jsrr R7
+  %r = urem i16 %a, %b
+  ret i16 %r
+}
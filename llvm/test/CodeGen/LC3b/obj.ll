@@ -0,0 +1,46 @@
+; RUN: llc < %s -march=lc3b -filetype=obj -o - \
+; RUN:   | llvm-readobj -h -s -sd -r | FileCheck %s
+; RUN: llc < %s -march=lc3bel -filetype=obj -o - \
+; RUN:   | llvm-readobj -h | FileCheck -check-prefix=EL %s
+
+; The objects are ELF32 for the LC3b machine, in either byte order.
+; CHECK: Format: ELF32-lc3b
+; CHECK-NEXT: Arch: lc3b
+; CHECK: Machine: EM_LC3B (0x4C33)
+; EL: Format: ELF32-lc3b
+; EL-NEXT: Arch: lc3bel
+; EL: DataEncoding: LittleEndian
+; EL: Machine: EM_LC3B (0x4C33)
+
+; The code emitter writes the 16-bit words directly: and R0, R0, #0,
+; add R0, R0, #5 and ret (JMP R7).
+define i16 @five() nounwind {
+entry:
+  ret i16 5
+}
+
+; A call to an external function may be out of JSR range, its address is a
+; literal word left to the linker.
+declare void @callee()
+
+define void @caller() nounwind {
+entry:
+  call void @callee()
+  ret void
+}
+
+; Without nounwind the function gets an .eh_frame entry, which addresses
+; the code with a 32-bit PC relative word.
+define void @unwind() {
+entry:
+  ret void
+}
+
+; CHECK: Name: .text
+; CHECK: SectionData (
+; CHECK-NEXT: 0000: 5{{[0-9A-F]+}}25 C1C0
+; CHECK: Relocations [
+; CHECK: Section ({{[0-9]+}}) .text {
+; CHECK-NEXT: 0x{{[0-9A-F]+}} R_LC3B_16 callee 0x0
+; CHECK: Section ({{[0-9]+}}) .eh_frame {
+; CHECK-NEXT: 0x{{[0-9A-F]+}} R_LC3B_PC32 .text 0x{{[0-9A-F]+}}
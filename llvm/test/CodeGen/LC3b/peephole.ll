@@ -0,0 +1,82 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+; RUN: llc < %s -march=lc3b -disable-lc3b-peephole | FileCheck %s -check-prefix=NOPEEP
+; RUN: llc < %s -march=lc3b -stats 2>&1 | FileCheck %s -check-prefix=STATS
+; REQUIRES: asserts
+
+; Without mem2reg the locals stay on the stack. The store of %a is followed by
+; a reload of the same R6 slot, which is forwarded from the register it was
+; stored from; the resulting ADD R0, R0, #0 is then deleted.
+define i16 @locals(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: locals:
+; CHECK: stw R0, R6, #[[OFF:[0-9]+]]
+; CHECK-NOT: ldw
+; CHECK: xor R0, R0, R1
+; CHECK: ret
+; NOPEEP: locals:
+; NOPEEP: stw R0, R6, #[[OFF:[0-9]+]]
+; NOPEEP-NEXT: ldw R0, R6, #[[OFF]]
+; NOPEEP: ret
+  %x = alloca i16
+  %y = alloca i16
+  store i16 %a, i16* %x
+  store i16 %b, i16* %y
+  %u = load i16* %x
+  %v = load i16* %y
+  %r = xor i16 %u, %v
+  ret i16 %r
+}
+
+; The reload is forwarded as ADD R0, R0, #0 like in @locals, but the branch
+; tests the flags it sets: the copy stays.
+define i16 @flags(i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: flags:
+; CHECK: stw R0, R6, #[[OFF:[0-9]+]]
+; CHECK-NEXT: add R0, R0, #0
+; CHECK-NEXT: brnp
+; NOPEEP: flags:
+; NOPEEP: stw R0, R6, #[[OFF:[0-9]+]]
+; NOPEEP-NEXT: ldw R0, R6, #[[OFF]]
+; NOPEEP-NEXT: brnp
+  %x = alloca i16
+  store i16 %a, i16* %x
+  br label %next
+
+next:
+  %v = load i16* %x
+  %c = icmp eq i16 %v, 0
+  br i1 %c, label %zero, label %done
+
+zero:
+  ret i16 %b
+
+done:
+  ret i16 %v
+}
+
+; 9 goes in the register that still holds 7, an ADD #2 builds it from there.
+define void @merge(i16* %p, i16* %q) nounwind {
+entry:
+; CHECK: merge:
+; CHECK: and [[R:R[0-7]]], [[R]], #0
+; CHECK-NEXT: add [[R]], [[R]], #7
+; CHECK-NEXT: stw [[R]], R0, #0
+; CHECK-NOT: and
+; CHECK: add [[R]], [[R]], #2
+; CHECK: stw [[R]], R0, #0
+; NOPEEP: merge:
+; NOPEEP: and [[R:R[0-7]]], [[R]], #0
+; NOPEEP-NEXT: add [[R]], [[R]], #7
+; NOPEEP: and [[R]], [[R]], #0
+; NOPEEP-NEXT: add [[R]], [[R]], #9
+  store volatile i16 7, i16* %p
+  %v = load volatile i16* %q
+  store volatile i16 %v, i16* %p
+  store volatile i16 9, i16* %p
+  ret void
+}
+
+; STATS: 1 lc3b-peephole - Number of constant chains merged
+; STATS: 1 lc3b-peephole - Number of self copies deleted
+; STATS: 2 lc3b-peephole - Number of stack loads forwarded
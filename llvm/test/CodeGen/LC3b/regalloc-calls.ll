@@ -0,0 +1,46 @@
+; RUN: llc < %s -march=lc3b -regalloc=greedy -lc3b-cycle-estimate -o %t.greedy \
+; RUN:   2>&1 | FileCheck %s -check-prefix=GREEDY
+; RUN: FileCheck %s < %t.greedy
+; RUN: llc < %s -march=lc3b -regalloc=basic -lc3b-cycle-estimate -o %t.basic \
+; RUN:   2>&1 | FileCheck %s -check-prefix=BASIC
+; RUN: FileCheck %s < %t.basic
+; RUN: llc < %s -march=lc3b -regalloc=pbqp -lc3b-cycle-estimate -o %t.pbqp \
+; RUN:   2>&1 | FileCheck %s -check-prefix=PBQP
+; RUN: FileCheck %s < %t.pbqp
+
+; Register allocation benchmark: values live across calls in a loop. JSR
+; clobbers R7, so the counter and the sum are hinted to the callee saved
+; R4/R5 instead of being spilled around each JSR. @f is defined first, so
+; that its calls are in JSR range.
+
+define i16 @f(i16 %x) nounwind {
+entry:
+  ret i16 %x
+}
+
+; GREEDY: LC3b cycle estimate: calls 1659
+; BASIC: LC3b cycle estimate: calls 1659
+; PBQP: LC3b cycle estimate: calls 1659
+define i16 @calls(i16 %n) nounwind {
+entry:
+; CHECK: calls:
+; CHECK: stw R7, R6
+; CHECK: jsr f
+; CHECK-NOT: ldw {{R[0-7]}}, R6
+; CHECK: jsr f
+; CHECK: ret
+  br label %loop
+
+loop:
+  %i = phi i16 [ %n, %entry ], [ %i.next, %loop ]
+  %acc = phi i16 [ 0, %entry ], [ %acc.next, %loop ]
+  %a = call i16 @f(i16 %i)
+  %acc.next = add i16 %acc, %a
+  %i.next = add i16 %i, -1
+  %done = icmp eq i16 %i.next, 0
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %b = call i16 @f(i16 %acc.next)
+  ret i16 %b
+}
@@ -0,0 +1,54 @@
+; RUN: llc < %s -march=lc3b -regalloc=greedy -lc3b-cycle-estimate -o %t.greedy \
+; RUN:   2>&1 | FileCheck %s -check-prefix=GREEDY
+; RUN: FileCheck %s < %t.greedy
+; RUN: llc < %s -march=lc3b -regalloc=basic -lc3b-cycle-estimate -o %t.basic \
+; RUN:   2>&1 | FileCheck %s -check-prefix=BASIC
+; RUN: FileCheck %s < %t.basic
+; RUN: llc < %s -march=lc3b -regalloc=pbqp -lc3b-cycle-estimate -o %t.pbqp \
+; RUN:   2>&1 | FileCheck %s -check-prefix=PBQP
+; RUN: FileCheck %s < %t.pbqp
+
+; Register allocation benchmark: more live values than R0-R5 and R7 hold,
+; so some loaded values are spilled. The simm5 constants stored at the end
+; are LI5 and rematerialized with AND/ADD there rather than kept live.
+
+; GREEDY: LC3b cycle estimate: pressure 511
+; BASIC: LC3b cycle estimate: pressure 490
+; PBQP: LC3b cycle estimate: pressure 520
+define void @pressure(i16* %p) nounwind {
+entry:
+; CHECK: pressure:
+; CHECK: and [[C:R[0-7]]], [[C]], #0
+; CHECK-NEXT: add [[C]], [[C]], #3
+; CHECK-NEXT: stw [[C]], {{R[0-7]}}, #1
+; CHECK: ret
+  %a0 = getelementptr i16* %p, i16 0
+  %a1 = getelementptr i16* %p, i16 1
+  %a2 = getelementptr i16* %p, i16 2
+  %a3 = getelementptr i16* %p, i16 3
+  %a4 = getelementptr i16* %p, i16 4
+  %a5 = getelementptr i16* %p, i16 5
+  %a6 = getelementptr i16* %p, i16 6
+  %a7 = getelementptr i16* %p, i16 7
+  %v0 = load volatile i16* %a0
+  %v1 = load volatile i16* %a1
+  %v2 = load volatile i16* %a2
+  %v3 = load volatile i16* %a3
+  %v4 = load volatile i16* %a4
+  %v5 = load volatile i16* %a5
+  %v6 = load volatile i16* %a6
+  %v7 = load volatile i16* %a7
+  %s0 = add i16 %v0, 3
+  %s1 = add i16 %v1, %s0
+  %s2 = xor i16 %v2, 7
+  %s3 = add i16 %s2, %s1
+  %s4 = add i16 %v3, %s3
+  %s5 = add i16 %v4, %s4
+  %s6 = add i16 %v5, %s5
+  %s7 = add i16 %v6, %s6
+  %s8 = add i16 %v7, %s7
+  store volatile i16 %s8, i16* %a0
+  store volatile i16 3, i16* %a1
+  store volatile i16 7, i16* %a2
+  ret void
+}
@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=lc3b -mcpu=LC3b 2>&1 | FileCheck %s
+; RUN: llc < %s -march=lc3b -mcpu=cpu032 2>&1 | FileCheck %s
+; RUN: llc < %s -march=lc3b -lc3b-cycle-estimate -o /dev/null 2> %t.default
+; RUN: llc < %s -march=lc3b -lc3b-cycle-estimate -post-RA-scheduler -o %t.s \
+; RUN:   2> %t.postra
+; RUN: FileCheck %s -check-prefix=POSTRA < %t.s
+; RUN: cat %t.default %t.postra | FileCheck %s -check-prefix=CYCLES
+
+; CHECK-NOT: not a recognized processor
+
+; Instructions do not overlap, so the cost of a block is the sum of the
+; simulator latencies whatever the order: LDW 15, two ADDs 9 each and the
+; RET 10.
+define i16 @sum(i16* %p, i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: sum:
+; CHECK: ldw
+; CHECK: ret
+; CYCLES: LC3b cycle estimate: sum 43
+  %s = add i16 %a, %b
+  %v = load i16* %p
+  %r = add i16 %v, %s
+  ret i16 %r
+}
+
+; The LC3b does not enable the post-RA scheduler, the callee-saved spills stay
+; together in the prologue. Forced on, it sinks them between the loads for the
+; same cycle count.
+define i16 @spills(i16* %p) nounwind {
+entry:
+; CHECK: spills:
+; CHECK: add R6, R6, #-12
+; CHECK-NEXT: stw R7, R6, #5
+; CHECK-NEXT: stw R5, R6, #4
+; CHECK-NEXT: stw R4, R6, #3
+; CHECK-NEXT: ldw R1, R0, #0
+; POSTRA: spills:
+; POSTRA: add R6, R6, #-12
+; POSTRA-NEXT: ldw R1, R0, #0
+; POSTRA: stw R7, R6, #5
+; POSTRA-NEXT: ldw R7, R0, #5
+; CYCLES: LC3b cycle estimate: spills [[SPILLS:[0-9]+]]
+; CYCLES: LC3b cycle estimate: sum 43
+; CYCLES: LC3b cycle estimate: spills [[SPILLS]]
+  %p1 = getelementptr i16* %p, i16 1
+  %p2 = getelementptr i16* %p, i16 2
+  %p3 = getelementptr i16* %p, i16 3
+  %p4 = getelementptr i16* %p, i16 4
+  %p5 = getelementptr i16* %p, i16 5
+  %p6 = getelementptr i16* %p, i16 6
+  %p7 = getelementptr i16* %p, i16 7
+  %a = load i16* %p
+  %b = load i16* %p1
+  %c = load i16* %p2
+  %d = load i16* %p3
+  %e = load i16* %p4
+  %f = load i16* %p5
+  %g = load i16* %p6
+  %h = load i16* %p7
+  %x = add i16 %a, %b
+  %y = add i16 %c, %d
+  %u = add i16 %e, %f
+  %v = add i16 %g, %h
+  %x1 = xor i16 %x, %y
+  %u1 = xor i16 %u, %v
+  %z = and i16 %x1, %u1
+  ret i16 %z
+}
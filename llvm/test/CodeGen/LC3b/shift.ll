@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; LSHF, RSHFL and RSHFA only take a constant amount. A register amount is a
+; loop shifting one bit at a time, skipped for an amount of zero.
+define i16 @shl(i16 %a, i16 %n) nounwind {
+entry:
+; CHECK: shl:
+; CHECK: add R1, R1, #0
+; CHECK-NEXT: brz [[DONE:\$BB[0-9_]+]]
+; CHECK: [[LOOP:\$BB[0-9_]+]]:
+; CHECK: lshf R0, R0, #1
+; CHECK-NEXT: add R1, R1, #-1
+; CHECK-NEXT: brp [[LOOP]]
+; CHECK: [[DONE]]:
+  %r = shl i16 %a, %n
+  ret i16 %r
+}
+
+define i16 @lshr(i16 %a, i16 %n) nounwind {
+entry:
+; CHECK: lshr:
+; CHECK: rshfl R0, R0, #1
+; CHECK-NEXT: add R1, R1, #-1
+  %r = lshr i16 %a, %n
+  ret i16 %r
+}
+
+define i16 @ashr(i16 %a, i16 %n) nounwind {
+entry:
+; CHECK: ashr:
+; CHECK: rshfa R0, R0, #1
+; CHECK-NEXT: add R1, R1, #-1
+  %r = ashr i16 %a, %n
+  ret i16 %r
+}
+
+; An i32 moves the bit crossing the halves, the high word is R0.
+define i32 @shl32(i32 %a, i32 %n) nounwind {
+entry:
+; CHECK: shl32:
+; CHECK: rshfl [[C:R[0-7]]], R1, #15
+; CHECK-NEXT: lshf R0, R0, #1
+; CHECK-NEXT: add R0, R0, [[C]]
+; CHECK-NEXT: lshf R1, R1, #1
+  %r = shl i32 %a, %n
+  ret i32 %r
+}
+
+define i32 @ashr32(i32 %a, i32 %n) nounwind {
+entry:
+; CHECK: ashr32:
+; CHECK: lshf [[C:R[0-7]]], R0, #15
+; CHECK-NEXT: rshfl R1, R1, #1
+; CHECK-NEXT: add R1, R1, [[C]]
+; CHECK-NEXT: rshfa R0, R0, #1
+  %r = ashr i32 %a, %n
+  ret i32 %r
+}
+
+; 1 << x still comes from the table of powers of two.
+define i16 @pow2(i16 %x) nounwind {
+entry:
+; CHECK: pow2:
+; CHECK-NOT: lshf
+; CHECK: ldw
+  %r = shl i16 1, %x
+  ret i16 %r
+}
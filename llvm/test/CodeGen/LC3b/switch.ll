@@ -0,0 +1,94 @@
+; RUN: llc < %s -march=lc3b | FileCheck %s
+
+; Dense switches dispatch through a jump table of block addresses.
+define i16 @dispatch(i16 %op, i16 %a, i16 %b) nounwind {
+entry:
+; CHECK: dispatch:
+; CHECK: lea [[T:R[0-7]]], $JTI0_0
+; CHECK: add [[A:R[0-7]]], {{R[0-7]}}, [[T]]
+; CHECK-NEXT: ldw [[D:R[0-7]]], [[A]], #0
+; CHECK-NEXT: jmp [[D]]
+; CHECK: $JTI0_0:
+; CHECK-NEXT: .2byte ($BB0_
+  switch i16 %op, label %other [
+    i16 0, label %add
+    i16 1, label %sub
+    i16 2, label %and
+    i16 3, label %xor
+    i16 5, label %neg
+  ]
+add:
+  %r0 = add i16 %a, %b
+  ret i16 %r0
+sub:
+  %r1 = sub i16 %a, %b
+  ret i16 %r1
+and:
+  %r2 = and i16 %a, %b
+  ret i16 %r2
+xor:
+  %r3 = xor i16 %a, %b
+  ret i16 %r3
+neg:
+  %r4 = sub i16 0, %a
+  ret i16 %r4
+other:
+  ret i16 0
+}
+
+; A table of 10 cases over a range of 1000 values would be too sparse.
+define i16 @sparse(i16 %op) nounwind {
+entry:
+; CHECK: sparse:
+; CHECK-NOT: JTI
+; CHECK: ret
+  switch i16 %op, label %other [
+    i16 0, label %a
+    i16 100, label %b
+    i16 200, label %c
+    i16 300, label %d
+    i16 400, label %a
+    i16 500, label %b
+    i16 600, label %c
+    i16 700, label %d
+    i16 800, label %a
+    i16 900, label %b
+  ]
+a:
+  ret i16 1
+b:
+  ret i16 2
+c:
+  ret i16 3
+d:
+  ret i16 4
+other:
+  ret i16 0
+}
+
+; Cases with one destination within a word become a bit test, with 1 << x
+; loaded from a table of powers of two.
+define i16 @is_space(i16 %c) nounwind {
+entry:
+; CHECK: is_space:
+; CHECK-NOT: JTI
+; CHECK: add [[I:R[0-7]]], [[I]], [[I]]
+; CHECK-NEXT: lea [[P:R[0-7]]], [[T:\$CPI[0-9_]+]]
+; CHECK: ldw [[B:R[0-7]]], {{R[0-7]}}, #0
+; CHECK: and {{R[0-7]}}, {{R[0-7]}}, {{R[0-7]}}
+; CHECK: ret
+; CHECK: [[T]]:
+; CHECK-NEXT: .2byte 1
+; CHECK-NEXT: .2byte 2
+  switch i16 %c, label %no [
+    i16 9, label %yes
+    i16 10, label %yes
+    i16 11, label %yes
+    i16 13, label %yes
+    i16 15, label %yes
+  ]
+yes:
+  ret i16 1
+no:
+  ret i16 0
+}
@@ -0,0 +1,73 @@
+; RUN: llvm-mc %s -arch=lc3b -show-encoding | FileCheck %s
+
+; Registers and mnemonics are case insensitive, '#' immediates are decimal
+; and 'x' ones hexadecimal.
+	.ORIG x3000
+
+; CHECK: add R0, R1, R2 {{.*}} encoding: [0x10,0x42]
+	add	R0, R1, R2
+; CHECK: add R3, R3, #-1 {{.*}} encoding: [0x16,0xff]
+	ADD	r3, r3, #-1
+; CHECK: and R1, R1, #0 {{.*}} encoding: [0x52,0x60]
+	and	R1, R1, x0
+; CHECK: lshf R1, R2, #4 {{.*}} encoding: [0xd2,0x84]
+	lshf	R1, R2, #4
+
+; The offset of LDW/STW counts words.
+; CHECK: ldw R0, R6, #1 {{.*}} encoding: [0x61,0x81]
+	ldw	R0, R6, #1
+; CHECK: stb R1, R0, #3 {{.*}} encoding: [0x32,0x03]
+	stb	R1, R0, #3
+
+; Small data objects are offset from _SDA_BASE_ in R5, left to the linker.
+; CHECK: ldw R0, R5, counter@SDAREL {{.*}} encoding: [0x61,{{.*}}]
+; CHECK-NEXT: fixup A - offset: 0, value: counter@SDAREL, kind: fixup_LC3b_SDA6W
+	ldw	R0, R5, counter@SDAREL
+
+; CHECK: encoding: [0xf0,0x25]
+	trap	x25
+; CHECK: encoding: [0xf0,0x25]
+	HALT
+; CHECK: encoding: [0xf0,0x22]
+	puts
+; CHECK: rti {{.*}} encoding: [0x80,0x00]
+	rti
+
+; CHECK: brnzp loop
+loop:
+	BRnzp	loop
+; CHECK: brnzp loop
+	br	loop
+
+; CHECK: .2byte loop
+	.FILL	loop
+; CHECK: .ascii "hi"
+; CHECK-NEXT: .byte 0
+msg:	.STRINGZ "hi"
+; CHECK: .space 4
+	.BLKW	2
+
+; Labels need no colon, an identifier that is not a mnemonic is one.
+; CHECK: LOOP:
+; CHECK-NEXT: add R1, R1, #-1
+LOOP	ADD	R1, R1, #-1
+; CHECK: brp LOOP
+	BRp	LOOP
+; CHECK: DONE:
+; CHECK-NEXT: encoding: [0xf0,0x25]
+DONE	TRAP	x25
+; CHECK: VALUE:
+; CHECK-NEXT: .2byte 4660
+VALUE	.FILL	x1234
+; CHECK: LAST:
+LAST
+
+; NOT is XOR with #-1.
+; CHECK: xor R2, R3, #-1 {{.*}} encoding: [0x94,0xff]
+	NOT	R2, R3
+
+	.END
+; Nothing after .END is assembled.
+; CHECK-NOT: R0
+	ADD	R0, R0, R0
+
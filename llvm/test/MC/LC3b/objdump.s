@@ -0,0 +1,18 @@
+; RUN: llvm-mc %s -arch=lc3bel -filetype=obj -o %t
+; RUN: llvm-objdump -d -r %t | FileCheck %s
+
+; llvm-objdump finds the LC3b disassembler from the ELF machine number.
+; CHECK: file format ELF32-lc3b
+; CHECK: Disassembly of section .text:
+; CHECK: 0: 42 10 add R0, R1, R2
+; CHECK: 2: 81 61 ldw R0, R6, #1
+; CHECK: 4: ff 0f brnzp #-1
+; CHECK: 6: {{.. ..}} jsr
+; CHECK-NEXT: 6: R_LC3B_PC11 callee
+; CHECK: 8: 25 f0 halt
+	add	R0, R1, R2
+	ldw	R0, R6, #1
+loop:
+	brnzp	loop
+	jsr	callee
+	halt
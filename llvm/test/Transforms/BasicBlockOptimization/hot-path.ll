@@ -0,0 +1,118 @@
+; RUN: opt < %s -load %llvmshlibdir/BasicBlockOptimization%shlibext \
+; RUN:   -basicblockoptimization -S | FileCheck %s
+; RUN: opt < %s -load %llvmshlibdir/BasicBlockOptimization%shlibext \
+; RUN:   -basicblockoptimization -stats -disable-output 2>&1 \
+; RUN:   | FileCheck %s -check-prefix=STATS
+; REQUIRES: loadable_module, asserts
+
+; @hot_first takes one branch less per call. @rotate removes a taken edge,
+; but its loop is only entered four times in ten.
+
+; STATS: 1 basicblockoptimization - Estimated taken branches eliminated per call
+; STATS: 1 basicblockoptimization - Number of loops rotated to exit by a fallthrough
+; STATS: 1 basicblockoptimization - Number of taken edges made fallthroughs
+
+; The likely successor follows its predecessor and the cold block moves to
+; the end.
+
+; CHECK: define i32 @hot_first
+; CHECK: entry:
+; CHECK: hot:
+; CHECK: exit:
+; CHECK: cold:
+; CHECK: }
+define i32 @hot_first(i1 %c, i32 %x) {
+entry:
+  br i1 %c, label %cold, label %hot, !prof !0
+
+cold:
+  %y = mul i32 %x, 3
+  br label %exit
+
+hot:
+  %z = add i32 %x, 1
+  br label %exit
+
+exit:
+  %r = phi i32 [ %y, %cold ], [ %z, %hot ]
+  ret i32 %r
+}
+
+; A layout that already falls through along the hot edges is kept.
+
+; CHECK: define void @sorted
+; CHECK: entry:
+; CHECK: a:
+; CHECK: b:
+; CHECK: }
+define void @sorted(i1 %c) {
+entry:
+  br i1 %c, label %a, label %b, !prof !1
+
+a:
+  br label %b
+
+b:
+  ret void
+}
+
+; The loop is entered by a taken branch from %entry anyway. Rotated to start
+; at %latch, it exits by falling through from %loop to %exit, and only the
+; backedge %loop -> %latch is taken.
+
+; CHECK: define i32 @rotate
+; CHECK: entry:
+; CHECK: early:
+; CHECK: latch:
+; CHECK: loop:
+; CHECK: exit:
+; CHECK: }
+define i32 @rotate(i32 %n, i1 %c) {
+entry:
+  br i1 %c, label %early, label %loop, !prof !2
+
+early:
+  ret i32 0
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %latch ]
+  %i.next = add i32 %i, 1
+  %t = icmp eq i32 %i.next, %n
+  br i1 %t, label %exit, label %latch
+
+latch:
+  br label %loop
+
+exit:
+  ret i32 %i.next
+}
+
+; Here %entry falls through to %loop. Rotating would make that edge taken
+; to save the one to %exit, so the loop is left alone.
+
+; CHECK: define i32 @keep
+; CHECK: entry:
+; CHECK: loop:
+; CHECK: latch:
+; CHECK: exit:
+; CHECK: }
+define i32 @keep(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %latch ]
+  %i.next = add i32 %i, 1
+  %t = icmp eq i32 %i.next, %n
+  br i1 %t, label %exit, label %latch
+
+latch:
+  br label %loop
+
+exit:
+  ret i32 %i.next
+}
+
+!0 = metadata !{metadata !"branch_weights", i32 1, i32 1000}
+!1 = metadata !{metadata !"branch_weights", i32 1000, i32 1}
+!2 = metadata !{metadata !"branch_weights", i32 600, i32 400}
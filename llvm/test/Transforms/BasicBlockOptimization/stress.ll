@@ -0,0 +1,12 @@
+; RUN: ulimit -t 30; llvm-stress -size 50000 -seed 1 \
+; RUN:   | opt -load %llvmshlibdir/BasicBlockOptimization%shlibext \
+; RUN:     -time-passes -postdomtree -basicblockoptimization -disable-output \
+; RUN:     2>&1 \
+; RUN:   | awk -v pass='Profile Guided Basic Block Placement Optimization' \
+; RUN:     -v ratio=40 -f %S/../Inputs/time-budget.awk
+; REQUIRES: loadable_module, shell
+
+; Speed test on one large function. Chaining and loop rotation may take 40
+; times as long as the post-dominator tree of the same function, about four
+; times what they take today, so a quadratic term on an input this size
+; fails. The CPU limit catches a run that never finishes.
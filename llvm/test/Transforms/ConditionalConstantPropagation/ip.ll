@@ -0,0 +1,131 @@
+; RUN: opt < %s -load %llvmshlibdir/ConditionalConstantPropagation%shlibext \
+; RUN:   -ip-conditional-constant-propagation -S | FileCheck %s
+; REQUIRES: loadable_module
+
+; Constant arguments flow into internal functions, and constant return
+; values back into their callers.
+
+; CHECK: define internal i32 @add
+; CHECK-NEXT: entry:
+; CHECK-NEXT: ret i32 undef
+define internal i32 @add(i32 %a, i32 %b) {
+entry:
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+; CHECK: define internal i32 @pick
+; CHECK-NEXT: entry:
+; CHECK-NEXT: br label %then
+; CHECK: then:
+; CHECK-NEXT: ret i32 %x
+define internal i32 @pick(i1 %c, i32 %x) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  ret i32 %x
+
+else:
+  ret i32 0
+}
+
+; CHECK: define internal void @unused
+; CHECK-NEXT: entry:
+; CHECK-NEXT: ret void
+define internal void @unused(i32 %n) {
+entry:
+  %d = mul i32 %n, 2
+  ret void
+}
+
+; CHECK: define i32 @caller
+; CHECK: %p = call i32 @pick(i1 true, i32 %y)
+; CHECK: %u = add i32 10, %p
+; CHECK-NEXT: ret i32 %u
+define i32 @caller(i32 %y) {
+entry:
+  %r1 = call i32 @add(i32 2, i32 3)
+  %r2 = call i32 @add(i32 2, i32 3)
+  %p = call i32 @pick(i1 true, i32 %y)
+  call void @unused(i32 7)
+  %t = add i32 %r1, %r2
+  %u = add i32 %t, %p
+  ret i32 %u
+}
+
+; The two call sites pass different constants, so %k is not a constant and
+; @scale keeps both paths.
+
+; CHECK: define internal i32 @scale
+; CHECK-NEXT: entry:
+; CHECK-NEXT: %big = icmp sgt i32 %k, 2
+; CHECK-NEXT: br i1 %big, label %shift, label %mul
+; CHECK: %m = mul i32 %x, %k
+define internal i32 @scale(i32 %x, i32 %k) {
+entry:
+  %big = icmp sgt i32 %k, 2
+  br i1 %big, label %shift, label %mul
+
+shift:
+  %s = shl i32 %x, 2
+  ret i32 %s
+
+mul:
+  %m = mul i32 %x, %k
+  ret i32 %m
+}
+
+; CHECK: define i32 @twice
+; CHECK: %a = call i32 @scale(i32 %x, i32 2)
+; CHECK-NEXT: %b = call i32 @scale(i32 %x, i32 3)
+define i32 @twice(i32 %x) {
+entry:
+  %a = call i32 @scale(i32 %x, i32 2)
+  %b = call i32 @scale(i32 %x, i32 3)
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+
+; A flag passed down from @config through @layer1 and @layer2 folds the
+; branch in @layer3.
+
+; CHECK: define internal i32 @layer3
+; CHECK-NEXT: entry:
+; CHECK-NEXT: br label %fast
+; CHECK: fast:
+; CHECK-NEXT: %f = add i32 %v, 1
+define internal i32 @layer3(i1 %debug, i32 %v) {
+entry:
+  br i1 %debug, label %log, label %fast
+
+log:
+  %l = mul i32 %v, 100
+  ret i32 %l
+
+fast:
+  %f = add i32 %v, 1
+  ret i32 %f
+}
+
+; CHECK: define internal i32 @layer2
+; CHECK: call i32 @layer3(i1 false, i32 %v)
+define internal i32 @layer2(i1 %debug, i32 %v) {
+entry:
+  %r = call i32 @layer3(i1 %debug, i32 %v)
+  ret i32 %r
+}
+
+; CHECK: define internal i32 @layer1
+; CHECK: call i32 @layer2(i1 false, i32 %v)
+define internal i32 @layer1(i1 %debug, i32 %v) {
+entry:
+  %r = call i32 @layer2(i1 %debug, i32 %v)
+  ret i32 %r
+}
+
+define i32 @config(i32 %v) {
+entry:
+  %r = call i32 @layer1(i1 false, i32 %v)
+  ret i32 %r
+}
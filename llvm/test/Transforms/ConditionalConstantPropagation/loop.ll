@@ -0,0 +1,47 @@
+; RUN: opt < %s -load %llvmshlibdir/ConditionalConstantPropagation%shlibext \
+; RUN:   -conditional-constant-propagation -S | FileCheck %s
+; REQUIRES: loadable_module
+
+; testcase/ccp.c after mem2reg. j only becomes non-constant along the else
+; edge, which is never executable, so it is 1 throughout the loop.
+
+define i32 @main() {
+entry:
+  br label %while.cond
+
+; CHECK: while.cond:
+; CHECK-NOT: %j.0 = phi
+; CHECK: %k.0 = phi
+while.cond:
+  %j.0 = phi i32 [ 1, %entry ], [ %j.1, %if.end ]
+  %k.0 = phi i32 [ 0, %entry ], [ %k.1, %if.end ]
+  %cmp = icmp ult i32 %k.0, 100
+  br i1 %cmp, label %while.body, label %while.end
+
+; CHECK: while.body:
+; CHECK-NEXT: br label %if.then
+while.body:
+  %cmp1 = icmp ult i32 %j.0, 20
+  br i1 %cmp1, label %if.then, label %if.else
+
+if.then:
+  %add = add i32 %k.0, 1
+  br label %if.end
+
+if.else:
+  %add2 = add i32 %k.0, 2
+  br label %if.end
+
+; CHECK: if.end:
+; CHECK-NOT: %j.1 = phi
+; CHECK: %k.1 = phi
+if.end:
+  %j.1 = phi i32 [ 1, %if.then ], [ %k.0, %if.else ]
+  %k.1 = phi i32 [ %add, %if.then ], [ %add2, %if.else ]
+  br label %while.cond
+
+; CHECK: while.end:
+; CHECK-NEXT: ret i32 1
+while.end:
+  ret i32 %j.0
+}
@@ -0,0 +1,35 @@
+; RUN: opt < %s -load %llvmshlibdir/ConditionalConstantPropagation%shlibext \
+; RUN:   -conditional-constant-propagation -S | FileCheck %s
+; REQUIRES: loadable_module
+
+; max.c after mem2reg: both branches fold and the PHIs become constants.
+
+define i32 @main() nounwind uwtable {
+; CHECK: entry:
+; CHECK-NEXT: br label %if.else
+entry:
+  %cmp = icmp slt i32 30, -5
+  br i1 %cmp, label %if.then, label %if.else
+
+if.then:
+  br label %if.end
+
+if.else:
+  br label %if.end
+
+; CHECK: if.end:
+; CHECK-NEXT: br label %if.end3
+if.end:
+  %res.0 = phi i32 [ -5, %if.then ], [ 30, %if.else ]
+  %cmp1 = icmp slt i32 %res.0, 2
+  br i1 %cmp1, label %if.then2, label %if.end3
+
+if.then2:
+  br label %if.end3
+
+; CHECK: if.end3:
+; CHECK-NEXT: ret i32 30
+if.end3:
+  %res.1 = phi i32 [ 2, %if.then2 ], [ %res.0, %if.end ]
+  ret i32 %res.1
+}
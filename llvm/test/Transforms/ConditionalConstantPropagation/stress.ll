@@ -0,0 +1,19 @@
+; RUN: ulimit -t 30; llvm-stress -size 50000 -seed 1 \
+; RUN:   | opt -load %llvmshlibdir/ConditionalConstantPropagation%shlibext \
+; RUN:     -time-passes -postdomtree -conditional-constant-propagation \
+; RUN:     -disable-output 2>&1 \
+; RUN:   | awk -v pass='Sparse conditional constant propagation' -v ratio=2 \
+; RUN:     -f %S/../Inputs/time-budget.awk
+; RUN: llvm-stress -size 50000 -seed 2 \
+; RUN:   | opt -load %llvmshlibdir/ConditionalConstantPropagation%shlibext \
+; RUN:     -time-passes -postdomtree -ip-conditional-constant-propagation \
+; RUN:     -disable-output 2>&1 \
+; RUN:   | awk -v pass='Interprocedural sparse conditional constant propagation' \
+; RUN:     -v ratio=2 -f %S/../Inputs/time-budget.awk
+; REQUIRES: loadable_module, shell
+
+; Speed test on one large function. Both solvers may take twice as long as
+; the post-dominator tree of the same function, four to ten times what the
+; sparse solvers take today, so a dense walk of the whole lattice on every
+; change fails. The CPU limit set by the first line covers both runs and
+; catches a solver that never settles.
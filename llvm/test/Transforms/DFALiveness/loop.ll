@@ -0,0 +1,54 @@
+; RUN: opt < %s -load %llvmshlibdir/DFALiveness%shlibext -analyze -dfaliveness \
+; RUN:   | FileCheck %s
+; REQUIRES: loadable_module
+
+; Values used around a loop stay live through it; the PHI operands are live
+; out of the latch, not into the header.
+
+define i32 @sum(i32* %a, i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %s = phi i32 [ 0, %entry ], [ %s.next, %loop ]
+  %p = getelementptr i32* %a, i32 %i
+  %v = load i32* %p
+  %s.next = add i32 %s, %v
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret i32 %s.next
+}
+
+; CHECK: for function 'sum':
+; CHECK-NEXT: Block %entry:
+; CHECK-NEXT:   In: %a %n
+; CHECK-NEXT:   Out: %a %n
+; CHECK-NEXT: Block %loop:
+; CHECK-NEXT:   In: %a %n
+; CHECK-NEXT:   Out: %a %n %s.next %i.next
+; CHECK-NEXT: Block %exit:
+; CHECK-NEXT:   In: %s.next
+; CHECK-NEXT:   Out:{{$}}
+
+; Unreachable blocks are still solved, after the reachable ones.
+
+define void @dead(i32 %x) {
+entry:
+  ret void
+
+unreachable:
+  %y = add i32 %x, 1
+  br label %unreachable
+}
+
+; CHECK: for function 'dead':
+; CHECK-NEXT: Block %entry:
+; CHECK-NEXT:   In:{{$}}
+; CHECK-NEXT:   Out:{{$}}
+; CHECK-NEXT: Block %unreachable:
+; CHECK-NEXT:   In: %x
+; CHECK-NEXT:   Out: %x
@@ -0,0 +1,43 @@
+; RUN: opt < %s -load %llvmshlibdir/DFALiveness%shlibext -analyze -dfaliveness \
+; RUN:   | FileCheck %s
+; REQUIRES: loadable_module
+
+; max.c after mem2reg: only the PHI result flowing into the second PHI is
+; live across blocks.
+
+define i32 @main() nounwind uwtable {
+entry:
+  %cmp = icmp slt i32 30, -5
+  br i1 %cmp, label %if.then, label %if.else
+
+if.then:
+  br label %if.end
+
+if.else:
+  br label %if.end
+
+if.end:
+  %res.0 = phi i32 [ -5, %if.then ], [ 30, %if.else ]
+  %cmp1 = icmp slt i32 %res.0, 2
+  br i1 %cmp1, label %if.then2, label %if.end3
+
+if.then2:
+  br label %if.end3
+
+if.end3:
+  %res.1 = phi i32 [ 2, %if.then2 ], [ %res.0, %if.end ]
+  ret i32 %res.1
+}
+
+; CHECK: Block %entry:
+; CHECK-NEXT:   In:{{$}}
+; CHECK-NEXT:   Out:{{$}}
+; CHECK: Block %if.end:
+; CHECK-NEXT:   In:{{$}}
+; CHECK-NEXT:   Out: %res.0
+; CHECK-NEXT: Block %if.then2:
+; CHECK-NEXT:   In:{{$}}
+; CHECK-NEXT:   Out:{{$}}
+; CHECK-NEXT: Block %if.end3:
+; CHECK-NEXT:   In:{{$}}
+; CHECK-NEXT:   Out:{{$}}
@@ -0,0 +1,12 @@
+; RUN: ulimit -t 30; llvm-stress -size 50000 -seed 1 \
+; RUN:   | opt -load %llvmshlibdir/DFALiveness%shlibext -time-passes \
+; RUN:     -postdomtree -dfaliveness -disable-output 2>&1 \
+; RUN:   | awk -v pass='Data-flow analysis: liveness analysis pass' \
+; RUN:     -v ratio=150 -f %S/../Inputs/time-budget.awk
+; REQUIRES: loadable_module, shell
+
+; Speed test on one large function. The liveness solver may take 150 times
+; as long as the post-dominator tree of the same function, about four times
+; what the worklist over bit vectors takes today, so revisiting blocks more
+; often than needed fails. The CPU limit catches a solver that never reaches
+; its fixed point.
@@ -0,0 +1,35 @@
+# Check a -time-passes report against a time budget:
+#
+#   opt -time-passes -postdomtree <pass> -disable-output 2>&1 \
+#     | awk -v pass='<pass name>' -v ratio=<N> -f time-budget.awk
+#
+# Fails unless the User+System time of the pass is at most ratio times that
+# of Post-Dominator Tree Construction, a near linear walk of the same
+# functions, plus 10ms for timer noise. Measuring both in one run keeps the
+# budget independent of the speed and load of the machine.
+
+/%\)/ {
+  # The name follows the last percentage, the last two times before it are
+  # User+System and Wall.
+  name = $0
+  sub(/.*%\) +/, "", name)
+  times = $0
+  sub(/%\) +[^%]*$/, "%)", times)
+  gsub(/\( *[0-9.]+%\)/, "", times)
+  n = split(times, t, " ")
+  if (!(name in cpu))
+    cpu[name] = t[n - 1]
+}
+
+END {
+  ref = "Post-Dominator Tree Construction"
+  if (!(pass in cpu) || !(ref in cpu)) {
+    print "time-budget: no time for '" pass "' or '" ref "'"
+    exit 1
+  }
+  budget = ratio * cpu[ref] + 0.01
+  printf "%s: %.4fs, budget %.4fs (%s x %.4fs)\n", pass, cpu[pass], budget,
+         ratio, cpu[ref]
+  if (cpu[pass] > budget)
+    exit 1
+}
@@ -0,0 +1,6 @@
+; Not nounwind: the object has an .eh_frame, which lc3b-sim does not load.
+define i16 @twice(i16 %a) {
+entry:
+  %r = shl i16 %a, 1
+  ret i16 %r
+}
@@ -0,0 +1,78 @@
+; RUN: llc < %s -march=lc3bel -filetype=obj -lc3b-sdata-threshold=2 -o %t.o
+; RUN: llc < %p/Inputs/twice.ll -march=lc3bel -filetype=obj -o %t.twice.o
+; RUN: lc3b-sim -print-registers %t.o %t.twice.o | FileCheck %s
+; RUN: not lc3b-sim %t.o 2>&1 | FileCheck %s -check-prefix=UNDEF
+; RUN: llc < %s -march=lc3b -filetype=obj -o %t.be.o
+; RUN: not lc3b-sim %t.be.o 2>&1 | FileCheck %s -check-prefix=BIG
+
+; ELF objects from llc are linked in memory and run from main until it
+; returns to x0000. The sum of @table goes through a constant pool entry
+; (R_LC3B_16), @pick through a jump table, @x and @y are small data
+; (R_LC3B_SDA6W, R5 = _SDA_BASE_), @count is a common symbol and @twice is
+; defined in the other object (a LONG_CALL literal, R_LC3B_16).
+; main returns 15 + 300 + 1 + 7 * 2 = 330.
+
+; CHECK: Stopped: reached x0000
+; CHECK: R0 = x014A
+; UNDEF: undefined symbol 'twice'
+; BIG: big endian object, compile with -march=lc3bel
+
+@table = global [5 x i16] [i16 1, i16 2, i16 3, i16 4, i16 5]
+@count = common global i16 0
+@x = global i16 7
+@y = global i16 0
+
+declare i16 @twice(i16)
+
+define i16 @sum(i16* %p, i16 %n) nounwind {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i16 [ 0, %entry ], [ %i.next, %loop ]
+  %acc = phi i16 [ 0, %entry ], [ %acc.next, %loop ]
+  %addr = getelementptr i16* %p, i16 %i
+  %v = load i16* %addr
+  %acc.next = add i16 %acc, %v
+  %i.next = add i16 %i, 1
+  %done = icmp eq i16 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret i16 %acc.next
+}
+
+define i16 @pick(i16 %k) nounwind {
+entry:
+  switch i16 %k, label %d [ i16 0, label %a
+                            i16 1, label %b
+                            i16 2, label %c
+                            i16 3, label %e ]
+a:
+  ret i16 100
+b:
+  ret i16 200
+c:
+  ret i16 300
+e:
+  ret i16 400
+d:
+  ret i16 0
+}
+
+define i16 @main() nounwind {
+entry:
+  %s = call i16 @sum(i16* getelementptr ([5 x i16]* @table, i16 0, i16 0), i16 5)
+  %c = load i16* @count
+  %c1 = add i16 %c, 1
+  store i16 %c1, i16* @count
+  %p = call i16 @pick(i16 2)
+  %v = load i16* @x
+  %t = call i16 @twice(i16 %v)
+  store i16 %t, i16* @y
+  %w = load i16* @y
+  %r = add i16 %s, %p
+  %r1 = add i16 %r, %c1
+  %r2 = add i16 %r1, %w
+  ret i16 %r2
+}
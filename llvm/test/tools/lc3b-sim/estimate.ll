@@ -0,0 +1,26 @@
+; RUN: llc < %s -march=lc3bel -filetype=obj -lc3b-cycle-estimate -o %t.o 2> %t.est
+; RUN: lc3b-sim -print-registers %t.o > %t.sim
+; RUN: cat %t.est %t.sim | FileCheck %s
+
+; lc3b-sim and -lc3b-cycle-estimate both charge the itinerary latencies of
+; LC3bSchedule.td, so on straight-line code the estimate is the exact count.
+; main returns ((7 << 3) & 1000 ^ 7) >> 2 = 11.
+
+; CHECK: LC3b cycle estimate: main [[CYCLES:[0-9]+]]
+; CHECK: Stopped: reached x0000
+; CHECK: Total cycles: {{ *}}[[CYCLES]]{{$}}
+; CHECK: R0 = x000B
+
+@x = global i16 7
+@y = global i16 0
+
+define i16 @main() nounwind {
+entry:
+  %v = load volatile i16* @x
+  %s = shl i16 %v, 3
+  %a = and i16 %s, 1000
+  %b = xor i16 %a, %v
+  store volatile i16 %b, i16* @y
+  %c = lshr i16 %b, 2
+  ret i16 %c
+}
@@ -0,0 +1,466 @@
+//===-- lc3b-sim.cpp - Cycle counting LC3b simulator ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program runs LC3b programs and reports the number of cycles they take
+// under the LC3bGenericItineraries latencies, along with per-opcode counts and
+// memory traffic. It is meant for benchmarking code produced by llc for the
+// LC3b target: ELF objects written with -filetype=obj are linked in memory
+// and run from main, and hand written programs in the textual object format
+// of the LC-3b course tools are loaded at their origin.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LC3bSimulator.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ELF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+using namespace llvm;
+using namespace object;
+
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::desc("<input object files>"),
+               cl::OneOrMore);
+
+static cl::opt<std::string>
+EntryPoint("entry", cl::desc("Start address in hex (default: main for ELF "
+                             "objects, else the origin of the first object "
+                             "file)"),
+           cl::value_desc("address"));
+
+static cl::opt<std::string>
+Origin("origin", cl::desc("Address in hex ELF sections are loaded from "
+                          "(default: x3000)"),
+       cl::value_desc("address"), cl::init("x3000"));
+
+static cl::opt<unsigned long long>
+MaxSteps("max-steps", cl::desc("Stop after executing N instructions "
+                               "(0 = no limit)"),
+         cl::value_desc("N"), cl::init(10000000));
+
+static cl::opt<bool>
+PrintRegisters("print-registers",
+               cl::desc("Print the register file when the program stops"));
+
+/// parseAddress - Parse a word aligned hex address, with an optional x or 0x
+/// prefix. Returns true on error.
+static bool parseAddress(StringRef S, uint16_t &Addr) {
+  if (S.startswith("x") || S.startswith("0x"))
+    S = S.substr(S.find('x') + 1);
+  unsigned Value;
+  if (S.getAsInteger(16, Value) || Value > 0xffff || (Value & 1))
+    return true;
+  Addr = Value;
+  return false;
+}
+
+static bool error(error_code ec, std::string &Err) {
+  if (!ec)
+    return false;
+  Err = ec.message();
+  return true;
+}
+
+namespace {
+/// ELFLoader - Link LC3b ELF relocatable objects into the simulator memory.
+/// The allocatable sections are laid out one after the other from an origin,
+/// the small data sections last and together around _SDA_BASE_, and the
+/// relocations of LC3bELFObjectWriter are applied.
+class ELFLoader {
+  LC3bSimulator &Sim;
+  std::vector<ObjectFile *> Objects;
+  /// Load address of each allocatable section, by its ELF section header.
+  DenseMap<uintptr_t, uint16_t> SectionAddrs;
+  StringMap<uint16_t> Globals;
+  uint16_t SDABase;
+  bool HasSmallData;
+
+  bool place(SectionRef Sec, unsigned &Addr, std::string &Err);
+  bool getSymbolAddress(SymbolRef Sym, uint16_t &Addr, std::string &Err);
+  bool applyRelocation(RelocationRef Rel, uint16_t SecAddr, std::string &Err);
+
+public:
+  explicit ELFLoader(LC3bSimulator &Sim)
+    : Sim(Sim), SDABase(0), HasSmallData(false) {}
+  ~ELFLoader();
+
+  /// addObject - Take ownership of an ELF object. Returns true and sets Err
+  /// if it is not one.
+  bool addObject(MemoryBuffer *Buffer, std::string &Err);
+
+  /// link - Load every object from Origin and relocate them.
+  bool link(uint16_t Origin, std::string &Err);
+
+  bool empty() const { return Objects.empty(); }
+  bool lookup(StringRef Name, uint16_t &Addr) const;
+  bool hasSmallData() const { return HasSmallData; }
+  uint16_t getSDABase() const { return SDABase; }
+};
+}
+
+ELFLoader::~ELFLoader() {
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i)
+    delete Objects[i];
+}
+
+bool ELFLoader::addObject(MemoryBuffer *Buffer, std::string &Err) {
+  ObjectFile *Obj = ObjectFile::createObjectFile(Buffer);
+  if (!Obj || !Obj->isELF() || Obj->getBytesInAddress() != 4) {
+    delete Obj;
+    Err = "not a 32-bit ELF object";
+    return true;
+  }
+  if (Obj->getArch() != Triple::lc3b && Obj->getArch() != Triple::lc3bel) {
+    delete Obj;
+    Err = "not an LC3b object";
+    return true;
+  }
+  // The LC-3b is little endian, -march=lc3b emits big endian objects.
+  if (!Obj->isLittleEndian()) {
+    delete Obj;
+    Err = "big endian object, compile with -march=lc3bel";
+    return true;
+  }
+  Objects.push_back(Obj);
+  return false;
+}
+
+static bool isSmallDataSection(StringRef Name) {
+  return Name.startswith(".sdata") || Name.startswith(".sbss");
+}
+
+/// isUnwindSection - .eh_frame is allocatable, but nothing on the LC-3b
+/// unwinds: it is not loaded and its relocations are not applied.
+static bool isUnwindSection(StringRef Name) {
+  return Name == ".eh_frame";
+}
+
+/// place - Copy an allocatable section to the next Addr suitably aligned.
+bool ELFLoader::place(SectionRef Sec, unsigned &Addr, std::string &Err) {
+  uint64_t Size, Align;
+  bool IsBSS;
+  StringRef Contents;
+  if (error(Sec.getSize(Size), Err) || error(Sec.getAlignment(Align), Err) ||
+      error(Sec.isBSS(IsBSS), Err))
+    return true;
+  Addr = RoundUpToAlignment(Addr, std::max<uint64_t>(Align, 1));
+  if (Addr + Size > LC3bSimulator::MemorySize) {
+    Err = "sections do not fit in memory";
+    return true;
+  }
+  SectionAddrs[Sec.getRawDataRefImpl().p] = Addr;
+  // SHT_NOBITS sections have no contents and memory starts zeroed.
+  if (!IsBSS) {
+    if (error(Sec.getContents(Contents), Err))
+      return true;
+    for (unsigned i = 0, e = Contents.size(); i != e; ++i)
+      Sim.writeByte(Addr + i, Contents[i]);
+  }
+  Addr += Size;
+  return false;
+}
+
+bool ELFLoader::lookup(StringRef Name, uint16_t &Addr) const {
+  StringMap<uint16_t>::const_iterator I = Globals.find(Name);
+  if (I != Globals.end()) {
+    Addr = I->second;
+    return true;
+  }
+  if (Name == "_SDA_BASE_" && HasSmallData) {
+    Addr = SDABase;
+    return true;
+  }
+  return false;
+}
+
+bool ELFLoader::getSymbolAddress(SymbolRef Sym, uint16_t &Addr,
+                                 std::string &Err) {
+  uint32_t Flags;
+  StringRef Name;
+  if (error(Sym.getFlags(Flags), Err) || error(Sym.getName(Name), Err))
+    return true;
+  // Common symbols are allocated by link, under their name.
+  if (Flags & (SymbolRef::SF_Undefined | SymbolRef::SF_Common)) {
+    if (lookup(Name, Addr))
+      return false;
+    Err = "undefined symbol '" + Name.str() + "'";
+    return true;
+  }
+
+  section_iterator Sec(SectionRef(DataRefImpl(), 0));
+  uint64_t Offset;
+  if (error(Sym.getSection(Sec), Err) || error(Sym.getAddress(Offset), Err))
+    return true;
+  if (Flags & SymbolRef::SF_Absolute) {
+    Addr = Offset;
+    return false;
+  }
+  DenseMap<uintptr_t, uint16_t>::iterator I =
+    SectionAddrs.find(Sec->getRawDataRefImpl().p);
+  if (I == SectionAddrs.end()) {
+    Err = "symbol '" + Name.str() + "' is not in a loaded section";
+    return true;
+  }
+  // Offset is relative to the section in a relocatable object.
+  Addr = I->second + Offset;
+  return false;
+}
+
+bool ELFLoader::applyRelocation(RelocationRef Rel, uint16_t SecAddr,
+                                std::string &Err) {
+  uint64_t Type, Offset;
+  int64_t Addend;
+  SymbolRef Sym;
+  uint16_t S;
+  if (error(Rel.getType(Type), Err) || error(Rel.getOffset(Offset), Err) ||
+      error(Rel.getAdditionalInfo(Addend), Err) ||
+      error(Rel.getSymbol(Sym), Err) || getSymbolAddress(Sym, S, Err))
+    return true;
+
+  uint16_t P = SecAddr + Offset;
+  int64_t Value = (int64_t)S + Addend;
+  uint16_t Inst = Sim.readWord(P);
+  switch (Type) {
+  case ELF::R_LC3B_NONE:
+    return false;
+  case ELF::R_LC3B_16:
+    Sim.writeWord(P, Value);
+    return false;
+  case ELF::R_LC3B_8:
+    Sim.writeByte(P, Value);
+    return false;
+  case ELF::R_LC3B_PC9:
+  case ELF::R_LC3B_PC11: {
+    // Word offset from the incremented PC, as in LC3bAsmBackend.
+    int64_t Delta = int16_t(Value - P - 2);
+    bool IsPC9 = Type == ELF::R_LC3B_PC9;
+    if ((Delta & 1) || (IsPC9 ? !isInt<10>(Delta) : !isInt<12>(Delta))) {
+      Err = "PC relative relocation out of range";
+      return true;
+    }
+    uint16_t Mask = IsPC9 ? 0x1ff : 0x7ff;
+    Sim.writeWord(P, (Inst & ~Mask) | ((Delta >> 1) & Mask));
+    return false;
+  }
+  case ELF::R_LC3B_SDA6:
+  case ELF::R_LC3B_SDA6W: {
+    int64_t Delta = int16_t(Value - SDABase);
+    if (Type == ELF::R_LC3B_SDA6W) {
+      if (Delta & 1) {
+        Err = "small data word is not word aligned";
+        return true;
+      }
+      Delta >>= 1;
+    }
+    if (!HasSmallData || !isInt<6>(Delta)) {
+      Err = "small data relocation out of range of _SDA_BASE_";
+      return true;
+    }
+    Sim.writeWord(P, (Inst & ~0x3f) | (Delta & 0x3f));
+    return false;
+  }
+  }
+  Err = "unknown relocation type " + utostr(Type);
+  return true;
+}
+
+bool ELFLoader::link(uint16_t Origin, std::string &Err) {
+  error_code ec;
+  // Lay out the other sections first so that the small data area ends up
+  // in one piece that R5 reaches with offset6.
+  unsigned Addr = Origin;
+  for (int Small = 0; Small != 2; ++Small) {
+    unsigned Start = Addr;
+    for (unsigned i = 0, e = Objects.size(); i != e; ++i)
+      for (section_iterator I = Objects[i]->begin_sections(),
+             E = Objects[i]->end_sections(); I != E; I.increment(ec)) {
+        bool Alloc;
+        StringRef Name;
+        if (error(ec, Err) || error(I->isRequiredForExecution(Alloc), Err) ||
+            error(I->getName(Name), Err))
+          return true;
+        if (Alloc && !isUnwindSection(Name) &&
+            isSmallDataSection(Name) == (bool)Small && place(*I, Addr, Err))
+          return true;
+      }
+    // _SDA_BASE_ is 32 bytes in, so that offset6 covers 64 bytes.
+    if (Small && Addr != Start) {
+      HasSmallData = true;
+      SDABase = RoundUpToAlignment(Start, 2) + 32;
+    }
+  }
+
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i)
+    for (symbol_iterator I = Objects[i]->begin_symbols(),
+           E = Objects[i]->end_symbols(); I != E; I.increment(ec)) {
+      uint32_t Flags;
+      StringRef Name;
+      uint16_t SymAddr;
+      if (error(ec, Err) || error(I->getFlags(Flags), Err))
+        return true;
+      if (!(Flags & SymbolRef::SF_Global) || (Flags & SymbolRef::SF_Undefined))
+        continue;
+      if (error(I->getName(Name), Err))
+        return true;
+      if (Flags & SymbolRef::SF_Common) {
+        // Common symbols are zeroed space after everything else.
+        uint64_t Size;
+        uint32_t Align;
+        if (error(I->getSize(Size), Err) || error(I->getAlignment(Align), Err))
+          return true;
+        Addr = RoundUpToAlignment(Addr, std::max<uint32_t>(Align, 1));
+        if (Addr + Size > LC3bSimulator::MemorySize) {
+          Err = "common symbols do not fit in memory";
+          return true;
+        }
+        SymAddr = Addr;
+        Addr += Size;
+      } else if (getSymbolAddress(*I, SymAddr, Err))
+        return true;
+      if (Globals.count(Name)) {
+        Err = "duplicate symbol '" + Name.str() + "'";
+        return true;
+      }
+      Globals[Name] = SymAddr;
+    }
+
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i)
+    for (section_iterator I = Objects[i]->begin_sections(),
+           E = Objects[i]->end_sections(); I != E; I.increment(ec)) {
+      if (error(ec, Err))
+        return true;
+      DenseMap<uintptr_t, uint16_t>::iterator SI =
+        SectionAddrs.find(I->getRawDataRefImpl().p);
+      if (SI == SectionAddrs.end())
+        continue;
+      for (relocation_iterator RI = I->begin_relocations(),
+             RE = I->end_relocations(); RI != RE; RI.increment(ec))
+        if (error(ec, Err) || applyRelocation(*RI, SI->second, Err))
+          return true;
+    }
+  return false;
+}
+
+static const char *getStopReasonString(LC3bSimulator::StopReason R) {
+  switch (R) {
+  case LC3bSimulator::Running:       return "running";
+  case LC3bSimulator::Halted:        return "halted";
+  case LC3bSimulator::ReachedPCZero: return "reached x0000";
+  case LC3bSimulator::StepLimit:     return "step limit reached";
+  case LC3bSimulator::IllegalOpcode: return "illegal opcode";
+  }
+  return "unknown";
+}
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  sys::PrintStackTraceOnErrorSignal();
+  PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y;  // Call llvm_shutdown() on exit.
+  cl::ParseCommandLineOptions(argc, argv, "LC3b cycle counting simulator\n");
+
+  // Charge the latencies of the LC3b itineraries, as llc schedules with.
+  LLVMInitializeLC3bTargetInfo();
+  LLVMInitializeLC3bTargetMC();
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget("lc3b", Error);
+  if (!TheTarget) {
+    errs() << argv[0] << ": " << Error << '\n';
+    return 1;
+  }
+  OwningPtr<MCInstrInfo> MII(TheTarget->createMCInstrInfo());
+  OwningPtr<MCSubtargetInfo> STI(
+    TheTarget->createMCSubtargetInfo("lc3b", "LC3b", ""));
+  LC3bSimulator Sim(LC3bCycleModel(*MII,
+                                   STI->getInstrItineraryForCPU("LC3b")));
+  ELFLoader Loader(Sim);
+  uint16_t Entry = 0;
+  for (unsigned i = 0, e = InputFilenames.size(); i != e; ++i) {
+    OwningPtr<MemoryBuffer> Buffer;
+    if (error_code ec = MemoryBuffer::getFileOrSTDIN(InputFilenames[i],
+                                                     Buffer)) {
+      errs() << argv[0] << ": " << InputFilenames[i] << ": " << ec.message()
+             << '\n';
+      return 1;
+    }
+    std::string Err;
+    if (sys::fs::identify_magic(Buffer->getBuffer()) ==
+        sys::fs::file_magic::elf_relocatable) {
+      if (Loader.addObject(Buffer.take(), Err)) {
+        errs() << argv[0] << ": " << InputFilenames[i] << ": " << Err << '\n';
+        return 1;
+      }
+      continue;
+    }
+    if (Sim.loadObject(Buffer->getBuffer(), Err)) {
+      errs() << argv[0] << ": " << InputFilenames[i] << ": " << Err << '\n';
+      return 1;
+    }
+    // Execution starts at the first object's origin, like the course
+    // simulator.
+    if (i == 0)
+      Entry = Sim.getPC();
+  }
+
+  if (!Loader.empty()) {
+    std::string Err;
+    uint16_t Base;
+    if (parseAddress(Origin, Base)) {
+      errs() << argv[0] << ": invalid origin '" << Origin << "'\n";
+      return 1;
+    }
+    if (Loader.link(Base, Err)) {
+      errs() << argv[0] << ": " << Err << '\n';
+      return 1;
+    }
+    // main returns through R7, which is zero, so the run stops at x0000. R6
+    // starts at x0000 too, so the stack grows down from the top of memory.
+    if (EntryPoint.empty() && !Loader.lookup("main", Entry)) {
+      errs() << argv[0] << ": no main, use -entry\n";
+      return 1;
+    }
+    // The startup code would load R5 with _SDA_BASE_.
+    if (Loader.hasSmallData())
+      Sim.setReg(5, Loader.getSDABase());
+  }
+
+  if (!EntryPoint.empty() && parseAddress(EntryPoint, Entry)) {
+    errs() << argv[0] << ": invalid entry address '" << EntryPoint << "'\n";
+    return 1;
+  }
+  Sim.setPC(Entry);
+
+  LC3bSimulator::StopReason R = Sim.run(MaxSteps);
+  outs() << "Stopped: " << getStopReasonString(R) << '\n';
+  Sim.getStats().print(outs());
+  if (PrintRegisters) {
+    outs() << '\n';
+    Sim.printRegisters(outs());
+  }
+
+  return R == LC3bSimulator::IllegalOpcode ? 1 : 0;
+}